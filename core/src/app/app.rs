@@ -1,10 +1,15 @@
 use crate::{
     Buffer, Change, ChangeSet, CloseTabOperationType, ClosedTabInfo, Config, ConfigManager,
-    Document, DocumentError, DocumentId, DocumentManager, DocumentResult, Editor, FileSystemResult,
-    FileTree, JumpHistory, MoveActiveTabResult, OpenTabResult, Tab, TabError, TabId, TabManager,
-    View, ViewId, ViewManager,
+    Document, DocumentError, DocumentId, DocumentLoadStatus, DocumentLoadUpdate, DocumentManager,
+    DocumentReload, DocumentResult, DocumentSaveUpdate, Editor, FileSystemResult, FileTree,
+    JumpHistory, MemoryUsage, MoveActiveTabResult, OpenTabResult, SavePoint, Selection,
+    SessionSnapshot, SessionStore, SessionTab, Tab, TabError, TabEvent, TabId, TabManager, View,
+    ViewError, ViewId, ViewManager,
+};
+use std::{
+    collections::{HashMap, HashSet},
+    path::Path,
 };
-use std::path::Path;
 
 // TODO(scarlet): Make new tab + open file atomic? Or at least provide an atomic fn version
 // TODO(scarlet): Add error types
@@ -19,6 +24,14 @@ pub struct AppState {
     tab_manager: TabManager,
     document_manager: DocumentManager,
     view_manager: ViewManager,
+    /// The view and save point each in-flight background save was started from.
+    pending_save_points: HashMap<DocumentId, (ViewId, SavePoint)>,
+    /// Tab changes not yet picked up by [`Self::take_tab_events`].
+    tab_events: Vec<TabEvent>,
+    /// The active tab as of the last [`Self::take_tab_events`] call.
+    reported_active_tab: Option<TabId>,
+    /// Where the workspace is saved to, and restored from at startup.
+    session_store: SessionStore,
     pub jump_history: JumpHistory,
 }
 
@@ -47,6 +60,10 @@ impl AppState {
             tab_manager,
             document_manager,
             view_manager,
+            pending_save_points: HashMap::new(),
+            tab_events: Vec::new(),
+            reported_active_tab: None,
+            session_store: SessionStore::default(),
             jump_history: JumpHistory::default(),
         })
     }
@@ -64,6 +81,56 @@ impl AppState {
         self.tab_manager.get_active_tab_id()
     }
 
+    pub fn get_tab_index(&self, id: TabId) -> Option<usize> {
+        self.tab_manager.get_tab_index(id)
+    }
+
+    pub fn find_tab_by_document(&self, document_id: DocumentId) -> Option<TabId> {
+        self.tab_manager.find_tab_by_document(document_id)
+    }
+
+    /// Returns the tab changes since the last call. Any number of active tab switches in between
+    /// are reported as a single [`TabEvent::ActiveChanged`] for the tab that is active now.
+    pub fn take_tab_events(&mut self) -> Vec<TabEvent> {
+        let mut events = std::mem::take(&mut self.tab_events);
+        let active_tab =
+            (!self.tab_manager.get_tabs().is_empty()).then(|| self.tab_manager.get_active_tab_id());
+
+        if active_tab != self.reported_active_tab {
+            self.reported_active_tab = active_tab;
+
+            if let Some(id) = active_tab {
+                events.push(TabEvent::ActiveChanged(id));
+            }
+        }
+
+        events
+    }
+
+    /// Queues events for the tab showing `document_id` if its modified flag changed from
+    /// `was_modified`, or if the document was `renamed`.
+    fn record_tab_changes(&mut self, document_id: DocumentId, was_modified: bool, renamed: bool) {
+        let Some(id) = self.tab_manager.find_tab_by_document(document_id) else {
+            return;
+        };
+
+        let modified = self.is_document_modified(document_id);
+        if modified != was_modified {
+            self.tab_events
+                .push(TabEvent::ModifiedChanged { id, modified });
+        }
+
+        if renamed {
+            self.tab_events.push(TabEvent::TitleChanged(id));
+        }
+    }
+
+    fn is_document_modified(&self, document_id: DocumentId) -> bool {
+        self.document_manager
+            .get_document(document_id)
+            .is_some_and(|document| document.modified)
+    }
+
     pub fn get_close_tab_ids(
         &self,
         operation_type: CloseTabOperationType,
@@ -85,13 +152,9 @@ impl AppState {
     }
 
     fn is_tab_modified(&self, tab_id: TabId) -> bool {
-        if let Ok(tab) = self.tab_manager.get_tab(tab_id) {
-            if let Some(document) = self.document_manager.get_document(tab.get_document_id()) {
-                return document.modified;
-            }
-        }
-
-        false
+        self.tab_manager
+            .get_tab(tab_id)
+            .is_ok_and(|tab| self.is_document_modified(tab.get_document_id()))
     }
 
     pub fn get_config_snapshot(&self) -> Config {
@@ -120,7 +183,20 @@ impl AppState {
 
     pub fn set_active_view_id(&mut self, id: ViewId) {
         // TODO(scarlet) handle errors
-        _ = self.view_manager.set_active_view(id);
+        _ = self.activate_view(id);
+    }
+
+    /// Makes `view_id` the active view, and starts loading its document if it is still a stub.
+    fn activate_view(&mut self, view_id: ViewId) -> Result<(), ViewError> {
+        self.view_manager.set_active_view(view_id)?;
+
+        if let Some(view) = self.view_manager.get_view(view_id) {
+            if let Err(error) = self.document_manager.hydrate(view.document_id()) {
+                eprintln!("Failed to load document: {error}");
+            }
+        }
+
+        Ok(())
     }
 
     /// Helper to get the active view and its document.
@@ -271,6 +347,7 @@ impl AppState {
             // Only close the document if no other views are pointing to it.
             if !self.view_manager.has_views_for_document(document_id) {
                 self.document_manager.close_document(document_id);
+                self.pending_save_points.remove(&document_id);
             }
         }
 
@@ -280,7 +357,7 @@ impl AppState {
             // Sync the active view.
             if let Ok(tab) = self.tab_manager.get_tab(active_tab_id) {
                 // TODO(scarlet) handle errors
-                _ = self.view_manager.set_active_view(tab.get_view_id());
+                _ = self.activate_view(tab.get_view_id());
             }
         } else {
             self.view_manager.clear_active_view();
@@ -300,13 +377,404 @@ impl AppState {
         // Open (or reuse) the document for the given path
         let document_id = self.document_manager.open_document(path)?;
 
+        self.ensure_tab_for_document(document_id, add_to_history)
+    }
+
+    /// Like [`Self::ensure_tab_for_path`], but the file is read on a worker thread. The tab is
+    /// created right away for a document that is still loading; call
+    /// [`Self::poll_document_loads`] to pick up its content.
+    pub fn ensure_tab_for_path_in_background(
+        &mut self,
+        path: &Path,
+        add_to_history: bool,
+    ) -> Result<OpenTabResult, DocumentError> {
+        let document_id = self.document_manager.open_document_in_background(path)?;
+
+        self.ensure_tab_for_document(document_id, add_to_history)
+    }
+
+    /// Like [`Self::ensure_tab_for_path`], but the file is not read at all yet. The tab is
+    /// backed by a stub document, which is loaded in the background once its tab is activated
+    /// or prefetched (see [`Self::prefetch_documents`]).
+    pub fn ensure_tab_for_path_deferred(
+        &mut self,
+        path: &Path,
+        add_to_history: bool,
+    ) -> Result<OpenTabResult, DocumentError> {
+        let document_id = self.document_manager.open_document_deferred(path)?;
+
+        self.ensure_tab_for_document(document_id, add_to_history)
+    }
+
+    /// Starts loading the stub documents among the `limit` tabs most recently activated (or
+    /// opened), which are the ones the user is most likely to switch to next. Returns how many
+    /// loads were started.
+    pub fn prefetch_documents(&mut self, limit: usize) -> usize {
+        let history = self.tab_manager.get_history_manager();
+        let mut seen = HashSet::new();
+        let document_ids: Vec<_> = (0..history.history_len())
+            .rev()
+            .map(|idx| history.id_at(idx))
+            .filter(|&tab_id| seen.insert(tab_id))
+            .filter_map(|tab_id| self.tab_manager.get_tab(tab_id).ok())
+            .map(|tab| tab.get_document_id())
+            // Tabs that are already loaded don't use up the limit.
+            .filter(|&document_id| {
+                self.document_manager
+                    .get_document(document_id)
+                    .is_some_and(Document::is_stub)
+            })
+            .take(limit)
+            .collect();
+
+        let mut started = 0;
+        for document_id in document_ids {
+            match self.document_manager.hydrate(document_id) {
+                Ok(true) => started += 1,
+                Ok(false) => {}
+                Err(error) => eprintln!("Failed to prefetch document: {error}"),
+            }
+        }
+
+        started
+    }
+
+    /// Moves finished (or partially read) background loads into their documents and resets the
+    /// editors showing them.
+    pub fn poll_document_loads(&mut self) -> Vec<DocumentLoadUpdate> {
+        let updates = self.document_manager.poll_loads();
+
+        for update in &updates {
+            if update.status == DocumentLoadStatus::Loading {
+                continue;
+            }
+
+            // Views of a document brought back unchanged after eviction still match it.
+            if update.reload == Some(DocumentReload::Unchanged) {
+                continue;
+            }
+
+            let Some(document) = self.document_manager.get_document(update.document_id) else {
+                continue;
+            };
+            let line_count = document.buffer.line_count();
+            let content_replaced = update.status != DocumentLoadStatus::Preview
+                && update.reload == Some(DocumentReload::Changed);
+
+            for view in self.view_manager.views_for_document_mut(update.document_id) {
+                if content_replaced {
+                    // The cursors and undo history were for the content from before eviction.
+                    *view.editor_mut() = Editor::with_line_count(line_count);
+                } else {
+                    view.editor_mut().reset_line_widths(line_count);
+                }
+            }
+        }
+
+        updates
+    }
+
+    /// Memory held by loaded documents and the undo histories of their views, along with the
+    /// configured budget.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        let histories: usize = self
+            .view_manager
+            .views()
+            .map(|view| view.editor().history_size())
+            .sum();
+
+        MemoryUsage {
+            used: self.document_manager.buffer_memory() + histories,
+            budget: self.document_manager.memory_budget(),
+        }
+    }
+
+    /// Brings memory usage back within the configured budget, if it is over. Undo histories of
+    /// the views not on screen are compacted first. If that is not enough, unmodified documents
+    /// are evicted, least recently shown first, to be reloaded when next activated.
+    ///
+    /// Without a budget nothing is measured, and the usage is reported as zero.
+    pub fn enforce_memory_budget(&mut self) -> MemoryUsage {
+        let budget_mb = self.get_config_snapshot().editor.memory_budget_mb;
+        self.document_manager
+            .set_memory_budget((budget_mb > 0).then(|| budget_mb.saturating_mul(1024 * 1024)));
+
+        let Some(budget) = self.document_manager.memory_budget() else {
+            return MemoryUsage::default();
+        };
+
+        let usage = self.memory_usage();
+        if usage.used <= budget {
+            return usage;
+        }
+
+        let active_view_id = self.view_manager.active_view();
+
+        // Views with a save in flight are left alone, since the save point refers to their edits
+        // as recorded.
+        for view in self.view_manager.views_mut() {
+            if Some(view.id()) != active_view_id
+                && !self.pending_save_points.contains_key(&view.document_id())
+            {
+                view.editor_mut().compact_history();
+            }
+        }
+
+        let mut usage = self.memory_usage();
+        if usage.used <= budget {
+            return usage;
+        }
+
+        let active_document_id = active_view_id
+            .and_then(|view_id| self.view_manager.get_view(view_id))
+            .map(View::document_id);
+
+        let history = self.tab_manager.get_history_manager();
+        let last_shown: HashMap<TabId, usize> = (0..history.history_len())
+            .map(|idx| (history.id_at(idx), idx))
+            .collect();
+
+        // Tabs that were never shown sort first, then the rest from least recently shown.
+        let mut candidates: Vec<_> = self
+            .tab_manager
+            .get_tabs()
+            .iter()
+            .filter(|tab| Some(tab.get_document_id()) != active_document_id)
+            .map(|tab| {
+                (
+                    last_shown.get(&tab.get_id()).copied(),
+                    tab.get_document_id(),
+                )
+            })
+            .collect();
+        candidates.sort_by_key(|&(last_shown, _)| last_shown);
+
+        for (_, document_id) in candidates {
+            if usage.used <= budget {
+                break;
+            }
+
+            if let Some(freed) = self.document_manager.evict(document_id) {
+                usage.used = usage.used.saturating_sub(freed);
+            }
+        }
+
+        usage
+    }
+
+    /// Captures the open tabs, the closed tabs history can still reopen, and the history itself.
+    /// Tabs without a file are left out.
+    pub fn session_snapshot(&self) -> SessionSnapshot {
+        let mut snapshot = SessionSnapshot::default();
+        let mut entries = HashMap::new();
+
+        for tab in self.tab_manager.get_tabs() {
+            let Some(document) = self.document_manager.get_document(tab.get_document_id()) else {
+                continue;
+            };
+            let (Some(path), Some(view)) = (
+                &document.path,
+                self.view_manager.get_view(tab.get_view_id()),
+            ) else {
+                continue;
+            };
+
+            // Unsaved edits are not part of the session, so the cursors of a modified document
+            // would not match its file, and it is marked to be reloaded as changed. Otherwise they
+            // refer to the content `saved_hash` is the checksum of, also while the document is
+            // not loaded.
+            let (cursors, selection) = if document.modified {
+                (Vec::new(), Selection::new())
+            } else {
+                let editor = view.editor();
+                (editor.cursors().to_vec(), editor.selection().clone())
+            };
+
+            entries.insert(tab.get_id(), snapshot.tabs.len());
+            snapshot.tabs.push(SessionTab {
+                path: path.clone(),
+                is_pinned: tab.get_is_pinned(),
+                scroll_offsets: tab.get_scroll_offsets(),
+                cursors,
+                selection,
+                checksum: document.saved_hash,
+                line_count: document.line_count(),
+                modified: document.modified,
+            });
+        }
+
+        snapshot.active_tab = entries.get(&self.tab_manager.get_active_tab_id()).copied();
+
+        let history = self.tab_manager.get_history_manager().ids();
+        let in_history: HashSet<TabId> = history.iter().copied().collect();
+
+        // Closed tabs can only be reopened from history, so the others are not worth keeping.
+        let mut closed_tabs: Vec<_> = self
+            .tab_manager
+            .closed_tabs()
+            .filter(|(id, _)| in_history.contains(id))
+            .collect();
+        closed_tabs.sort_by_key(|&(id, _)| u64::from(id));
+
+        for (id, info) in closed_tabs {
+            entries.insert(id, snapshot.tabs.len() + snapshot.closed_tabs.len());
+            snapshot.closed_tabs.push(info.clone());
+        }
+
+        snapshot.history = history
+            .iter()
+            .filter_map(|id| entries.get(id).copied())
+            .collect();
+        snapshot.history.dedup();
+
+        snapshot
+    }
+
+    /// Reopens the tabs of a saved session without reading any of their files. Each tab comes
+    /// back with the viewport and cursors it was saved with, and is loaded in the background once
+    /// shown or prefetched; the active one right away. Tabs whose file is gone are skipped.
+    ///
+    /// If anything was restored, the empty tab the app starts with is closed. Returns whether
+    /// anything was restored and shown.
+    pub fn restore_session(&mut self, snapshot: SessionSnapshot) -> bool {
+        // The untitled tab created at startup, unless it was used since.
+        let startup_tab = match self.tab_manager.get_tabs().as_slice() {
+            [tab] => self
+                .document_manager
+                .get_document(tab.get_document_id())
+                .filter(|document| {
+                    document.path.is_none() && !document.modified && document.buffer.is_empty()
+                })
+                .map(|_| (tab.get_id(), tab.get_view_id(), tab.get_document_id())),
+            _ => None,
+        };
+
+        // The tab id of every entry history can refer to, if it was restored.
+        let mut entries = Vec::with_capacity(snapshot.tabs.len() + snapshot.closed_tabs.len());
+
+        for tab in snapshot.tabs {
+            let document_id = match self.document_manager.restore_document(
+                &tab.path,
+                tab.checksum,
+                tab.line_count,
+                tab.modified,
+            ) {
+                Ok(document_id) => document_id,
+                Err(error) => {
+                    eprintln!("Failed to restore {}: {error}", tab.path.display());
+                    entries.push(None);
+                    continue;
+                }
+            };
+
+            // The same file listed twice.
+            if let Some(tab_id) = self.tab_manager.find_tab_by_document(document_id) {
+                entries.push(Some(tab_id));
+                continue;
+            }
+
+            // Sized to the saved line count, so the view can be laid out and scrolled before the
+            // file is read.
+            let mut editor = Editor::with_line_count(tab.line_count);
+            editor.cursor_manager_mut().set_cursors(tab.cursors);
+            editor.selection_manager_mut().set_selection(&tab.selection);
+
+            let view_id = self.view_manager.create_view(document_id, editor);
+            let tab_id = self
+                .tab_manager
+                .add_tab_for_document(document_id, view_id, false);
+
+            if tab.is_pinned {
+                _ = self.tab_manager.pin_tab(tab_id);
+            }
+            _ = self
+                .tab_manager
+                .set_tab_scroll_offsets(tab_id, tab.scroll_offsets);
+
+            entries.push(Some(tab_id));
+        }
+
+        let Some(active_tab_id) = snapshot
+            .active_tab
+            .and_then(|idx| entries.get(idx).copied().flatten())
+            .or_else(|| entries.iter().flatten().last().copied())
+        else {
+            return false;
+        };
+
+        if let Some((tab_id, view_id, document_id)) = startup_tab {
+            _ = self.tab_manager.close_tabs(vec![(tab_id, None)], false);
+            self.view_manager.remove_view(view_id);
+            self.document_manager.close_document(document_id);
+        }
+
+        for info in snapshot.closed_tabs {
+            entries.push(Some(self.tab_manager.restore_closed_tab(info)));
+        }
+
+        let mut history: Vec<TabId> = snapshot
+            .history
+            .iter()
+            .filter_map(|&idx| entries.get(idx).copied().flatten())
+            .collect();
+        history.dedup();
+        if history.last() != Some(&active_tab_id) {
+            history.push(active_tab_id);
+        }
+        self.tab_manager.get_history_manager_mut().replace(history);
+
+        // Should the tab to show have gone missing, show any other restored one instead.
+        std::iter::once(active_tab_id)
+            .chain(entries.iter().flatten().copied())
+            .any(|tab_id| match self.set_active_tab(tab_id) {
+                Ok(()) => true,
+                Err(error) => {
+                    eprintln!("Failed to show a restored tab: {error}");
+                    false
+                }
+            })
+    }
+
+    /// Restores the session last saved (see [`Self::restore_session`]), if there is one.
+    pub fn load_session(&mut self) -> bool {
+        match self.session_store.load() {
+            Ok(Some(snapshot)) => self.restore_session(snapshot),
+            Ok(None) => false,
+            Err(error) => {
+                eprintln!("Failed to read the saved session: {error}");
+                false
+            }
+        }
+    }
+
+    /// Saves the session on a worker thread if it changed since it was last saved. Cheap enough
+    /// to call on a timer. Returns whether a save was started.
+    pub fn save_session_in_background(&mut self) -> bool {
+        let snapshot = self.session_snapshot();
+        self.session_store.save_in_background(&snapshot)
+    }
+
+    /// Saves the session before returning, e.g. when the app is about to quit.
+    pub fn save_session(&mut self) {
+        let snapshot = self.session_snapshot();
+
+        if let Err(error) = self.session_store.save(&snapshot) {
+            eprintln!("Failed to save the session: {error}");
+        }
+    }
+
+    fn ensure_tab_for_document(
+        &mut self,
+        document_id: DocumentId,
+        add_to_history: bool,
+    ) -> Result<OpenTabResult, DocumentError> {
         // Try to find an existing tab for the document
         if let Some(tab_id) = self.tab_manager.find_tab_by_document(document_id) {
             let existing_view_id = self.tab_manager.get_tab(tab_id).map(|t| t.get_view_id());
 
             if let Ok(view_id) = existing_view_id {
                 // Try to set the active view
-                if self.view_manager.set_active_view(view_id).is_ok() {
+                if self.activate_view(view_id).is_ok() {
                     return Ok(OpenTabResult {
                         tab_id: Some(tab_id),
                         tab_already_exists: true,
@@ -315,7 +783,7 @@ impl AppState {
 
                 eprintln!("Adding missing view for tab {tab_id}");
 
-                let editor = Editor::default();
+                let editor = self.editor_for_document(document_id);
                 let new_view_id = self.view_manager.create_view(document_id, editor);
 
                 self.tab_manager
@@ -325,7 +793,7 @@ impl AppState {
                         DocumentError::NotFound(u64::from(tab_id).into())
                     })?;
 
-                let _ = self.view_manager.set_active_view(new_view_id);
+                let _ = self.activate_view(new_view_id);
 
                 return Ok(OpenTabResult {
                     tab_id: Some(tab_id),
@@ -335,7 +803,7 @@ impl AppState {
         }
 
         // Otherwise, create a new tab/view/editor
-        let editor = Editor::default();
+        let editor = self.editor_for_document(document_id);
         let view_id = self.view_manager.create_view(document_id, editor);
         let tab_id = self
             .tab_manager
@@ -414,7 +882,7 @@ impl AppState {
         // Sync the active view.
         if let Some(found_id) = result.found_id {
             if let Ok(tab) = self.tab_manager.get_tab(found_id) {
-                _ = self.view_manager.set_active_view(tab.get_view_id());
+                _ = self.activate_view(tab.get_view_id());
             }
         }
 
@@ -441,7 +909,7 @@ impl AppState {
         self.tab_manager.set_active_tab(id)?;
         let view_id = self.tab_manager.get_tab(id)?.get_view_id();
         // TODO(scarlet): Handle errors
-        _ = self.view_manager.set_active_view(view_id);
+        _ = self.activate_view(view_id);
 
         Ok(())
     }
@@ -458,23 +926,37 @@ impl AppState {
         let view = self.view_manager.get_view_mut(view_id)?;
         let document_id = view.document_id();
         let document = self.document_manager.get_document_mut(document_id)?;
+
+        // The buffer is replaced when the load finishes, so anything done to it before then
+        // (or before a stub starts loading) would be lost.
+        if document.loading || document.is_stub() {
+            return Some(ChangeSet::default());
+        }
+
         let change_set = action(view.editor_mut(), &mut document.buffer);
 
-        // Update document modified status
+        // Update document modified status. This is tracked per edit, so it never has to hash the
+        // whole buffer.
         if change_set.change.contains(Change::BUFFER) {
-            let current_revision = view.editor().revision();
+            let was_modified = document.modified;
+            document.modified = view.editor().has_unsaved_edits();
 
-            if current_revision == document.saved_revision {
-                document.modified = false;
-            } else {
-                let current_hash = document.buffer.checksum();
-                document.modified = current_hash != document.saved_hash;
+            if document.modified != was_modified {
+                self.record_tab_changes(document_id, was_modified, false);
             }
         }
 
         Some(change_set)
     }
 
+    /// Creates an editor sized to the line count of an already loaded document.
+    fn editor_for_document(&self, document_id: DocumentId) -> Editor {
+        self.document_manager
+            .get_document(document_id)
+            .map(|document| Editor::with_line_count(document.buffer.line_count()))
+            .unwrap_or_default()
+    }
+
     fn create_document_tab_and_view_impl(
         document_manager: &mut DocumentManager,
         tab_manager: &mut TabManager,
@@ -519,7 +1001,7 @@ impl AppState {
 
     pub fn open_document(&mut self, path: &Path) -> DocumentResult<DocumentId> {
         let new_document_id = self.document_manager.open_document(path)?;
-        let editor = Editor::default();
+        let editor = self.editor_for_document(new_document_id);
         let view_id = self.view_manager.create_view(new_document_id, editor);
 
         self.tab_manager
@@ -556,9 +1038,93 @@ impl AppState {
             (document_id, current_revision)
         };
 
+        let was_modified = self.is_document_modified(document_id);
         self.document_manager
             .save_document(document_id, current_revision)?;
+        self.mark_view_saved(view_id);
+        self.record_tab_changes(document_id, was_modified, false);
+        self.reload_config_if_saved(document_id);
+
+        Ok(())
+    }
+
+    /// Starts saving the view's document on a worker thread, under `path` if one is given. The
+    /// outcome is picked up by [`Self::poll_document_saves`].
+    pub fn begin_save_document(
+        &mut self,
+        view_id: ViewId,
+        path: Option<&Path>,
+    ) -> DocumentResult<()> {
+        if path.is_some_and(|path| path.as_os_str().is_empty()) {
+            return Err(std::io::Error::new(
+                std::io::ErrorKind::InvalidInput,
+                "Path cannot be empty",
+            )
+            .into());
+        }
+
+        let (document_id, current_revision, save_point) = {
+            let view = self
+                .view_manager
+                .get_view(view_id)
+                .ok_or(DocumentError::ViewNotFound)?;
+            let editor = view.editor();
+
+            (view.document_id(), editor.revision(), editor.save_point())
+        };
+
+        self.document_manager
+            .begin_save(document_id, path, current_revision)?;
+        self.pending_save_points
+            .insert(document_id, (view_id, save_point));
+
+        Ok(())
+    }
+
+    /// Applies background saves that have finished. The saving view's save point moves to the
+    /// content that was written, so edits made while the save ran keep the document modified.
+    pub fn poll_document_saves(&mut self) -> Vec<DocumentSaveUpdate> {
+        let updates = self.document_manager.poll_saves();
+
+        for update in &updates {
+            let Some((view_id, save_point)) = self.pending_save_points.remove(&update.document_id)
+            else {
+                continue;
+            };
+
+            if !update.succeeded {
+                continue;
+            }
+
+            let was_modified = self.is_document_modified(update.document_id);
+            if let Some(view) = self.view_manager.get_view_mut(view_id) {
+                view.editor_mut().mark_saved_at(save_point);
+                let modified = view.editor().has_unsaved_edits();
+
+                if let Some(document) = self.document_manager.get_document_mut(update.document_id) {
+                    document.modified = modified;
+                }
+            }
 
+            self.record_tab_changes(update.document_id, was_modified, update.renamed);
+            self.reload_config_if_saved(update.document_id);
+        }
+
+        updates
+    }
+
+    /// Flags documents whose files were changed outside the editor. Returns the documents whose
+    /// flag changed (see [`DocumentManager::poll_disk_changes`]).
+    pub fn poll_document_disk_changes(&mut self) -> Vec<DocumentId> {
+        self.document_manager.poll_disk_changes()
+    }
+
+    /// Whether any document is still being loaded or saved in the background.
+    pub fn has_pending_document_io(&self) -> bool {
+        self.document_manager.has_pending_loads() || self.document_manager.has_pending_saves()
+    }
+
+    fn reload_config_if_saved(&self, document_id: DocumentId) {
         if let Some(document) = self.document_manager.get_document(document_id) {
             if let Some(path) = &document.path {
                 // Refresh config if tab with config path was saved in the editor
@@ -571,8 +1137,6 @@ impl AppState {
                 }
             }
         }
-
-        Ok(())
     }
 
     pub fn save_document_as(&mut self, view_id: ViewId, path: &Path) -> DocumentResult<()> {
@@ -593,12 +1157,21 @@ impl AppState {
             (view.document_id(), view.editor().revision())
         };
 
+        let was_modified = self.is_document_modified(document_id);
         self.document_manager
             .save_document_as(document_id, path, current_revision)?;
+        self.mark_view_saved(view_id);
+        self.record_tab_changes(document_id, was_modified, true);
 
         Ok(())
     }
 
+    fn mark_view_saved(&mut self, view_id: ViewId) {
+        if let Some(view) = self.view_manager.get_view_mut(view_id) {
+            view.editor_mut().mark_saved();
+        }
+    }
+
     pub fn get_file_tree(&self) -> &FileTree {
         &self.file_tree
     }
@@ -628,7 +1201,372 @@ impl AppState {
 
 #[cfg(test)]
 mod test {
-    // use super::*;
+    use super::*;
+    use crate::test_utils::TempDir;
+    use std::{fs, path::PathBuf, sync::LazyLock, thread, time::Duration};
+
+    /// Creates an app showing only its startup tab. The config is shared by every test, since the
+    /// app keeps a pointer to it.
+    fn new_app() -> AppState {
+        static CONFIG: LazyLock<ConfigManager> =
+            LazyLock::new(|| ConfigManager::in_memory(Config::default()));
+        AppState::new(&CONFIG, None).unwrap()
+    }
+
+    /// Like [`new_app`], with a memory budget of 1 MB.
+    fn new_app_with_small_budget() -> AppState {
+        static CONFIG: LazyLock<ConfigManager> = LazyLock::new(|| {
+            let mut config = Config::default();
+            config.editor.memory_budget_mb = 1;
+            ConfigManager::in_memory(config)
+        });
+        AppState::new(&CONFIG, None).unwrap()
+    }
+
+    /// Writes a file taking up most of a 1 MB budget, so any two loaded ones exceed it.
+    fn write_large_file(path: &Path, line: &str) {
+        fs::write(
+            path,
+            format!("{line}\n").repeat(700 * 1024 / (line.len() + 1)),
+        )
+        .unwrap();
+    }
+
+    fn open_tab(app: &mut AppState, path: &Path) -> (TabId, ViewId) {
+        let tab_id = app.ensure_tab_for_path(path, true).unwrap().tab_id.unwrap();
+        (tab_id, app.get_tab(tab_id).unwrap().get_view_id())
+    }
+
+    fn editor_of(app: &AppState, tab_id: TabId) -> &Editor {
+        let view_id = app.get_tab(tab_id).unwrap().get_view_id();
+        app.get_view_manager().get_view(view_id).unwrap().editor()
+    }
+
+    /// Opens `path` with an edit that was saved and the cursor moved to row 3, then shows another
+    /// tab and evicts it.
+    fn open_and_evict(app: &mut AppState, path: &Path, other: &Path) -> TabId {
+        let (tab_id, view_id) = open_tab(app, path);
+        app.apply_editor_action(view_id, |editor, buffer| editor.insert_text(buffer, "x"))
+            .unwrap();
+        app.save_document(view_id).unwrap();
+        app.apply_editor_action(view_id, |editor, buffer| editor.move_to(buffer, 3, 1, true))
+            .unwrap();
+
+        let (other_tab, _) = open_tab(app, other);
+        app.set_active_tab(other_tab).unwrap();
+        app.enforce_memory_budget();
+        assert!(document_of(app, tab_id).is_stub());
+
+        tab_id
+    }
+
+    /// Polls until every background load and save has finished.
+    fn finish_document_io(app: &mut AppState) {
+        while app.has_pending_document_io() {
+            app.poll_document_loads();
+            app.poll_document_saves();
+            thread::sleep(Duration::from_millis(1));
+        }
+    }
+
+    fn document_of(app: &AppState, tab_id: TabId) -> &Document {
+        let document_id = app.get_tab(tab_id).unwrap().get_document_id();
+        app.get_document_manager()
+            .get_document(document_id)
+            .unwrap()
+    }
+
+    fn document_id_of(app: &AppState, path: &Path) -> DocumentId {
+        app.get_document_manager()
+            .find_document_id_by_path(path)
+            .unwrap()
+    }
+
+    fn open_deferred(app: &mut AppState, path: &Path) -> TabId {
+        app.ensure_tab_for_path_deferred(path, true)
+            .unwrap()
+            .tab_id
+            .unwrap()
+    }
+
+    #[test]
+    fn activating_a_deferred_tab_loads_only_its_document() {
+        let directory = TempDir::new("app_deferred_activate");
+        fs::write(directory.join("a.txt"), "a\n").unwrap();
+        fs::write(directory.join("b.txt"), "b\n").unwrap();
+
+        let mut app = new_app();
+        let a = open_deferred(&mut app, &directory.join("a.txt"));
+        let b = open_deferred(&mut app, &directory.join("b.txt"));
+        assert!(document_of(&app, a).is_stub());
+        assert!(document_of(&app, b).is_stub());
+
+        app.set_active_tab(a).unwrap();
+        assert!(!document_of(&app, a).is_stub());
+        assert!(document_of(&app, b).is_stub());
+
+        // Edits and saves of a stub are refused, rather than lost or written over the file.
+        let view_b = app.get_tab(b).unwrap().get_view_id();
+        let change_set = app
+            .apply_editor_action(view_b, |editor, buffer| editor.insert_text(buffer, "x"))
+            .unwrap();
+        assert!(change_set.change.is_empty());
+        assert!(!document_of(&app, b).modified);
+        assert!(matches!(
+            app.save_document(view_b),
+            Err(DocumentError::Loading(_))
+        ));
+        assert_eq!(fs::read_to_string(directory.join("b.txt")).unwrap(), "b\n");
+
+        finish_document_io(&mut app);
+        assert_eq!(document_of(&app, a).buffer.get_text(), "a\n");
+        assert!(document_of(&app, b).is_stub());
+    }
+
+    #[test]
+    fn prefetch_loads_the_most_recently_shown_stubs() {
+        let directory = TempDir::new("app_prefetch");
+        let mut app = new_app();
+        let tabs: Vec<TabId> = ["a", "b", "c", "d"]
+            .iter()
+            .map(|name| {
+                let path = directory.join(format!("{name}.txt"));
+                fs::write(&path, *name).unwrap();
+                open_deferred(&mut app, &path)
+            })
+            .collect();
+
+        // `a` is shown last, and already loaded by being shown.
+        app.set_active_tab(tabs[0]).unwrap();
+        finish_document_io(&mut app);
+
+        // Loaded tabs don't use up the limit: the next two most recent stubs are `d` and `c`.
+        assert_eq!(app.prefetch_documents(2), 2);
+        assert!(document_of(&app, tabs[1]).is_stub());
+        assert!(!document_of(&app, tabs[2]).is_stub());
+        assert!(!document_of(&app, tabs[3]).is_stub());
+
+        finish_document_io(&mut app);
+        assert_eq!(app.prefetch_documents(2), 1);
+        assert!(!document_of(&app, tabs[1]).is_stub());
+        assert_eq!(app.prefetch_documents(2), 0);
+    }
+
+    #[test]
+    fn budget_evicts_only_clean_background_documents() {
+        let directory = TempDir::new("app_evict");
+        let mut app = new_app_with_small_budget();
+        let [clean, modified, saving, active] =
+            ["clean", "modified", "saving", "active"].map(|name| {
+                let path = directory.join(format!("{name}.txt"));
+                write_large_file(&path, name);
+                open_tab(&mut app, &path)
+            });
+
+        app.apply_editor_action(modified.1, |editor, buffer| editor.insert_text(buffer, "x"))
+            .unwrap();
+        app.begin_save_document(saving.1, None).unwrap();
+        app.set_active_tab(active.0).unwrap();
+
+        let usage = app.enforce_memory_budget();
+        assert!(usage.used > usage.budget.unwrap());
+        assert!(document_of(&app, clean.0).is_stub());
+        assert!(!document_of(&app, modified.0).is_stub());
+        assert!(!document_of(&app, saving.0).is_stub());
+        assert!(!document_of(&app, active.0).is_stub());
+
+        finish_document_io(&mut app);
+    }
+
+    #[test]
+    fn unchanged_reload_keeps_cursors_and_history() {
+        let directory = TempDir::new("app_reload_unchanged");
+        let (path, other) = (directory.join("a.txt"), directory.join("b.txt"));
+        write_large_file(&path, "line");
+        write_large_file(&other, "other");
+
+        let mut app = new_app_with_small_budget();
+        let tab_id = open_and_evict(&mut app, &path, &other);
+        let revision = editor_of(&app, tab_id).revision();
+
+        app.set_active_tab(tab_id).unwrap();
+        finish_document_io(&mut app);
+
+        assert!(!document_of(&app, tab_id).is_stub());
+        assert!(
+            document_of(&app, tab_id)
+                .buffer
+                .get_text()
+                .starts_with("xline\n")
+        );
+        let editor = editor_of(&app, tab_id);
+        assert_eq!(editor.revision(), revision);
+        assert_eq!(editor.cursors()[0].cursor.row, 3);
+    }
+
+    #[test]
+    fn changed_reload_resets_the_editor() {
+        let directory = TempDir::new("app_reload_changed");
+        let (path, other) = (directory.join("a.txt"), directory.join("b.txt"));
+        write_large_file(&path, "line");
+        write_large_file(&other, "other");
+
+        let mut app = new_app_with_small_budget();
+        let tab_id = open_and_evict(&mut app, &path, &other);
+        fs::write(&path, "changed\n").unwrap();
+
+        app.set_active_tab(tab_id).unwrap();
+        finish_document_io(&mut app);
+
+        assert_eq!(document_of(&app, tab_id).buffer.get_text(), "changed\n");
+        let editor = editor_of(&app, tab_id);
+        assert_eq!(editor.revision(), 0);
+        assert_eq!(editor.cursors()[0].cursor.row, 0);
+    }
+
+    /// The path of every history entry, whether its tab is open or closed.
+    fn history_paths(app: &AppState) -> Vec<PathBuf> {
+        let closed: HashMap<TabId, &ClosedTabInfo> = app.tab_manager.closed_tabs().collect();
+
+        app.tab_manager
+            .get_history_manager()
+            .ids()
+            .iter()
+            .filter_map(|id| match app.get_tab(*id) {
+                Ok(tab) => document_of(app, tab.get_id()).path.clone(),
+                Err(_) => closed.get(id).map(|info| info.path.clone()),
+            })
+            .collect()
+    }
+
+    fn move_cursor(app: &mut AppState, tab_id: TabId, row: usize) {
+        let view_id = app.get_tab(tab_id).unwrap().get_view_id();
+        app.apply_editor_action(view_id, |editor, buffer| {
+            editor.move_to(buffer, row, 0, true)
+        })
+        .unwrap();
+    }
+
+    #[test]
+    fn restored_session_remaps_history_and_replaces_the_startup_tab() {
+        let directory = TempDir::new("app_session_history");
+        let mut app = new_app();
+        let [a, b, c] = ["a", "b", "c"].map(|name| {
+            let path = directory.join(format!("{name}.txt"));
+            fs::write(&path, name).unwrap();
+            open_tab(&mut app, &path).0
+        });
+        app.set_active_tab(a).unwrap();
+        app.set_active_tab(c).unwrap();
+        app.set_active_tab(b).unwrap();
+        app.close_tabs(CloseTabOperationType::Single, b, false)
+            .unwrap();
+        let active_path = document_of(&app, app.get_active_tab_id()).path.clone();
+
+        let snapshot = app.session_snapshot();
+        assert_eq!(snapshot.tabs.len(), 2);
+        assert_eq!(snapshot.closed_tabs.len(), 1);
+
+        let mut restored = new_app();
+        assert!(restored.restore_session(snapshot));
+
+        // Only the restored tabs are left, in their original order.
+        let paths: Vec<_> = restored
+            .get_tabs()
+            .iter()
+            .map(|tab| document_of(&restored, tab.get_id()).path.clone().unwrap())
+            .collect();
+        assert_eq!(paths, [directory.join("a.txt"), directory.join("c.txt")]);
+        assert_eq!(
+            document_of(&restored, restored.get_active_tab_id()).path,
+            active_path
+        );
+
+        // Closing `b` showed `c` without recording it, which restoring does.
+        let mut history = history_paths(&app);
+        history.extend(active_path);
+        assert_eq!(history_paths(&restored), history);
+
+        finish_document_io(&mut restored);
+    }
+
+    #[test]
+    fn restored_session_skips_missing_files_and_keeps_cursors_of_unchanged_ones() {
+        let directory = TempDir::new("app_session_cursors");
+        let mut app = new_app();
+        let [same, changed, missing] = ["same", "changed", "missing"].map(|name| {
+            let path = directory.join(format!("{name}.txt"));
+            fs::write(&path, "one\ntwo\nthree\nfour\n").unwrap();
+            let (tab_id, _) = open_tab(&mut app, &path);
+            move_cursor(&mut app, tab_id, 2);
+            path
+        });
+        app.set_active_tab(
+            app.find_tab_by_document(document_id_of(&app, &missing))
+                .unwrap(),
+        )
+        .unwrap();
+
+        let snapshot = app.session_snapshot();
+        fs::write(&changed, "one\ntwo\nthree\nchanged\n").unwrap();
+        fs::remove_file(&missing).unwrap();
+
+        let mut restored = new_app();
+        assert!(restored.restore_session(snapshot));
+        assert_eq!(restored.get_tabs().len(), 2);
+
+        // The active tab's file is gone, so the last restored tab is shown instead.
+        let changed_tab = restored.get_active_tab_id();
+        assert_eq!(
+            document_of(&restored, changed_tab).path.as_ref(),
+            Some(&changed)
+        );
+        let same_tab = restored
+            .find_tab_by_document(document_id_of(&restored, &same))
+            .unwrap();
+        restored.set_active_tab(same_tab).unwrap();
+        finish_document_io(&mut restored);
+
+        assert_eq!(editor_of(&restored, same_tab).cursors()[0].cursor.row, 2);
+        assert_eq!(editor_of(&restored, changed_tab).cursors()[0].cursor.row, 0);
+    }
+
+    #[test]
+    fn modified_documents_are_restored_as_changed() {
+        let directory = TempDir::new("app_session_modified");
+        let path = directory.join("a.txt");
+        fs::write(&path, "one\ntwo\n").unwrap();
+
+        let mut app = new_app();
+        let (tab_id, view_id) = open_tab(&mut app, &path);
+        move_cursor(&mut app, tab_id, 1);
+        app.apply_editor_action(view_id, |editor, buffer| editor.insert_text(buffer, "\n\n"))
+            .unwrap();
+
+        let snapshot = app.session_snapshot();
+        assert!(snapshot.tabs[0].modified);
+        assert!(snapshot.tabs[0].cursors.is_empty());
+        assert_eq!(
+            snapshot.tabs[0].checksum,
+            document_of(&app, tab_id).saved_hash
+        );
+
+        let mut restored = new_app();
+        assert!(restored.restore_session(snapshot));
+
+        let mut reloads = Vec::new();
+        while restored.has_pending_document_io() {
+            reloads.extend(
+                restored
+                    .poll_document_loads()
+                    .into_iter()
+                    .filter(|update| update.status == DocumentLoadStatus::Finished)
+                    .filter_map(|update| update.reload),
+            );
+            thread::sleep(Duration::from_millis(1));
+        }
+        assert_eq!(reloads, [DocumentReload::Changed]);
+    }
 
     // TODO(scarlet): Fix these (and add more)
     #[test]
@@ -1,11 +1,17 @@
 use std::{
-    fs::{self, ReadDir},
+    ffi::OsString,
+    fs::{self, File, ReadDir},
     io,
     path::{Path, PathBuf},
+    process,
+    sync::atomic::{AtomicU64, Ordering},
 };
 
 pub type FileResult<T> = io::Result<T>;
 
+/// Numbers the temporary files of [`FileIoManager::write_file_atomically`].
+static NEXT_TEMP_FILE: AtomicU64 = AtomicU64::new(0);
+
 /// Thin wrapper around [`std::fs`] IO operations.
 ///
 /// Centralizes file access so editor-level behavior (mocking, validation,
@@ -17,10 +23,74 @@ impl FileIoManager {
         fs::write(path, content)
     }
 
+    /// Replaces the file at `path` with whatever `write` puts into a fresh file, so that a crash or
+    /// a failed write leaves either the old or the new content on disk, never a truncated file.
+    ///
+    /// The content goes to a temporary file next to `path`, which is synced and then renamed over
+    /// it. The permissions of an existing file are carried over. Every call gets its own temporary
+    /// file, so concurrent writes to the same path never rename each other's partial content.
+    pub fn write_file_atomically<P: AsRef<Path>, T>(
+        path: P,
+        write: impl FnOnce(&mut File) -> FileResult<T>,
+    ) -> FileResult<T> {
+        let path = path.as_ref();
+        let file_name = path
+            .file_name()
+            .ok_or_else(|| io::Error::new(io::ErrorKind::InvalidInput, "Path has no file name"))?;
+
+        let mut temp_name = OsString::from(".");
+        temp_name.push(file_name);
+        temp_name.push(format!(
+            ".{}.{}.tmp",
+            process::id(),
+            NEXT_TEMP_FILE.fetch_add(1, Ordering::Relaxed)
+        ));
+        let temp_path = path.with_file_name(temp_name);
+
+        let result = (|| -> FileResult<T> {
+            let mut file = File::create_new(&temp_path)?;
+
+            if let Ok(metadata) = fs::metadata(path) {
+                file.set_permissions(metadata.permissions())?;
+            }
+
+            let value = write(&mut file)?;
+            file.sync_all()?;
+            fs::rename(&temp_path, path)?;
+
+            Ok(value)
+        })();
+
+        match result {
+            Ok(value) => {
+                Self::sync_parent_directory(path);
+                Ok(value)
+            }
+            Err(error) => {
+                _ = fs::remove_file(&temp_path);
+                Err(error)
+            }
+        }
+    }
+
+    /// Flushes a rename in `path`'s directory to disk. Best effort: the data itself is already
+    /// synced, and not every platform can open a directory.
+    fn sync_parent_directory(path: &Path) {
+        if let Some(parent) = path.parent() {
+            if let Ok(directory) = File::open(parent) {
+                _ = directory.sync_all();
+            }
+        }
+    }
+
     pub fn read_file<P: AsRef<Path>>(path: P) -> FileResult<String> {
         fs::read_to_string(path)
     }
 
+    pub fn open_file<P: AsRef<Path>>(path: P) -> FileResult<File> {
+        File::open(path)
+    }
+
     pub fn read_directory<P: AsRef<Path>>(path: P) -> FileResult<ReadDir> {
         fs::read_dir(path)
     }
@@ -146,3 +216,75 @@ impl FileIoManager {
         Ok(())
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::FileIoManager;
+    use crate::test_utils::TempDir;
+    use std::{
+        fs,
+        io::Write,
+        sync::{Arc, Barrier},
+        thread,
+    };
+
+    #[test]
+    fn write_file_atomically_replaces_content_and_cleans_up() {
+        let directory = TempDir::new("atomic_write");
+        let path = directory.join("file.txt");
+        fs::write(&path, "old content that is longer").unwrap();
+
+        FileIoManager::write_file_atomically(&path, |file| file.write_all(b"new")).unwrap();
+
+        assert_eq!(fs::read_to_string(&path).unwrap(), "new");
+        assert_eq!(fs::read_dir(&directory).unwrap().count(), 1);
+    }
+
+    #[test]
+    fn failed_write_keeps_original_file() {
+        let directory = TempDir::new("atomic_write_failure");
+        let path = directory.join("file.txt");
+        fs::write(&path, "original").unwrap();
+
+        let result = FileIoManager::write_file_atomically(&path, |file| {
+            file.write_all(b"partial")?;
+            Err::<(), _>(std::io::Error::other("disk full"))
+        });
+
+        assert!(result.is_err());
+        assert_eq!(fs::read_to_string(&path).unwrap(), "original");
+        assert_eq!(fs::read_dir(&directory).unwrap().count(), 1);
+    }
+
+    #[test]
+    fn concurrent_writes_to_one_path_use_separate_temp_files() {
+        let directory = TempDir::new("atomic_write_concurrent");
+        let path = directory.join("file.txt");
+        let barrier = Arc::new(Barrier::new(2));
+
+        let writers: Vec<_> = ["first", "second"]
+            .into_iter()
+            .map(|content| {
+                let path = path.clone();
+                let barrier = Arc::clone(&barrier);
+
+                thread::spawn(move || {
+                    FileIoManager::write_file_atomically(&path, |file| {
+                        file.write_all(content.as_bytes())?;
+                        // Both temp files exist at once here.
+                        barrier.wait();
+                        file.write_all(b" done")
+                    })
+                })
+            })
+            .collect();
+
+        for writer in writers {
+            writer.join().unwrap().unwrap();
+        }
+
+        let content = fs::read_to_string(&path).unwrap();
+        assert!(content == "first done" || content == "second done");
+        assert_eq!(fs::read_dir(&directory).unwrap().count(), 1);
+    }
+}
@@ -543,13 +543,15 @@ pub fn run_file_explorer_command(
         // index is provided.
         FileExplorerCommand::ActionIndex => {
             let index = ctx.index;
-            let children = tree.visible_nodes();
-            let index_usize = index as usize;
-
-            // Clear the selected node if click is not on a node or if the index is negative.
-            if index_usize >= children.len() || index.is_negative() {
-                tree.clear_current_path();
-            } else if let Some(target_node) = children.get(index_usize) {
+            let target_node = usize::try_from(index)
+                .ok()
+                .and_then(|index| tree.visible_node(index))
+                .filter(|node| !node.is_placeholder)
+                .cloned();
+
+            // Clear the current node (below) if click is not on a node (or is on a "Loading…"
+            // placeholder) or if the index is negative.
+            if let Some(target_node) = target_node {
                 let target_node_path = target_node.path.clone();
                 tree.set_current_path(&target_node_path);
 
@@ -564,6 +566,8 @@ pub fn run_file_explorer_command(
                         path: target_node_path.clone(),
                     });
                 }
+            } else {
+                tree.clear_current_path();
             }
         }
         // Handles the 'Clear Selected' event.
@@ -27,6 +27,15 @@ impl ConfigManager {
         }
     }
 
+    /// A manager holding `config` that is never read from or written to the settings file.
+    #[cfg(test)]
+    pub fn in_memory(config: Config) -> Self {
+        Self {
+            inner: RwLock::new(config),
+            file_path: PathBuf::new(),
+        }
+    }
+
     pub fn get_config_path() -> PathBuf {
         let mut path = dirs::config_dir().unwrap_or_else(|| PathBuf::from("."));
 
@@ -9,6 +9,9 @@ pub struct EditorConfig {
     pub font_family: String,
     pub switch_to_last_visited_tab_on_close: bool,
     pub auto_reopen_closed_tabs_in_history: bool,
+    /// Memory, in megabytes, that open files and their undo histories should stay within.
+    /// Unmodified files in the background are unloaded to get there. 0 disables the limit.
+    pub memory_budget_mb: usize,
 }
 
 impl Default for EditorConfig {
@@ -18,6 +21,7 @@ impl Default for EditorConfig {
             font_family: "IBM Plex Mono".into(),
             switch_to_last_visited_tab_on_close: true,
             auto_reopen_closed_tabs_in_history: true,
+            memory_budget_mb: 1024,
         }
     }
 }
@@ -28,12 +28,44 @@ pub mod ffi {
         active: bool,
     }
 
+    /// Everything needed to paint rows `first_row..` of the editor and gutter, fetched in one
+    /// call.
+    struct RenderSnapshotFfi {
+        first_row: usize,
+        lines: Vec<String>,
+        /// Only the cursors on the requested rows.
+        cursors: Vec<CursorPosition>,
+        selection: Selection,
+        line_count: usize,
+        /// [`Buffer::version`](crate::Buffer::version) of the text the lines were read from.
+        buffer_version: u64,
+        is_empty: bool,
+    }
+
+    struct CursorSummaryFfi {
+        /// The active cursor, clamped to the buffer.
+        row: usize,
+        col: usize,
+        cursor_count: usize,
+        selection_count: usize,
+    }
+
     #[derive(Default, Clone)]
     struct ScrollOffsetFfi {
         x: i32,
         y: i32,
     }
 
+    struct UnmeasuredLineFfi {
+        row: usize,
+        text: String,
+    }
+
+    struct LineWidthFfi {
+        row: usize,
+        width: f64,
+    }
+
     struct ChangeSetFfi {
         mask: u32,
         line_count_before: u32,
@@ -188,6 +220,9 @@ pub mod ffi {
         pub path_present: bool,
         pub path: String,
         pub modified: bool,
+        pub loading: bool,
+        pub changed_on_disk: bool,
+        pub lossy: bool,
     }
 
     struct TabsSnapshot {
@@ -196,11 +231,25 @@ pub mod ffi {
         pub tabs: Vec<TabSnapshot>,
     }
 
+    #[derive(Default)]
     pub struct TabSnapshotMaybe {
         pub found: bool,
+        pub index: u32,
         pub snapshot: TabSnapshot,
     }
 
+    enum TabEventKindFfi {
+        Modified,
+        Title,
+        Active,
+    }
+
+    struct TabEventFfi {
+        pub kind: TabEventKindFfi,
+        pub tab_id: u64,
+        pub modified: bool,
+    }
+
     pub struct MoveActiveTabResult {
         pub id: u64,
         pub reopened: bool,
@@ -251,6 +300,9 @@ pub mod ffi {
         NoPath,
         NotFound,
         ViewNotFound,
+        Loading,
+        SaveInProgress,
+        Lossy,
     }
 
     pub struct OpenTabResultFfi {
@@ -259,6 +311,31 @@ pub mod ffi {
         pub tab_already_exists: bool,
     }
 
+    enum DocumentLoadStatusFfi {
+        Loading,
+        Preview,
+        Finished,
+        Failed,
+    }
+
+    struct DocumentLoadEventFfi {
+        pub document_id: u64,
+        pub status: DocumentLoadStatusFfi,
+        pub bytes_read: u64,
+        pub total_bytes: u64,
+    }
+
+    struct DocumentSaveEventFfi {
+        pub document_id: u64,
+        pub succeeded: bool,
+    }
+
+    struct MemoryUsageFfi {
+        pub used_bytes: u64,
+        /// Zero if there is no budget.
+        pub budget_bytes: u64,
+    }
+
     #[derive(Default, Clone)]
     struct FileNodeSnapshot {
         path: String,
@@ -271,6 +348,7 @@ pub mod ffi {
         size: u64,
         modified: u64,
         depth: usize,
+        is_placeholder: bool,
     }
 
     struct MaybeFileNodeSnapshot {
@@ -278,6 +356,12 @@ pub mod ffi {
         node: FileNodeSnapshot,
     }
 
+    struct VisibleNodeSnapshot {
+        found_node: bool,
+        index: usize,
+        node: FileNodeSnapshot,
+    }
+
     struct FileTreeSnapshot {
         pub root_present: bool,
         pub root: String,
@@ -452,11 +536,33 @@ pub mod ffi {
 
         pub(crate) fn save_document(self: &mut AppController, id: u64) -> bool;
         pub(crate) fn save_document_as(self: &mut AppController, id: u64, path: &str) -> bool;
+        pub(crate) fn begin_save_document(self: &mut AppController, id: u64) -> bool;
+        pub(crate) fn begin_save_document_as(self: &mut AppController, id: u64, path: &str)
+        -> bool;
+        pub fn poll_document_saves(self: &mut AppController) -> Vec<DocumentSaveEventFfi>;
+        pub fn poll_document_disk_changes(self: &mut AppController) -> Vec<u64>;
+        pub fn has_pending_document_io(self: &AppController) -> bool;
         pub fn ensure_tab_for_path(
             self: &mut AppController,
             path: &str,
             add_to_history: bool,
         ) -> Result<OpenTabResultFfi>;
+        pub fn ensure_tab_for_path_in_background(
+            self: &mut AppController,
+            path: &str,
+            add_to_history: bool,
+        ) -> Result<OpenTabResultFfi>;
+        pub fn ensure_tab_for_path_deferred(
+            self: &mut AppController,
+            path: &str,
+            add_to_history: bool,
+        ) -> Result<OpenTabResultFfi>;
+        pub fn prefetch_documents(self: &mut AppController, limit: u32) -> u32;
+        pub fn enforce_memory_budget(self: &mut AppController) -> MemoryUsageFfi;
+        pub fn restore_session(self: &mut AppController) -> bool;
+        pub fn save_session_in_background(self: &mut AppController) -> bool;
+        pub fn save_session(self: &mut AppController);
+        pub fn poll_document_loads(self: &mut AppController) -> Vec<DocumentLoadEventFfi>;
 
         // EditorController
         pub fn select_word(self: &mut EditorController, row: usize, column: usize) -> ChangeSetFfi;
@@ -490,15 +596,18 @@ pub mod ffi {
         pub(crate) fn undo(self: &mut EditorController) -> ChangeSetFfi;
         pub(crate) fn redo(self: &mut EditorController) -> ChangeSetFfi;
         pub(crate) fn get_max_width(self: &EditorController) -> f64;
-        pub(crate) fn update_line_width(
-            self: &mut EditorController,
-            line_idx: usize,
-            line_width: f64,
-        );
-        pub(crate) fn needs_width_measurement(self: &EditorController, line_idx: usize) -> bool;
+        pub(crate) fn get_unmeasured_lines(
+            self: &EditorController,
+            first_row: usize,
+            last_row: usize,
+            limit: usize,
+        ) -> Vec<UnmeasuredLineFfi>;
+        pub(crate) fn update_line_widths(self: &mut EditorController, widths: &[LineWidthFfi]);
+        pub(crate) fn get_view_id(self: &EditorController) -> u64;
         pub(crate) fn get_text(self: &EditorController) -> String;
         pub(crate) fn get_line(self: &EditorController, line_idx: usize) -> String;
         pub(crate) fn get_line_count(self: &EditorController) -> usize;
+        pub(crate) fn get_layout_line_count(self: &EditorController) -> usize;
         pub(crate) fn get_cursor_positions(self: &EditorController) -> Vec<CursorPosition>;
         pub(crate) fn get_selection(self: &mut EditorController) -> Selection;
         pub(crate) fn copy(self: &EditorController) -> String;
@@ -513,7 +622,6 @@ pub mod ffi {
         pub(crate) fn get_last_added_cursor(self: &EditorController) -> CursorPosition;
         pub(crate) fn number_of_selections(self: &EditorController) -> usize;
         pub(crate) fn line_length(self: &EditorController, row: usize) -> usize;
-        pub(crate) fn lines(self: &EditorController) -> Vec<String>;
         #[allow(clippy::too_many_arguments)]
         pub(crate) fn select_word_drag(
             self: &mut EditorController,
@@ -529,7 +637,12 @@ pub mod ffi {
             anchor_row: usize,
             row: usize,
         ) -> ChangeSetFfi;
-        pub(crate) fn buffer_is_empty(self: &EditorController) -> bool;
+        pub(crate) fn get_render_snapshot(
+            self: &EditorController,
+            first_row: usize,
+            last_row: usize,
+        ) -> RenderSnapshotFfi;
+        pub(crate) fn get_cursor_summary(self: &EditorController) -> CursorSummaryFfi;
 
         // FileTreeController
         pub fn toggle_expanded(self: &mut FileTreeController, path: &str);
@@ -558,6 +671,21 @@ pub mod ffi {
         pub(crate) fn get_tree_snapshot(self: &FileTreeController) -> FileTreeSnapshot;
         pub fn get_first_node(self: &FileTreeController) -> MaybeFileNodeSnapshot;
         pub fn get_last_node(self: &FileTreeController) -> MaybeFileNodeSnapshot;
+        pub(crate) fn get_visible_count(self: &FileTreeController) -> usize;
+        pub(crate) fn get_visible_range(
+            self: &FileTreeController,
+            start: usize,
+            count: usize,
+        ) -> Vec<FileNodeSnapshot>;
+        pub(crate) fn get_current_node(self: &FileTreeController) -> VisibleNodeSnapshot;
+        pub(crate) fn is_expanded(self: &FileTreeController, path: &str) -> bool;
+        pub(crate) fn get_longest_visible_names(
+            self: &FileTreeController,
+            limit: usize,
+        ) -> Vec<String>;
+        pub(crate) fn has_pending_listings(self: &FileTreeController) -> bool;
+        pub(crate) fn poll_listings(self: &mut FileTreeController) -> bool;
+        pub(crate) fn poll_changes(self: &mut FileTreeController) -> bool;
 
         // TabController
         pub fn set_active_tab(self: &mut TabController, id: u64) -> Result<()>;
@@ -568,6 +696,13 @@ pub mod ffi {
             close_pinned: bool,
         ) -> Vec<u64>;
         pub fn get_tab_snapshot(self: &TabController, id: u64) -> TabSnapshotMaybe;
+        pub fn get_document_tab_snapshot(
+            self: &TabController,
+            document_id: u64,
+        ) -> TabSnapshotMaybe;
+        pub fn get_active_tab_id(self: &TabController) -> u64;
+        pub fn get_tab_count(self: &TabController) -> usize;
+        pub fn take_tab_events(self: &mut TabController) -> Vec<TabEventFfi>;
         pub(crate) fn close_tabs(
             self: &TabController,
             operation_type: CloseTabOperationTypeFfi,
@@ -1,6 +1,9 @@
 use crate::{
     AppState, ConfigManager,
-    ffi::{DocumentErrorFfi, OpenTabResultFfi, TabController},
+    ffi::{
+        DocumentErrorFfi, DocumentLoadEventFfi, DocumentSaveEventFfi, MemoryUsageFfi,
+        OpenTabResultFfi, TabController,
+    },
 };
 use std::{cell::RefCell, path::Path, rc::Rc};
 
@@ -82,6 +85,67 @@ impl AppController {
             .map_err(DocumentErrorFfi::from)
     }
 
+    /// Opens a tab for `path` immediately and reads the file on a worker thread. Poll
+    /// [`Self::poll_document_loads`] until it stops returning events to pick up the content.
+    pub fn ensure_tab_for_path_in_background(
+        &mut self,
+        path: &str,
+        add_to_history: bool,
+    ) -> Result<OpenTabResultFfi, DocumentErrorFfi> {
+        self.app_state
+            .borrow_mut()
+            .ensure_tab_for_path_in_background(Path::new(path), add_to_history)
+            .map(|result| result.into())
+            .map_err(DocumentErrorFfi::from)
+    }
+
+    /// Opens a tab for `path` without reading the file. It is loaded in the background once the
+    /// tab is activated or prefetched, and picked up by [`Self::poll_document_loads`].
+    pub fn ensure_tab_for_path_deferred(
+        &mut self,
+        path: &str,
+        add_to_history: bool,
+    ) -> Result<OpenTabResultFfi, DocumentErrorFfi> {
+        self.app_state
+            .borrow_mut()
+            .ensure_tab_for_path_deferred(Path::new(path), add_to_history)
+            .map(|result| result.into())
+            .map_err(DocumentErrorFfi::from)
+    }
+
+    pub fn prefetch_documents(&mut self, limit: u32) -> u32 {
+        self.app_state
+            .borrow_mut()
+            .prefetch_documents(limit as usize) as u32
+    }
+
+    /// Evicts what is needed to stay within the memory budget, and reports the usage after.
+    pub fn enforce_memory_budget(&mut self) -> MemoryUsageFfi {
+        self.app_state.borrow_mut().enforce_memory_budget().into()
+    }
+
+    /// Reopens the tabs saved in the last session. Returns whether there were any.
+    pub fn restore_session(&mut self) -> bool {
+        self.app_state.borrow_mut().load_session()
+    }
+
+    pub fn save_session_in_background(&mut self) -> bool {
+        self.app_state.borrow_mut().save_session_in_background()
+    }
+
+    pub fn save_session(&mut self) {
+        self.app_state.borrow_mut().save_session()
+    }
+
+    pub fn poll_document_loads(&mut self) -> Vec<DocumentLoadEventFfi> {
+        self.app_state
+            .borrow_mut()
+            .poll_document_loads()
+            .into_iter()
+            .map(DocumentLoadEventFfi::from)
+            .collect()
+    }
+
     pub fn save_document(&mut self, id: u64) -> bool {
         self.app_state.borrow_mut().save_document(id.into()).is_ok()
     }
@@ -92,4 +156,42 @@ impl AppController {
             .save_document_as(id.into(), Path::new(path))
             .is_ok()
     }
+
+    /// Like [`Self::save_document`], but writes on a worker thread. Returns whether the save was
+    /// started; poll [`Self::poll_document_saves`] for the outcome.
+    pub fn begin_save_document(&mut self, id: u64) -> bool {
+        self.app_state
+            .borrow_mut()
+            .begin_save_document(id.into(), None)
+            .is_ok()
+    }
+
+    pub fn begin_save_document_as(&mut self, id: u64, path: &str) -> bool {
+        self.app_state
+            .borrow_mut()
+            .begin_save_document(id.into(), Some(Path::new(path)))
+            .is_ok()
+    }
+
+    pub fn poll_document_saves(&mut self) -> Vec<DocumentSaveEventFfi> {
+        self.app_state
+            .borrow_mut()
+            .poll_document_saves()
+            .into_iter()
+            .map(DocumentSaveEventFfi::from)
+            .collect()
+    }
+
+    pub fn poll_document_disk_changes(&mut self) -> Vec<u64> {
+        self.app_state
+            .borrow_mut()
+            .poll_document_disk_changes()
+            .into_iter()
+            .map(u64::from)
+            .collect()
+    }
+
+    pub fn has_pending_document_io(&self) -> bool {
+        self.app_state.borrow().has_pending_document_io()
+    }
 }
@@ -1,6 +1,9 @@
 use crate::{
     AppState, Buffer, ChangeSet, Editor, ViewId,
-    ffi::{AddCursorDirectionFfi, ChangeSetFfi, CursorPosition, Selection},
+    ffi::{
+        AddCursorDirectionFfi, ChangeSetFfi, CursorPosition, CursorSummaryFfi, LineWidthFfi,
+        RenderSnapshotFfi, Selection, UnmeasuredLineFfi,
+    },
 };
 use std::{cell::RefCell, rc::Rc};
 
@@ -8,7 +11,6 @@ pub struct EditorController {
     /// A reference to the main app.
     pub(crate) app_state: Rc<RefCell<AppState>>,
     /// The view id needed to find the desired editor instance.
-    #[allow(dead_code)]
     pub(crate) view_id: ViewId,
 }
 
@@ -48,6 +50,10 @@ impl EditorController {
             .unwrap()
     }
 
+    pub fn get_view_id(&self) -> u64 {
+        self.view_id.into()
+    }
+
     pub fn get_text(&self) -> String {
         self.access(|_, buffer| buffer.get_text())
     }
@@ -60,6 +66,15 @@ impl EditorController {
         self.access(|_, buffer| buffer.line_count())
     }
 
+    /// The line count to size the viewport for. Until a document that was evicted or restored
+    /// from a session is read, this is the count it had before, so its scroll position is kept.
+    pub fn get_layout_line_count(&self) -> usize {
+        self.app_state
+            .borrow()
+            .with_view_and_document(self.view_id, |_, document| document.line_count())
+            .expect("Unable to access the specified Editor or Buffer.")
+    }
+
     pub fn get_cursor_positions(&self) -> Vec<CursorPosition> {
         self.access(|editor, _| {
             editor
@@ -73,36 +88,113 @@ impl EditorController {
         })
     }
 
-    pub fn update_line_width(&mut self, line_idx: usize, line_width: f64) {
-        self.access_mut(|editor, _| editor.update_line_width(line_idx, line_width))
+    /// Returns up to `limit` rows in `first_row..=last_row` whose width is unknown, along with
+    /// their text, so the UI can measure them without a round trip per line.
+    pub fn get_unmeasured_lines(
+        &self,
+        first_row: usize,
+        last_row: usize,
+        limit: usize,
+    ) -> Vec<UnmeasuredLineFfi> {
+        self.access(|editor, buffer| {
+            editor
+                .unmeasured_lines(first_row, last_row, limit)
+                .into_iter()
+                .map(|row| UnmeasuredLineFfi {
+                    row,
+                    text: buffer.get_line(row),
+                })
+                .collect()
+        })
     }
 
-    pub fn buffer_is_empty(&self) -> bool {
-        self.access(|_, buffer| buffer.is_empty())
+    pub fn update_line_widths(&mut self, widths: &[LineWidthFfi]) {
+        self.access_mut(|editor, _| {
+            for line in widths {
+                editor.update_line_width(line.row, line.width);
+            }
+        })
     }
 
     pub fn get_selection(&self) -> Selection {
-        self.access(|editor, _| {
-            let s = editor.selection().clone();
-            let start = s.start.clone();
-            let end = s.end.clone();
-            let anchor = s.anchor.clone();
-            let active = s.is_active();
-
-            Selection {
-                start: CursorPosition {
-                    row: start.row,
-                    col: start.column,
-                },
-                end: CursorPosition {
-                    row: end.row,
-                    col: end.column,
-                },
-                anchor: CursorPosition {
-                    row: anchor.row,
-                    col: anchor.column,
-                },
-                active,
+        self.access(|editor, _| Self::selection_ffi(editor))
+    }
+
+    fn selection_ffi(editor: &Editor) -> Selection {
+        let s = editor.selection();
+
+        Selection {
+            start: CursorPosition {
+                row: s.start.row,
+                col: s.start.column,
+            },
+            end: CursorPosition {
+                row: s.end.row,
+                col: s.end.column,
+            },
+            anchor: CursorPosition {
+                row: s.anchor.row,
+                col: s.anchor.column,
+            },
+            active: s.is_active(),
+        }
+    }
+
+    /// Collects the lines, cursors and selection for `first_row..=last_row` under a single borrow,
+    /// so a paint needs one round trip instead of one per query. Rows past the end of the buffer
+    /// are clamped away.
+    pub fn get_render_snapshot(&self, first_row: usize, last_row: usize) -> RenderSnapshotFfi {
+        self.access(|editor, buffer| {
+            let line_count = buffer.line_count();
+            let max_row = line_count.saturating_sub(1);
+            let first_row = first_row.min(max_row);
+            let last_row = last_row.min(max_row);
+
+            let lines = if last_row < first_row {
+                Vec::new()
+            } else {
+                editor.lines_range(buffer, first_row, last_row)
+            };
+
+            let cursors = editor
+                .cursors()
+                .iter()
+                .filter(|c| (first_row..=last_row).contains(&c.cursor.row))
+                .map(|c| CursorPosition {
+                    row: c.cursor.row,
+                    col: c.cursor.column,
+                })
+                .collect();
+
+            RenderSnapshotFfi {
+                first_row,
+                lines,
+                cursors,
+                selection: Self::selection_ffi(editor),
+                line_count,
+                buffer_version: buffer.version(),
+                is_empty: buffer.is_empty(),
+            }
+        })
+    }
+
+    pub fn get_cursor_summary(&self) -> CursorSummaryFfi {
+        self.access(|editor, buffer| {
+            let cursors = editor.cursors();
+            let (row, col) = cursors
+                .get(editor.active_cursor_index())
+                .map(|c| {
+                    let row = c.cursor.row.min(buffer.line_count().saturating_sub(1));
+                    let col = c.cursor.column.min(editor.line_length(buffer, row));
+                    (row, col)
+                })
+                .unwrap_or_default();
+
+            CursorSummaryFfi {
+                row,
+                col,
+                cursor_count: cursors.len(),
+                selection_count: editor.number_of_selections(),
             }
         })
     }
@@ -262,10 +354,6 @@ impl EditorController {
         self.access(|editor, _| editor.last_added_cursor()).into()
     }
 
-    pub fn needs_width_measurement(&self, line_idx: usize) -> bool {
-        self.access(|editor, _| editor.needs_width_measurement(line_idx))
-    }
-
     pub fn remove_cursor(&mut self, row: usize, col: usize) {
         self.access_mut(|editor, _| editor.remove_cursor(row, col))
     }
@@ -293,8 +381,4 @@ impl EditorController {
     pub fn line_length(&self, row: usize) -> usize {
         self.access(|editor, buffer| editor.line_length(buffer, row))
     }
-
-    pub fn lines(&self) -> Vec<String> {
-        self.access(|editor, buffer| editor.lines(buffer))
-    }
 }
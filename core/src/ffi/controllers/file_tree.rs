@@ -1,8 +1,15 @@
 use crate::{
     AppState, FileNode, FileTree,
-    ffi::{FileNodeSnapshot, FileSystemErrorFfi, FileTreeSnapshot, MaybeFileNodeSnapshot},
+    ffi::{
+        FileNodeSnapshot, FileSystemErrorFfi, FileTreeSnapshot, MaybeFileNodeSnapshot,
+        VisibleNodeSnapshot,
+    },
+};
+use std::{
+    cell::RefCell,
+    path::{Path, PathBuf},
+    rc::Rc,
 };
-use std::{cell::RefCell, collections::HashSet, path::PathBuf, rc::Rc};
 
 pub struct FileTreeController {
     pub(crate) app_state: Rc<RefCell<AppState>>,
@@ -93,15 +100,12 @@ impl FileTreeController {
         current_path: &str,
     ) -> Result<FileNodeSnapshot, FileSystemErrorFfi> {
         self.access(|tree| {
-            let selected_paths = tree.selected_owned();
-            let expanded_paths = tree.expanded_owned();
             let node = tree.next(current_path).unwrap();
 
             Ok(Self::make_file_node_snapshot(
+                tree,
                 &node,
-                &selected_paths,
-                &expanded_paths,
-                Some(&PathBuf::from(current_path)),
+                Some(Path::new(current_path)),
             ))
         })
     }
@@ -111,15 +115,12 @@ impl FileTreeController {
         current_path: &str,
     ) -> Result<FileNodeSnapshot, FileSystemErrorFfi> {
         self.access(|tree| {
-            let selected_paths = tree.selected_owned();
-            let expanded_paths = tree.expanded_owned();
             let node = tree.prev(current_path).unwrap();
 
             Ok(Self::make_file_node_snapshot(
+                tree,
                 &node,
-                &selected_paths,
-                &expanded_paths,
-                Some(&PathBuf::from(current_path)),
+                Some(Path::new(current_path)),
             ))
         })
     }
@@ -139,62 +140,129 @@ impl FileTreeController {
         path: &str,
     ) -> Result<Vec<FileNodeSnapshot>, FileSystemErrorFfi> {
         self.access_mut(|tree| {
-            let selected_paths = tree.selected_owned();
-            let expanded_paths = tree.expanded_owned();
+            tree.get_children(path).map_err(FileSystemErrorFfi::from)?;
+
+            let tree = &*tree;
             let current_path = tree.current_path();
-            let children = tree.get_children(path).map_err(FileSystemErrorFfi::from)?;
+            let children = tree
+                .loaded_nodes
+                .get(Path::new(path))
+                .map_or(&[][..], Vec::as_slice);
 
             Ok(children
                 .iter()
-                .map(|node| {
-                    Self::make_file_node_snapshot(
-                        node,
-                        &selected_paths,
-                        &expanded_paths,
-                        current_path.as_ref(),
-                    )
-                })
+                .map(|node| Self::make_file_node_snapshot(tree, node, current_path.as_deref()))
                 .collect())
         })
     }
 
     fn make_file_node_snapshot(
+        tree: &FileTree,
         node: &FileNode,
-        selected_paths: &HashSet<PathBuf>,
-        expanded_paths: &HashSet<PathBuf>,
-        current_path: Option<&PathBuf>,
+        current_path: Option<&Path>,
     ) -> FileNodeSnapshot {
         FileNodeSnapshot {
             path: node.path.clone().to_string_lossy().to_string(),
             name: node.name.clone(),
             is_dir: node.is_dir,
             is_hidden: node.is_hidden,
-            is_expanded: node.is_dir && expanded_paths.contains(&node.path),
-            is_selected: selected_paths.contains(&node.path),
-            is_current: current_path == Some(&node.path),
+            is_expanded: node.is_dir && tree.is_expanded(&node.path),
+            is_selected: tree.is_selected(&node.path),
+            is_current: current_path == Some(node.path.as_path()),
             size: node.size,
             modified: node.modified,
             depth: node.depth,
+            is_placeholder: node.is_placeholder,
         }
     }
 
+    pub fn has_pending_listings(&self) -> bool {
+        self.access(|tree| tree.has_pending_listings())
+    }
+
+    /// Merges in children listed in the background since the last poll, returning whether the
+    /// visible nodes changed.
+    pub fn poll_listings(&mut self) -> bool {
+        self.access_mut(|tree| tree.poll_listings())
+    }
+
+    /// Starts re-listing loaded directories that changed on disk, returning whether the visible
+    /// nodes changed right away. The new children arrive through `poll_listings`.
+    pub fn poll_changes(&mut self) -> bool {
+        self.access_mut(|tree| tree.poll_changes())
+    }
+
+    pub fn get_visible_count(&self) -> usize {
+        self.access(|tree| tree.visible_count())
+    }
+
+    /// Returns snapshots for up to `count` visible nodes starting at row `start`, so callers only
+    /// pay for the rows they show.
+    pub fn get_visible_range(&self, start: usize, count: usize) -> Vec<FileNodeSnapshot> {
+        self.access(|tree| {
+            let current_path = tree.current_path();
+
+            tree.visible_range(start, count)
+                .map(|node| Self::make_file_node_snapshot(tree, node, current_path.as_deref()))
+                .collect()
+        })
+    }
+
+    /// Returns the current node and its row, if it is visible.
+    pub fn get_current_node(&self) -> VisibleNodeSnapshot {
+        self.access(|tree| {
+            let current_path = tree.current_path();
+            let found = current_path.as_deref().and_then(|path| {
+                let index = tree.visible_index_of(path)?;
+                Some((index, tree.visible_node(index)?))
+            });
+
+            match found {
+                Some((index, node)) => VisibleNodeSnapshot {
+                    found_node: true,
+                    index,
+                    node: Self::make_file_node_snapshot(tree, node, current_path.as_deref()),
+                },
+                None => VisibleNodeSnapshot {
+                    found_node: false,
+                    index: 0,
+                    node: FileNodeSnapshot::default(),
+                },
+            }
+        })
+    }
+
+    pub fn is_expanded(&self, path: &str) -> bool {
+        self.access(|tree| tree.is_expanded(path))
+    }
+
+    /// Returns the `limit` longest visible node names (by character count), which are the only
+    /// candidates worth measuring when sizing the explorer's horizontal scroll range.
+    pub fn get_longest_visible_names(&self, limit: usize) -> Vec<String> {
+        self.access(|tree| {
+            let mut nodes: Vec<&FileNode> = tree.visible_nodes().collect();
+            let by_length_desc =
+                |a: &&FileNode, b: &&FileNode| b.name.chars().count().cmp(&a.name.chars().count());
+
+            if nodes.len() > limit {
+                if limit == 0 {
+                    return Vec::new();
+                }
+                nodes.select_nth_unstable_by(limit - 1, by_length_desc);
+                nodes.truncate(limit);
+            }
+
+            nodes.into_iter().map(|node| node.name.clone()).collect()
+        })
+    }
+
     pub fn get_tree_snapshot(&self) -> FileTreeSnapshot {
         self.access(|tree| {
-            let selected_paths = tree.selected_owned();
-            let expanded_paths = tree.expanded_owned();
             let current_path = tree.current_path();
 
             let nodes: Vec<FileNodeSnapshot> = tree
                 .visible_nodes()
-                .iter()
-                .map(|node| {
-                    Self::make_file_node_snapshot(
-                        node,
-                        &selected_paths,
-                        &expanded_paths,
-                        current_path.as_ref(),
-                    )
-                })
+                .map(|node| Self::make_file_node_snapshot(tree, node, current_path.as_deref()))
                 .collect();
 
             let (root_present, root) =
@@ -220,19 +288,12 @@ impl FileTreeController {
 
     pub fn get_first_node(&self) -> MaybeFileNodeSnapshot {
         self.access(|tree| {
-            let selected_paths = tree.selected_owned();
-            let expanded_paths = tree.expanded_owned();
             let current_path = tree.current_path();
 
-            if let Some(first_node) = tree.visible_nodes().first() {
+            if let Some(first_node) = tree.visible_nodes().next() {
                 MaybeFileNodeSnapshot {
                     found_node: true,
-                    node: Self::make_file_node_snapshot(
-                        first_node,
-                        &selected_paths,
-                        &expanded_paths,
-                        current_path.as_ref(),
-                    ),
+                    node: Self::make_file_node_snapshot(tree, first_node, current_path.as_deref()),
                 }
             } else {
                 MaybeFileNodeSnapshot {
@@ -245,19 +306,12 @@ impl FileTreeController {
 
     pub fn get_last_node(&self) -> MaybeFileNodeSnapshot {
         self.access(|tree| {
-            let selected_paths = tree.selected_owned();
-            let expanded_paths = tree.expanded_owned();
             let current_path = tree.current_path();
 
-            if let Some(last_node) = tree.visible_nodes().last() {
+            if let Some(last_node) = tree.visible_nodes().rev().find(|node| !node.is_placeholder) {
                 MaybeFileNodeSnapshot {
                     found_node: true,
-                    node: Self::make_file_node_snapshot(
-                        last_node,
-                        &selected_paths,
-                        &expanded_paths,
-                        current_path.as_ref(),
-                    ),
+                    node: Self::make_file_node_snapshot(tree, last_node, current_path.as_deref()),
                 }
             } else {
                 MaybeFileNodeSnapshot {
@@ -2,14 +2,17 @@ use crate::{
     AppState, Tab, TabError, TabId,
     ffi::{
         CloseManyTabsResult, CloseTabOperationTypeFfi, CreateDocumentTabAndViewResultFfi,
-        MoveActiveTabResult, PinTabResult, ScrollOffsetFfi, TabSnapshot, TabSnapshotMaybe,
-        TabsSnapshot,
+        MoveActiveTabResult, PinTabResult, ScrollOffsetFfi, TabEventFfi, TabSnapshot,
+        TabSnapshotMaybe, TabsSnapshot,
     },
 };
 use std::{cell::RefCell, rc::Rc};
 
 struct TabMetadata {
     modified: bool,
+    loading: bool,
+    changed_on_disk: bool,
+    lossy: bool,
     title: String,
     path: String,
 }
@@ -28,6 +31,9 @@ impl TabController {
             document_id: tab.get_document_id().into(),
             pinned: tab.get_is_pinned(),
             modified: tab_metadata.modified,
+            loading: tab_metadata.loading,
+            changed_on_disk: tab_metadata.changed_on_disk,
+            lossy: tab_metadata.lossy,
             title: tab_metadata.title,
             path: tab_metadata.path.clone(),
             path_present: !tab_metadata.path.is_empty(),
@@ -57,12 +63,18 @@ impl TabController {
 
             TabMetadata {
                 modified: document.modified,
+                loading: document.loading,
+                changed_on_disk: document.changed_on_disk,
+                lossy: document.lossy,
                 title: document.title.clone(),
                 path: document_path,
             }
         } else {
             TabMetadata {
                 modified: false,
+                loading: false,
+                changed_on_disk: false,
+                lossy: false,
                 title: "Untitled".to_string(),
                 path: String::new(),
             }
@@ -91,19 +103,59 @@ impl TabController {
     }
 
     pub fn get_tab_snapshot(&self, id: u64) -> TabSnapshotMaybe {
-        if let Ok(tab) = self.app_state.borrow().get_tab(id.into()) {
-            TabSnapshotMaybe {
+        let app_state = self.app_state.borrow();
+        // 0 stands for "no tab" on the C++ side, e.g. when no tab is active.
+        let Ok(id) = TabId::new(id) else {
+            return TabSnapshotMaybe::default();
+        };
+
+        match (app_state.get_tab(id), app_state.get_tab_index(id)) {
+            (Ok(tab), Some(index)) => TabSnapshotMaybe {
                 found: true,
+                index: index as u32,
                 snapshot: self.make_tab_snapshot(tab),
-            }
+            },
+            _ => TabSnapshotMaybe::default(),
+        }
+    }
+
+    pub fn get_document_tab_snapshot(&self, document_id: u64) -> TabSnapshotMaybe {
+        let tab_id = self
+            .app_state
+            .borrow()
+            .find_tab_by_document(document_id.into());
+
+        match tab_id {
+            Some(tab_id) => self.get_tab_snapshot(tab_id.into()),
+            None => TabSnapshotMaybe::default(),
+        }
+    }
+
+    /// Returns the id of the active tab, or 0 if no tabs are open.
+    pub fn get_active_tab_id(&self) -> u64 {
+        let app_state = self.app_state.borrow();
+
+        if app_state.get_tabs().is_empty() {
+            0
         } else {
-            TabSnapshotMaybe {
-                found: false,
-                snapshot: TabSnapshot::default(),
-            }
+            app_state.get_active_tab_id().into()
         }
     }
 
+    pub fn get_tab_count(&self) -> usize {
+        self.app_state.borrow().get_tabs().len()
+    }
+
+    /// Drains the tab changes made since the last call; see [`AppState::take_tab_events`].
+    pub fn take_tab_events(&mut self) -> Vec<TabEventFfi> {
+        self.app_state
+            .borrow_mut()
+            .take_tab_events()
+            .into_iter()
+            .map(Into::into)
+            .collect()
+    }
+
     pub(crate) fn close_tabs(
         &self,
         operation_type: CloseTabOperationTypeFfi,
@@ -133,12 +185,7 @@ impl TabController {
             .collect();
 
         let active_id = self.app_state.borrow().get_active_tab_id();
-        let active_present = self
-            .app_state
-            .borrow()
-            .get_tabs()
-            .iter()
-            .any(|t| t.get_id() == active_id);
+        let active_present = self.app_state.borrow().get_tab_index(active_id).is_some();
 
         TabsSnapshot {
             active_present,
@@ -209,13 +256,7 @@ impl TabController {
     }
 
     pub(crate) fn pin_tab(&mut self, id: u64) -> PinTabResult {
-        let from_index = match self
-            .app_state
-            .borrow()
-            .get_tabs()
-            .iter()
-            .position(|t| t.get_id() == id.into())
-        {
+        let from_index = match self.app_state.borrow().get_tab_index(id.into()) {
             Some(idx) => idx as u32,
             None => {
                 return PinTabResult {
@@ -236,13 +277,7 @@ impl TabController {
             };
         }
 
-        let to_index = match self
-            .app_state
-            .borrow()
-            .get_tabs()
-            .iter()
-            .position(|t| t.get_id() == id.into())
-        {
+        let to_index = match self.app_state.borrow().get_tab_index(id.into()) {
             Some(idx) => idx as u32,
             None => {
                 return PinTabResult {
@@ -267,13 +302,7 @@ impl TabController {
     }
 
     pub(crate) fn unpin_tab(&mut self, id: u64) -> PinTabResult {
-        let from_index = match self
-            .app_state
-            .borrow()
-            .get_tabs()
-            .iter()
-            .position(|t| t.get_id() == id.into())
-        {
+        let from_index = match self.app_state.borrow().get_tab_index(id.into()) {
             Some(idx) => idx as u32,
             None => {
                 return PinTabResult {
@@ -294,13 +323,7 @@ impl TabController {
             };
         }
 
-        let to_index = match self
-            .app_state
-            .borrow()
-            .get_tabs()
-            .iter()
-            .position(|t| t.get_id() == id.into())
-        {
+        let to_index = match self.app_state.borrow().get_tab_index(id.into()) {
             Some(idx) => idx as u32,
             None => {
                 return PinTabResult {
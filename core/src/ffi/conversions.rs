@@ -1,10 +1,11 @@
 use super::*;
 use crate::{
     AddCursorDirection, ChangeSet, CloseTabOperationType, Command, CommandResult, Config, Cursor,
-    DocumentError, DocumentTarget, FileExplorerCommand, FileExplorerCommandResult,
-    FileExplorerNavigationDirection, FileExplorerUiIntent, FileSystemError, JumpAliasInfo,
-    JumpCommand, JumpManagementCommand, LineTarget, OpenTabResult, TabCommand, TabCommandState,
-    TabContext, UiIntent,
+    DocumentError, DocumentLoadStatus, DocumentLoadUpdate, DocumentSaveUpdate, DocumentTarget,
+    FileExplorerCommand, FileExplorerCommandResult, FileExplorerNavigationDirection,
+    FileExplorerUiIntent, FileSystemError, JumpAliasInfo, JumpCommand, JumpManagementCommand,
+    LineTarget, MemoryUsage, OpenTabResult, TabCommand, TabCommandState, TabContext, TabEvent,
+    UiIntent,
     commands::{FileExplorerCommandState, FileExplorerContext, PasteInfo, PasteItem},
 };
 use std::{fmt, io, path::PathBuf};
@@ -74,6 +75,56 @@ impl From<OpenTabResult> for OpenTabResultFfi {
     }
 }
 
+impl From<DocumentLoadUpdate> for DocumentLoadEventFfi {
+    fn from(update: DocumentLoadUpdate) -> Self {
+        DocumentLoadEventFfi {
+            document_id: update.document_id.into(),
+            status: match update.status {
+                DocumentLoadStatus::Loading => DocumentLoadStatusFfi::Loading,
+                DocumentLoadStatus::Preview => DocumentLoadStatusFfi::Preview,
+                DocumentLoadStatus::Finished => DocumentLoadStatusFfi::Finished,
+                DocumentLoadStatus::Failed => DocumentLoadStatusFfi::Failed,
+            },
+            bytes_read: update.progress.bytes_read,
+            total_bytes: update.progress.total_bytes,
+        }
+    }
+}
+
+impl From<DocumentSaveUpdate> for DocumentSaveEventFfi {
+    fn from(update: DocumentSaveUpdate) -> Self {
+        DocumentSaveEventFfi {
+            document_id: update.document_id.into(),
+            succeeded: update.succeeded,
+        }
+    }
+}
+
+impl From<MemoryUsage> for MemoryUsageFfi {
+    fn from(usage: MemoryUsage) -> Self {
+        MemoryUsageFfi {
+            used_bytes: usage.used as u64,
+            budget_bytes: usage.budget.unwrap_or(0) as u64,
+        }
+    }
+}
+
+impl From<TabEvent> for TabEventFfi {
+    fn from(event: TabEvent) -> Self {
+        let (kind, id, modified) = match event {
+            TabEvent::ModifiedChanged { id, modified } => (TabEventKindFfi::Modified, id, modified),
+            TabEvent::TitleChanged(id) => (TabEventKindFfi::Title, id, false),
+            TabEvent::ActiveChanged(id) => (TabEventKindFfi::Active, id, false),
+        };
+
+        TabEventFfi {
+            kind,
+            tab_id: id.into(),
+            modified,
+        }
+    }
+}
+
 impl From<CloseTabOperationType> for CloseTabOperationTypeFfi {
     fn from(operation_type: CloseTabOperationType) -> Self {
         match operation_type {
@@ -429,6 +480,8 @@ impl fmt::Display for DocumentErrorFfi {
             DocumentErrorFfi::InvalidId => write!(f, "Document id must not be 0"),
             DocumentErrorFfi::NoPath => write!(f, "Document has no path"),
             DocumentErrorFfi::NotFound => write!(f, "Document not found"),
+            DocumentErrorFfi::Loading => write!(f, "Document is still loading"),
+            DocumentErrorFfi::SaveInProgress => write!(f, "Document is already being saved"),
             _ => unreachable!("DocumentErrorFfi Display cases should be handled"),
         }
     }
@@ -447,6 +500,9 @@ impl From<DocumentError> for DocumentErrorFfi {
             DocumentError::InvalidId(_) => DocumentErrorFfi::InvalidId,
             DocumentError::NoPath(_) => DocumentErrorFfi::NoPath,
             DocumentError::NotFound(_) => DocumentErrorFfi::NotFound,
+            DocumentError::Loading(_) => DocumentErrorFfi::Loading,
+            DocumentError::SaveInProgress(_) => DocumentErrorFfi::SaveInProgress,
+            DocumentError::Lossy(_) => DocumentErrorFfi::Lossy,
             DocumentError::ViewNotFound => DocumentErrorFfi::ViewNotFound,
         }
     }
@@ -1,4 +1,10 @@
-use crate::{FileIoManager, FileNode, FileSystemResult};
+use crate::{
+    FileNode, FileSystemResult, FileWatcher, WatchKind,
+    file_system::{
+        listing::{DirectoryListing, DirectoryListingEvent, list_directory, merge_batch},
+        visible::VisibleNodes,
+    },
+};
 use std::{
     collections::{HashMap, HashSet},
     path::{Path, PathBuf},
@@ -23,6 +29,26 @@ pub struct FileTree {
     selected_paths: HashSet<PathBuf>,
     /// The path currently used as the anchor for navigation or other movement actions.
     current_path: Option<PathBuf>,
+    /// Every visible node in display order, with its depth set. Kept in sync whenever nodes are
+    /// loaded or directories are expanded/collapsed, so readers can index into it directly.
+    visible: VisibleNodes,
+    /// Directories whose children are still being listed in the background (see
+    /// [`FileTree::poll_listings`]).
+    listings: HashMap<PathBuf, PendingListing>,
+    /// Watches the loaded directories whose children are shown, so that changes made outside the
+    /// editor are patched in (see [`FileTree::poll_changes`]). Spawned when the first directory is
+    /// loaded.
+    watcher: Option<FileWatcher>,
+}
+
+/// A directory being listed in the background.
+#[derive(Debug)]
+struct PendingListing {
+    listing: DirectoryListing,
+    /// The children listed so far, when re-listing a directory that is already loaded. Its
+    /// current children stay visible until the listing finishes and these replace them. `None`
+    /// for a first listing, whose children fill in `loaded_nodes` as batches arrive.
+    relisted: Option<Vec<FileNode>>,
 }
 
 impl FileTree {
@@ -53,13 +79,20 @@ impl FileTree {
         let mut expanded_paths = HashSet::new();
         expanded_paths.insert(root_path_buf.clone());
 
-        Ok(Self {
-            root_path: Some(root_path_buf),
+        let mut tree = Self {
+            root_path: Some(root_path_buf.clone()),
             loaded_nodes,
             expanded_paths,
             selected_paths: HashSet::new(),
             current_path: None,
-        })
+            visible: VisibleNodes::default(),
+            listings: HashMap::new(),
+            watcher: None,
+        };
+        tree.watch_directory(&root_path_buf);
+        tree.rebuild_visible();
+
+        Ok(tree)
     }
 
     /// Returns `true` if there are no loaded children, or `false` if there are.
@@ -86,6 +119,9 @@ impl FileTree {
             expanded_paths: HashSet::new(),
             selected_paths: HashSet::new(),
             current_path: None,
+            visible: VisibleNodes::default(),
+            listings: HashMap::new(),
+            watcher: None,
         }
     }
 
@@ -113,7 +149,31 @@ impl FileTree {
         &mut self,
         directory_path: P,
     ) -> FileSystemResult<&[FileNode]> {
-        Self::get_children_impl(&mut self.loaded_nodes, directory_path)
+        let path = directory_path.as_ref();
+
+        // The caller needs every child, so replace an in-flight first listing with a synchronous
+        // one. A re-listing can keep running, since the children from before are all there.
+        if self.is_first_listing(path) {
+            self.listings.remove(path);
+            self.loaded_nodes.remove(path);
+        }
+
+        // Loading an already expanded directory makes its children visible.
+        if !self.loaded_nodes.contains_key(path) {
+            let loaded = Self::get_children_impl(&mut self.loaded_nodes, path).map(|_| ());
+
+            if loaded.is_ok() {
+                self.watch_directory(path);
+            }
+
+            if self.is_expanded(path) {
+                self.splice_visible_children(path);
+            }
+
+            loaded?;
+        }
+
+        Self::get_children_impl(&mut self.loaded_nodes, path)
     }
 
     pub fn get_children_impl<P: AsRef<Path>>(
@@ -124,15 +184,7 @@ impl FileTree {
 
         // If the nodes for the given path aren't already loaded, add them.
         if !loaded_nodes.contains_key(&path) {
-            let mut children = Vec::new();
-            for entry_res in FileIoManager::read_directory(&path)? {
-                let entry = entry_res?;
-                // Actual depth will be updated later.
-                let node = FileNode::from_entry(entry, 1)?;
-                children.push(node);
-            }
-
-            children.sort_by_key(|n| (!n.is_dir, n.name.to_lowercase()));
+            let children = list_directory(&path)?;
             loaded_nodes.insert(path.clone(), children);
         }
 
@@ -151,37 +203,45 @@ impl FileTree {
             self.expanded_paths.remove(&path_buf);
             // Remove the loaded node entries for this path to force a reload.
             self.loaded_nodes.remove(&path_buf);
-            self.get_children(path)?;
+            let reloaded = self.get_children(&path_buf).map(|_| ());
+            self.splice_visible_children(&path_buf);
+            reloaded?;
         }
 
         Ok(())
     }
 
     /// Returns true if the provided path is expanded, and false if it is not.
-    fn is_expanded<P: AsRef<Path>>(&self, path: P) -> bool {
+    pub fn is_expanded<P: AsRef<Path>>(&self, path: P) -> bool {
         self.expanded_paths.contains(path.as_ref())
     }
 
     /// Returns the "next" node in the tree (the one below the `current_path` node), if any.
+    ///
+    /// Placeholder rows are skipped.
     pub fn next<P: AsRef<Path>>(&self, current_path: P) -> Option<FileNode> {
-        let path = current_path.as_ref();
-
-        let visible_nodes = self.visible_nodes();
-        let idx = visible_nodes.iter().position(|node| node.path == path)?;
-        visible_nodes.get(idx + 1).cloned()
+        let idx = self.visible_index_of(current_path)?;
+        self.visible
+            .range(idx + 1..self.visible.len())
+            .find(|node| !node.is_placeholder)
+            .cloned()
     }
 
     /// Returns the "previous" node in the tree (the one above the `current_path` node), if any.
+    ///
+    /// Placeholder rows are skipped.
     pub fn prev<P: AsRef<Path>>(&self, current_path: P) -> Option<FileNode> {
-        let path = current_path.as_ref();
+        let idx = self.visible_index_of(current_path)?;
+        self.visible
+            .range(0..idx)
+            .rev()
+            .find(|node| !node.is_placeholder)
+            .cloned()
+    }
 
-        let visible_nodes = self.visible_nodes();
-        let idx = visible_nodes.iter().position(|node| node.path == path)?;
-        if idx == 0 {
-            None
-        } else {
-            visible_nodes.get(idx - 1).cloned()
-        }
+    /// Returns `true` if the provided path is selected, and `false` if it is not.
+    pub fn is_selected<P: AsRef<Path>>(&self, path: P) -> bool {
+        self.selected_paths.contains(path.as_ref())
     }
 
     /// Toggles selection on a node, selecting it if it is not selected, and unselecting it if it
@@ -225,14 +285,26 @@ impl FileTree {
     /// Removes all paths from `expanded_paths`, effectively collapsing everything.
     pub fn collapse_all(&mut self) {
         self.expanded_paths.clear();
+        self.rebuild_visible();
+
+        if let Some(root_path) = self.root_path.clone() {
+            for child in self.loaded_child_directories(&root_path) {
+                self.unwatch_directory_tree(&child);
+            }
+        }
     }
 
     /// Removes the provided path from `expanded_paths`, effectively marking it as collapsed.
+    ///
+    /// The directory and everything loaded below it stop being watched while hidden; their
+    /// children stay loaded and are re-listed when it is expanded again.
     pub fn set_collapsed<P: AsRef<Path>>(&mut self, path: P) {
         let path_buf = path.as_ref().to_path_buf();
 
         if path_buf.is_dir() && self.is_expanded(path) {
             self.expanded_paths.remove(&path_buf);
+            self.splice_visible_children(&path_buf);
+            self.unwatch_directory_tree(&path_buf);
         }
     }
 
@@ -247,10 +319,290 @@ impl FileTree {
 
         // We only need to load the children if we are changing state from collapsed -> expanded.
         if self.expanded_paths.insert(path_buf.clone()) {
-            let _ = self.get_children(&path_buf);
+            if self.loaded_nodes.contains_key(&path_buf) {
+                self.resume_watching(&path_buf);
+            } else {
+                self.start_listing(&path_buf);
+            }
+            self.splice_visible_children(&path_buf);
+        }
+    }
+
+    /// Starts listing `directory_path` in the background, unless its children are already loaded
+    /// or being listed. A placeholder row stands in for them until the listing finishes.
+    fn start_listing(&mut self, directory_path: &Path) {
+        if self.loaded_nodes.contains_key(directory_path) {
+            return;
+        }
+
+        // A directory that can't be opened is left without children, as with a synchronous load.
+        if let Ok(listing) = DirectoryListing::spawn(directory_path) {
+            self.loaded_nodes
+                .insert(directory_path.to_path_buf(), Vec::new());
+            self.listings.insert(
+                directory_path.to_path_buf(),
+                PendingListing {
+                    listing,
+                    relisted: None,
+                },
+            );
+            self.watch_directory(directory_path);
         }
     }
 
+    /// Returns `true` if `directory_path` is being listed for the first time, so its children are
+    /// still filling in behind a placeholder row.
+    fn is_first_listing(&self, directory_path: &Path) -> bool {
+        self.listings
+            .get(directory_path)
+            .is_some_and(|pending| pending.relisted.is_none())
+    }
+
+    /// Re-lists the loaded `directory_path` in the background, replacing any listing of it that
+    /// is still running. Fails if the directory can no longer be opened.
+    fn start_relisting(&mut self, directory_path: &Path) -> FileSystemResult<()> {
+        let listing = DirectoryListing::spawn(directory_path)?;
+        self.listings.insert(
+            directory_path.to_path_buf(),
+            PendingListing {
+                listing,
+                relisted: Some(Vec::new()),
+            },
+        );
+
+        Ok(())
+    }
+
+    /// Watches `directory_path` and every loaded directory shown below it again, after it was
+    /// collapsed, and re-lists the ones that are not being listed already, since changes made
+    /// while they were hidden went unreported.
+    fn resume_watching(&mut self, directory_path: &Path) {
+        let mut pending = vec![directory_path.to_path_buf()];
+
+        while let Some(path) = pending.pop() {
+            self.watch_directory(&path);
+
+            if !self.listings.contains_key(&path) {
+                // A directory that is gone is forgotten once its parent's change is polled.
+                _ = self.start_relisting(&path);
+            }
+
+            pending.extend(
+                self.loaded_child_directories(&path)
+                    .into_iter()
+                    .filter(|child| self.is_expanded(child)),
+            );
+        }
+    }
+
+    /// Returns the children of `directory_path` that are directories with loaded children.
+    fn loaded_child_directories(&self, directory_path: &Path) -> Vec<PathBuf> {
+        self.loaded_nodes
+            .get(directory_path)
+            .into_iter()
+            .flatten()
+            .filter(|node| node.is_dir && self.loaded_nodes.contains_key(&node.path))
+            .map(|node| node.path.clone())
+            .collect()
+    }
+
+    /// Stops watching `directory_path` and every loaded directory below it.
+    fn unwatch_directory_tree(&self, directory_path: &Path) {
+        let Some(watcher) = &self.watcher else {
+            return;
+        };
+
+        for path in self.loaded_nodes.keys() {
+            if path.starts_with(directory_path) {
+                watcher.unwatch(path);
+            }
+        }
+    }
+
+    /// Returns `true` if any directory is still being listed in the background.
+    pub fn has_pending_listings(&self) -> bool {
+        !self.listings.is_empty()
+    }
+
+    /// Merges in the children that background listings have produced since the last poll, and
+    /// swaps in the children of directories that finished being re-listed.
+    ///
+    /// Returns `true` if the tree changed.
+    pub fn poll_listings(&mut self) -> bool {
+        let mut changed_paths = Vec::new();
+        let mut finished_paths = Vec::new();
+
+        for (path, pending) in &mut self.listings {
+            let mut changed = false;
+
+            while let Some(event) = pending.listing.try_next() {
+                match event {
+                    DirectoryListingEvent::Batch(batch) => match &mut pending.relisted {
+                        Some(relisted) => merge_batch(relisted, batch),
+                        None => {
+                            let children = self.loaded_nodes.entry(path.clone()).or_default();
+                            merge_batch(children, batch);
+                            changed = true;
+                        }
+                    },
+                    DirectoryListingEvent::Finished(result) => {
+                        // Like a failed synchronous load, a listing that failed before producing
+                        // anything leaves the directory unloaded so that it is retried.
+                        if result.is_err()
+                            && pending.relisted.is_none()
+                            && self.loaded_nodes.get(path).is_some_and(Vec::is_empty)
+                        {
+                            self.loaded_nodes.remove(path);
+                        }
+
+                        finished_paths.push((path.clone(), result.is_ok()));
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+
+            if changed {
+                changed_paths.push(path.clone());
+            }
+        }
+
+        for (path, succeeded) in finished_paths {
+            let Some(pending) = self.listings.remove(&path) else {
+                continue;
+            };
+
+            // A re-listing that failed part way keeps the children from before; if the directory
+            // is gone, its parent's change forgets it.
+            if let (Some(children), true) = (pending.relisted, succeeded) {
+                self.replace_children(&path, children);
+            }
+        }
+
+        for path in &changed_paths {
+            self.splice_visible_children(path);
+        }
+
+        !changed_paths.is_empty()
+    }
+
+    /// Replaces the loaded children of `directory_path`, forgetting the directories that are no
+    /// longer among them.
+    fn replace_children(&mut self, directory_path: &Path, children: Vec<FileNode>) {
+        let child_paths: HashSet<&Path> = children.iter().map(|node| node.path.as_path()).collect();
+        let removed_directories: Vec<PathBuf> = self
+            .loaded_nodes
+            .get(directory_path)
+            .into_iter()
+            .flatten()
+            .filter(|node| node.is_dir && !child_paths.contains(node.path.as_path()))
+            .map(|node| node.path.clone())
+            .collect();
+
+        for directory in &removed_directories {
+            self.forget_directory(directory);
+        }
+
+        self.loaded_nodes
+            .insert(directory_path.to_path_buf(), children);
+    }
+
+    fn watch_directory(&mut self, directory_path: &Path) {
+        if self.watcher.is_none() {
+            // Without a watcher the tree still works; it just isn't updated for outside changes.
+            self.watcher = FileWatcher::spawn().ok();
+        }
+
+        if let Some(watcher) = &self.watcher {
+            watcher.watch(directory_path, WatchKind::Directory);
+        }
+    }
+
+    /// Drops the loaded children, listings, expanded state and watches of `directory_path` and
+    /// every directory below it.
+    fn forget_directory(&mut self, directory_path: &Path) {
+        let forgotten: Vec<PathBuf> = self
+            .loaded_nodes
+            .keys()
+            .filter(|path| path.starts_with(directory_path))
+            .cloned()
+            .collect();
+
+        for path in &forgotten {
+            self.loaded_nodes.remove(path);
+            self.listings.remove(path);
+
+            if let Some(watcher) = &self.watcher {
+                watcher.unwatch(path);
+            }
+        }
+
+        self.expanded_paths
+            .retain(|path| !path.starts_with(directory_path));
+    }
+
+    /// Starts re-listing the loaded directories that changed on disk since the last poll. Their
+    /// new children replace the old ones in [`FileTree::poll_listings`], so only their rows
+    /// change.
+    ///
+    /// Returns `true` if the tree changed right away, which is only the case for directories that
+    /// are gone.
+    pub fn poll_changes(&mut self) -> bool {
+        let Some(watcher) = &self.watcher else {
+            return false;
+        };
+
+        let mut changed_paths: Vec<PathBuf> = watcher
+            .try_changes()
+            .into_iter()
+            .map(|change| change.path)
+            .collect();
+
+        // Parents sort before their children, so a directory removed along with its parent is
+        // forgotten before it is reached.
+        changed_paths.sort();
+        changed_paths.dedup();
+
+        let mut tree_changed = false;
+
+        for path in changed_paths {
+            if !self.loaded_nodes.contains_key(&path) {
+                continue;
+            }
+
+            // A first listing may have read the directory before the change, so start it over.
+            let restarted = self.is_first_listing(&path);
+
+            let started = if restarted {
+                self.listings.remove(&path);
+                self.loaded_nodes.remove(&path);
+                self.start_listing(&path);
+
+                self.loaded_nodes.contains_key(&path)
+            } else {
+                self.start_relisting(&path).is_ok()
+            };
+
+            if !started {
+                if self.root_path.as_deref() == Some(path.as_path()) {
+                    // The root stays loaded and watched, so that it fills back in if it
+                    // reappears.
+                    self.listings.remove(&path);
+                    self.replace_children(&path, Vec::new());
+                } else {
+                    self.forget_directory(&path);
+                }
+            }
+
+            if restarted || !started {
+                self.splice_visible_children(&path);
+                tree_changed = true;
+            }
+        }
+
+        tree_changed
+    }
+
     /// Ensures that the directory containing `path` (and all of its ancestors) are marked as
     /// expanded and have their children loaded.
     pub fn ensure_path_visible<P: AsRef<Path>>(&mut self, path: P) -> FileSystemResult<()> {
@@ -300,26 +652,100 @@ impl FileTree {
         // Ensure we expand from the root downwards.
         ancestor_paths.reverse();
 
+        // Each ancestor becomes visible once its parent has been spliced in, so splice per level.
         for ancestor_path in ancestor_paths {
-            if self.expanded_paths.insert(ancestor_path.clone()) {
-                let _ = self.get_children(&ancestor_path);
+            let newly_expanded = self.expanded_paths.insert(ancestor_path.clone());
+            let was_loaded = self.loaded_nodes.contains_key(&ancestor_path)
+                && !self.is_first_listing(&ancestor_path);
+
+            // The revealed path has to be visible right away, so, as in `get_children`, a
+            // listing still in flight is replaced by a synchronous one (which splices its rows).
+            _ = self.get_children(&ancestor_path);
+
+            if newly_expanded && was_loaded {
+                self.resume_watching(&ancestor_path);
+                self.splice_visible_children(&ancestor_path);
             }
         }
 
         Ok(())
     }
 
-    /// Returns a flattened list of all visible nodes in the tree, in sorted
-    /// order.
-    pub fn visible_nodes(&self) -> Vec<FileNode> {
+    /// Iterates over all visible nodes in the tree, in sorted order.
+    pub fn visible_nodes(&self) -> impl DoubleEndedIterator<Item = &FileNode> {
+        self.visible.iter()
+    }
+
+    /// Returns the visible node at row `row`, if there is one.
+    pub fn visible_node(&self, row: usize) -> Option<&FileNode> {
+        self.visible.get(row)
+    }
+
+    /// Returns the number of visible nodes.
+    pub fn visible_count(&self) -> usize {
+        self.visible.len()
+    }
+
+    /// Returns up to `count` visible nodes starting at row `start`.
+    pub fn visible_range(
+        &self,
+        start: usize,
+        count: usize,
+    ) -> impl DoubleEndedIterator<Item = &FileNode> {
+        self.visible.range(start..start.saturating_add(count))
+    }
+
+    /// Returns the row of the visible node with the given path, if it is visible.
+    pub fn visible_index_of<P: AsRef<Path>>(&self, path: P) -> Option<usize> {
+        self.visible.index_of(path.as_ref())
+    }
+
+    /// Rebuilds the flattened list of visible nodes from scratch.
+    fn rebuild_visible(&mut self) {
         let mut visible_nodes = Vec::new();
-        let root_path = match &self.root_path {
-            Some(path) => path,
-            None => return visible_nodes,
+
+        if let Some(root_path) = &self.root_path {
+            self.collect_visible_owned(root_path, 0, &mut visible_nodes);
+        }
+
+        self.visible = VisibleNodes::from_nodes(visible_nodes);
+    }
+
+    /// Replaces the visible rows below `directory_path` with its current children (or with
+    /// nothing, if it is collapsed), leaving the rest of the list untouched.
+    ///
+    /// Does nothing if the directory itself is hidden under a collapsed ancestor.
+    fn splice_visible_children(&mut self, directory_path: &Path) {
+        let Some(root_path) = self.root_path.as_deref() else {
+            return;
+        };
+        let is_root = directory_path == root_path;
+
+        let (start, depth) = if is_root {
+            (0, 0)
+        } else {
+            let Some(row) = self.visible_index_of(directory_path) else {
+                return;
+            };
+            (
+                row + 1,
+                self.visible.get(row).map_or(0, |node| node.depth) + 1,
+            )
         };
 
-        self.collect_visible_owned(root_path, 0, &mut visible_nodes);
-        visible_nodes
+        // The directory's current rows run until the next node that is not nested inside it.
+        let end = self
+            .visible
+            .range(start..self.visible.len())
+            .position(|node| node.depth < depth)
+            .map_or(self.visible.len(), |offset| start + offset);
+
+        let mut children = Vec::new();
+        if is_root || self.is_expanded(directory_path) {
+            self.collect_visible_owned(directory_path, depth, &mut children);
+        }
+
+        self.visible.splice(start..end, children);
     }
 
     fn collect_visible_owned<P: AsRef<Path>>(
@@ -342,6 +768,10 @@ impl FileTree {
                 self.collect_visible_owned(&node.path, depth + 1, collected_nodes);
             }
         }
+
+        if self.is_first_listing(path) {
+            collected_nodes.push(FileNode::placeholder(path, depth));
+        }
     }
 
     /// Returns `true` if there are selected nodes, or `false` if there aren't.
@@ -364,3 +794,296 @@ impl FileTree {
         self.selected_paths.clear();
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_utils::TempDir;
+    use std::{fs, thread, time::Duration};
+
+    fn make_tree(name: &str) -> (TempDir, FileTree) {
+        let root = TempDir::new(name);
+        fs::create_dir_all(root.join("a").join("nested")).unwrap();
+        fs::create_dir_all(root.join("b")).unwrap();
+        fs::write(root.join("a").join("x.txt"), "").unwrap();
+        fs::write(root.join("a").join("nested").join("y.txt"), "").unwrap();
+        fs::write(root.join("b").join("z.txt"), "").unwrap();
+        fs::write(root.join("c.txt"), "").unwrap();
+
+        let tree = FileTree::new(Some(&root)).unwrap();
+        (root, tree)
+    }
+
+    /// Expands `path` and waits for its background listing to be merged in.
+    fn expand(tree: &mut FileTree, path: PathBuf) {
+        tree.set_expanded(path);
+
+        while tree.has_pending_listings() {
+            tree.poll_listings();
+            thread::sleep(Duration::from_millis(1));
+        }
+    }
+
+    /// Returns the visible names, checking along the way that every row can be looked up by path
+    /// and matches a from-scratch rebuild.
+    fn visible_names(tree: &FileTree) -> Vec<String> {
+        let mut expected = Vec::new();
+        tree.collect_visible_owned(tree.root_path.as_ref().unwrap(), 0, &mut expected);
+        let rows = |nodes: &[FileNode]| -> Vec<(PathBuf, usize)> {
+            nodes
+                .iter()
+                .map(|node| (node.path.clone(), node.depth))
+                .collect()
+        };
+        let visible: Vec<FileNode> = tree.visible_nodes().cloned().collect();
+        assert_eq!(rows(&visible), rows(&expected));
+
+        for (row, node) in visible.iter().enumerate() {
+            assert_eq!(tree.visible_index_of(&node.path), Some(row));
+        }
+
+        visible
+            .iter()
+            .map(|node| format!("{}{}", "  ".repeat(node.depth), node.name))
+            .collect()
+    }
+
+    #[test]
+    fn expand_and_collapse_splice_rows() {
+        let (root, mut tree) = make_tree("file_tree_splice");
+        assert_eq!(visible_names(&tree), ["a", "b", "c.txt"]);
+
+        expand(&mut tree, root.join("a"));
+        assert_eq!(
+            visible_names(&tree),
+            ["a", "  nested", "  x.txt", "b", "c.txt"]
+        );
+
+        expand(&mut tree, root.join("a").join("nested"));
+        expand(&mut tree, root.join("b"));
+        assert_eq!(
+            visible_names(&tree),
+            [
+                "a",
+                "  nested",
+                "    y.txt",
+                "  x.txt",
+                "b",
+                "  z.txt",
+                "c.txt"
+            ]
+        );
+
+        // Collapsing keeps nested expansion state for when the directory is reopened.
+        tree.set_collapsed(root.join("a"));
+        assert_eq!(visible_names(&tree), ["a", "b", "  z.txt", "c.txt"]);
+
+        expand(&mut tree, root.join("a"));
+        assert_eq!(
+            visible_names(&tree),
+            [
+                "a",
+                "  nested",
+                "    y.txt",
+                "  x.txt",
+                "b",
+                "  z.txt",
+                "c.txt"
+            ]
+        );
+    }
+
+    #[test]
+    fn next_and_prev_follow_shifted_rows() {
+        let (root, mut tree) = make_tree("file_tree_navigation");
+        let c_path = root.join("c.txt");
+
+        // Look `c.txt` up first, so its cached row is stale once `a` is expanded above it.
+        assert_eq!(tree.prev(&c_path).unwrap().name, "b");
+        expand(&mut tree, root.join("a"));
+        expand(&mut tree, root.join("b"));
+
+        assert_eq!(tree.prev(&c_path).unwrap().name, "z.txt");
+        assert_eq!(tree.next(root.join("a").join("x.txt")).unwrap().name, "b");
+        assert!(tree.next(&c_path).is_none());
+        assert!(tree.prev(root.join("a")).is_none());
+    }
+
+    #[test]
+    fn refresh_and_reveal_update_rows() {
+        let (root, mut tree) = make_tree("file_tree_refresh");
+
+        tree.ensure_path_visible(root.join("a").join("nested").join("y.txt"))
+            .unwrap();
+        assert_eq!(
+            visible_names(&tree),
+            ["a", "  nested", "    y.txt", "  x.txt", "b", "c.txt"]
+        );
+
+        fs::write(root.join("a").join("w.txt"), "").unwrap();
+        tree.refresh_dir(root.join("a")).unwrap();
+        expand(&mut tree, root.join("a"));
+        assert_eq!(
+            visible_names(&tree),
+            [
+                "a",
+                "  nested",
+                "    y.txt",
+                "  w.txt",
+                "  x.txt",
+                "b",
+                "c.txt"
+            ]
+        );
+
+        fs::write(root.join("d.txt"), "").unwrap();
+        tree.refresh_dir(&root).unwrap();
+        assert!(visible_names(&tree).ends_with(&["c.txt".to_string(), "d.txt".to_string()]));
+
+        tree.collapse_all();
+        assert_eq!(visible_names(&tree), ["a", "b", "c.txt", "d.txt"]);
+    }
+
+    #[test]
+    fn shows_placeholder_until_listing_finishes() {
+        let (root, mut tree) = make_tree("file_tree_placeholder");
+
+        tree.set_expanded(root.join("b"));
+        assert_eq!(visible_names(&tree), ["a", "b", "  Loading…", "c.txt"]);
+
+        // Navigation skips the placeholder row.
+        assert_eq!(tree.next(root.join("b")).unwrap().name, "c.txt");
+        assert_eq!(tree.prev(root.join("c.txt")).unwrap().name, "b");
+
+        while tree.has_pending_listings() {
+            tree.poll_listings();
+            thread::sleep(Duration::from_millis(1));
+        }
+        assert_eq!(visible_names(&tree), ["a", "b", "  z.txt", "c.txt"]);
+
+        // Asking for the children directly replaces an in-flight listing.
+        tree.set_expanded(root.join("a"));
+        assert_eq!(tree.get_children(root.join("a")).unwrap().len(), 2);
+        assert!(!tree.has_pending_listings());
+        assert_eq!(
+            visible_names(&tree),
+            ["a", "  nested", "  x.txt", "b", "  z.txt", "c.txt"]
+        );
+    }
+
+    #[test]
+    fn reveals_paths_under_directories_still_being_listed() {
+        let (root, mut tree) = make_tree("file_tree_reveal_listing");
+
+        // Not polled, so the listing of `a` is still in flight.
+        tree.set_expanded(root.join("a"));
+        assert!(tree.has_pending_listings());
+
+        tree.ensure_path_visible(root.join("a").join("nested").join("y.txt"))
+            .unwrap();
+
+        assert!(!tree.has_pending_listings());
+        assert_eq!(
+            visible_names(&tree),
+            ["a", "  nested", "    y.txt", "  x.txt", "b", "c.txt"]
+        );
+        assert!(
+            tree.visible_index_of(root.join("a").join("nested").join("y.txt"))
+                .is_some()
+        );
+    }
+
+    #[test]
+    fn patches_directories_changed_on_disk() {
+        let (root, mut tree) = make_tree("file_tree_watch");
+        expand(&mut tree, root.join("a"));
+        expand(&mut tree, root.join("a").join("nested"));
+        expand(&mut tree, root.join("b"));
+
+        fs::remove_dir_all(root.join("a").join("nested")).unwrap();
+        fs::write(root.join("b").join("new.txt"), "").unwrap();
+
+        let expected = ["a", "  x.txt", "b", "  new.txt", "  z.txt", "c.txt"];
+        let deadline = std::time::Instant::now() + Duration::from_secs(5);
+        while visible_names(&tree) != expected && std::time::Instant::now() < deadline {
+            tree.poll_changes();
+            tree.poll_listings();
+            thread::sleep(Duration::from_millis(10));
+        }
+
+        assert_eq!(visible_names(&tree), expected);
+        // The removed directory is forgotten rather than left loaded and watched.
+        assert!(
+            !tree
+                .loaded_nodes
+                .contains_key(&root.join("a").join("nested"))
+        );
+        assert!(!tree.is_expanded(root.join("a").join("nested")));
+    }
+
+    #[test]
+    fn relists_changed_directories_in_the_background() {
+        let (root, mut tree) = make_tree("file_tree_relist");
+        expand(&mut tree, root.join("b"));
+        fs::write(root.join("b").join("new.txt"), "").unwrap();
+
+        let deadline = std::time::Instant::now() + Duration::from_secs(5);
+        while !tree.has_pending_listings() && std::time::Instant::now() < deadline {
+            tree.poll_changes();
+            thread::sleep(Duration::from_millis(10));
+        }
+        assert!(tree.has_pending_listings());
+
+        // The old rows stay up, without a placeholder, until the new listing is merged in.
+        assert_eq!(visible_names(&tree), ["a", "b", "  z.txt", "c.txt"]);
+
+        while tree.has_pending_listings() {
+            tree.poll_listings();
+            thread::sleep(Duration::from_millis(1));
+        }
+        assert_eq!(
+            visible_names(&tree),
+            ["a", "b", "  new.txt", "  z.txt", "c.txt"]
+        );
+    }
+
+    #[test]
+    fn collapsed_directories_are_not_watched_until_expanded_again() {
+        let (root, mut tree) = make_tree("file_tree_unwatch");
+        let a = root.join("a");
+        let nested = a.join("nested");
+        expand(&mut tree, a.clone());
+        expand(&mut tree, nested.clone());
+
+        tree.set_collapsed(&a);
+        let watcher = tree.watcher.as_ref().unwrap();
+        assert!(!watcher.is_watching(&a));
+        assert!(!watcher.is_watching(&nested));
+        assert!(watcher.is_watching(&root));
+
+        // Changes made while hidden are picked up when the directory is shown again.
+        fs::write(a.join("w.txt"), "").unwrap();
+        fs::write(nested.join("v.txt"), "").unwrap();
+        expand(&mut tree, a.clone());
+
+        let watcher = tree.watcher.as_ref().unwrap();
+        assert!(watcher.is_watching(&a));
+        assert!(watcher.is_watching(&nested));
+        assert_eq!(
+            visible_names(&tree),
+            [
+                "a",
+                "  nested",
+                "    v.txt",
+                "    y.txt",
+                "  w.txt",
+                "  x.txt",
+                "b",
+                "c.txt"
+            ]
+        );
+
+        tree.collapse_all();
+        assert!(!tree.watcher.as_ref().unwrap().is_watching(&a));
+    }
+}
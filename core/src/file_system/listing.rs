@@ -0,0 +1,365 @@
+use crate::{FileIoManager, FileNode, FileSystemResult};
+use std::{
+    cmp::Ordering as CmpOrdering,
+    fs::{DirEntry, ReadDir},
+    io,
+    num::NonZeroUsize,
+    panic::{self, AssertUnwindSafe},
+    path::Path,
+    sync::{
+        Arc, Mutex, OnceLock,
+        atomic::{AtomicBool, Ordering},
+        mpsc::{self, Receiver, Sender, TryRecvError},
+    },
+    thread,
+};
+
+/// How many entries are read before they are converted and handed over as one batch.
+const BATCH_SIZE: usize = 1024;
+/// Batches with fewer entries than this are converted on a single thread.
+const PARALLEL_THRESHOLD: usize = 256;
+/// Most directories listed at once. Further listings wait in the pool's queue.
+const MAX_LISTING_WORKERS: usize = 4;
+
+type ListingJob = Box<dyn FnOnce() + Send>;
+
+/// Worker threads shared by every [`DirectoryListing`], so that expanding many directories at
+/// once queues them instead of starting a thread for each.
+struct ListingPool {
+    jobs: Sender<ListingJob>,
+}
+
+impl ListingPool {
+    /// Returns the pool, starting its workers on first use. `None` if no worker could be started.
+    fn shared() -> Option<&'static ListingPool> {
+        static POOL: OnceLock<Option<ListingPool>> = OnceLock::new();
+        POOL.get_or_init(Self::start).as_ref()
+    }
+
+    fn start() -> Option<Self> {
+        let (jobs, queue) = mpsc::channel::<ListingJob>();
+        let queue = Arc::new(Mutex::new(queue));
+        let workers = thread::available_parallelism()
+            .map_or(1, NonZeroUsize::get)
+            .min(MAX_LISTING_WORKERS);
+
+        let started = (0..workers)
+            .filter(|_| {
+                let queue = Arc::clone(&queue);
+
+                thread::Builder::new()
+                    .name("neko-directory-list".to_string())
+                    .spawn(move || {
+                        // The queue is only locked while waiting for the next job.
+                        while let Ok(job) = queue
+                            .lock()
+                            .map_err(drop)
+                            .and_then(|queue| queue.recv().map_err(drop))
+                        {
+                            // A panicking listing reports itself through its dropped sender;
+                            // the worker stays available to the others.
+                            _ = panic::catch_unwind(AssertUnwindSafe(job));
+                        }
+                    })
+                    .is_ok()
+            })
+            .count();
+
+        (started > 0).then_some(Self { jobs })
+    }
+}
+
+/// Output of a [`DirectoryListing`] worker, in the order it is produced.
+#[derive(Debug)]
+pub enum DirectoryListingEvent {
+    /// More children of the directory, sorted in display order among themselves.
+    Batch(Vec<FileNode>),
+    /// The listing is complete, or the error that stopped it.
+    Finished(FileSystemResult<()>),
+}
+
+/// A directory being listed on a worker of the shared listing pool.
+///
+/// Entries are converted to [`FileNode`]s in parallel and handed back in batches over a channel,
+/// so the owner can show children as they arrive by polling without blocking. Dropping the
+/// listing cancels it; the worker stops at its next entry.
+#[derive(Debug)]
+pub struct DirectoryListing {
+    events: Receiver<DirectoryListingEvent>,
+    cancelled: Arc<AtomicBool>,
+}
+
+impl DirectoryListing {
+    /// Opens `path` and queues it for listing on the shared pool.
+    ///
+    /// The directory is opened on the calling thread so that errors such as a missing directory
+    /// are reported immediately rather than through [`DirectoryListingEvent::Finished`].
+    pub fn spawn(path: &Path) -> io::Result<Self> {
+        let entries = FileIoManager::read_directory(path)?;
+        let parent_is_hidden = FileNode::path_is_hidden(path);
+        let pool = ListingPool::shared()
+            .ok_or_else(|| io::Error::other("no directory listing worker could be started"))?;
+
+        let (sender, events) = mpsc::channel();
+        let cancelled = Arc::new(AtomicBool::new(false));
+        let worker_cancelled = Arc::clone(&cancelled);
+
+        let job: ListingJob = Box::new(move || {
+            let result = Self::run(entries, parent_is_hidden, &worker_cancelled, |batch| {
+                // The receiver is gone if the listing was dropped, which is fine to ignore.
+                _ = sender.send(DirectoryListingEvent::Batch(batch));
+            });
+            _ = sender.send(DirectoryListingEvent::Finished(result));
+        });
+        pool.jobs
+            .send(job)
+            .map_err(|_| io::Error::other("directory listing workers exited"))?;
+
+        Ok(Self { events, cancelled })
+    }
+
+    fn run(
+        entries: ReadDir,
+        parent_is_hidden: bool,
+        cancelled: &AtomicBool,
+        mut on_batch: impl FnMut(Vec<FileNode>),
+    ) -> FileSystemResult<()> {
+        let mut pending = Vec::with_capacity(BATCH_SIZE);
+
+        for entry in entries {
+            if cancelled.load(Ordering::Relaxed) {
+                return Err(io::Error::other("directory listing cancelled").into());
+            }
+
+            // Skip entries that can't be read (e.g. removed mid-listing) instead of failing the
+            // whole listing.
+            let Ok(entry) = entry else {
+                continue;
+            };
+
+            pending.push(entry);
+
+            if pending.len() == BATCH_SIZE {
+                on_batch(convert_entries(&pending, parent_is_hidden));
+                pending.clear();
+            }
+        }
+
+        if !pending.is_empty() {
+            on_batch(convert_entries(&pending, parent_is_hidden));
+        }
+
+        Ok(())
+    }
+
+    /// Returns the next event from the worker without blocking, if there is one.
+    pub fn try_next(&self) -> Option<DirectoryListingEvent> {
+        match self.events.try_recv() {
+            Ok(event) => Some(event),
+            Err(TryRecvError::Empty) => None,
+            // The worker can only disconnect after sending `Finished`, unless it panicked.
+            Err(TryRecvError::Disconnected) => Some(DirectoryListingEvent::Finished(Err(
+                io::Error::other("directory listing worker exited unexpectedly").into(),
+            ))),
+        }
+    }
+}
+
+impl Drop for DirectoryListing {
+    fn drop(&mut self) {
+        self.cancelled.store(true, Ordering::Relaxed);
+    }
+}
+
+/// Lists `path` on the calling thread, for callers that need every child right away.
+pub fn list_directory(path: &Path) -> FileSystemResult<Vec<FileNode>> {
+    let parent_is_hidden = FileNode::path_is_hidden(path);
+    let entries: Vec<DirEntry> = FileIoManager::read_directory(path)?
+        .filter_map(Result::ok)
+        .collect();
+
+    Ok(convert_entries(&entries, parent_is_hidden))
+}
+
+/// Merges `batch`, sorted in display order, into the already sorted `children`.
+pub fn merge_batch(children: &mut Vec<FileNode>, batch: Vec<FileNode>) {
+    let is_after_children = match (children.last(), batch.first()) {
+        (Some(last), Some(first)) => last.cmp_display_order(first) != CmpOrdering::Greater,
+        _ => true,
+    };
+
+    if is_after_children {
+        children.extend(batch);
+        return;
+    }
+
+    let existing = std::mem::take(children);
+    children.reserve(existing.len() + batch.len());
+
+    let mut existing = existing.into_iter().peekable();
+    let mut batch = batch.into_iter().peekable();
+
+    while let (Some(old), Some(new)) = (existing.peek(), batch.peek()) {
+        // Ties keep the existing node first, as a stable sort would.
+        let next = if new.cmp_display_order(old) == CmpOrdering::Less {
+            batch.next()
+        } else {
+            existing.next()
+        };
+        children.extend(next);
+    }
+
+    children.extend(existing);
+    children.extend(batch);
+}
+
+/// Converts `entries` into nodes sorted in display order, splitting large batches across threads.
+/// Entries that fail to convert are skipped.
+fn convert_entries(entries: &[DirEntry], parent_is_hidden: bool) -> Vec<FileNode> {
+    let convert = |entries: &[DirEntry]| -> Vec<FileNode> {
+        entries
+            .iter()
+            // Actual depth will be updated later.
+            .filter_map(|entry| FileNode::from_entry(entry, 1, parent_is_hidden).ok())
+            .collect()
+    };
+
+    let workers = thread::available_parallelism().map_or(1, NonZeroUsize::get);
+    let mut nodes = if workers == 1 || entries.len() < PARALLEL_THRESHOLD {
+        convert(entries)
+    } else {
+        thread::scope(|scope| {
+            let handles: Vec<_> = entries
+                .chunks(entries.len().div_ceil(workers))
+                .map(|chunk| scope.spawn(move || convert(chunk)))
+                .collect();
+
+            handles
+                .into_iter()
+                .flat_map(|handle| handle.join().unwrap_or_default())
+                .collect()
+        })
+    };
+
+    nodes.sort_by(FileNode::cmp_display_order);
+    nodes
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_utils::TempDir;
+    use std::{fs, time::Duration};
+
+    #[test]
+    fn lists_directory_in_batches_on_worker_thread() {
+        let directory = TempDir::new("directory_listing");
+        fs::create_dir_all(directory.join(".hidden")).unwrap();
+        for index in 0..BATCH_SIZE + 10 {
+            fs::write(directory.join(format!("file_{index:05}.txt")), "").unwrap();
+        }
+
+        let listing = DirectoryListing::spawn(&directory).unwrap();
+        let mut nodes = Vec::new();
+        let mut batches = 0;
+
+        loop {
+            match listing.try_next() {
+                Some(DirectoryListingEvent::Batch(batch)) => {
+                    batches += 1;
+                    nodes.extend(batch);
+                }
+                Some(DirectoryListingEvent::Finished(result)) => break result.unwrap(),
+                None => thread::sleep(Duration::from_millis(1)),
+            }
+        }
+
+        assert_eq!(batches, 2);
+        assert_eq!(nodes.len(), BATCH_SIZE + 11);
+        // Only the dot directory is hidden, and it is listed without a stat.
+        let hidden: Vec<&FileNode> = nodes.iter().filter(|node| node.is_hidden).collect();
+        assert_eq!(hidden.len(), 1);
+        assert!(hidden[0].is_dir && hidden[0].modified == 0);
+    }
+
+    #[test]
+    fn sorts_directories_first_then_by_name() {
+        let directory = TempDir::new("directory_listing_sorted");
+        fs::create_dir_all(directory.join("zeta")).unwrap();
+        fs::write(directory.join("Beta.txt"), "").unwrap();
+        fs::write(directory.join("alpha.txt"), "").unwrap();
+
+        let names: Vec<String> = list_directory(&directory)
+            .unwrap()
+            .into_iter()
+            .map(|node| node.name)
+            .collect();
+
+        assert_eq!(names, ["zeta", "alpha.txt", "Beta.txt"]);
+    }
+
+    #[test]
+    fn merges_sorted_batches_into_sorted_children() {
+        let node = |name: &str, is_dir: bool| {
+            let mut node = FileNode::placeholder(Path::new("/root"), 0);
+            node.name = name.to_string();
+            node.is_dir = is_dir;
+            node
+        };
+        let names = |nodes: &[FileNode]| -> Vec<String> {
+            nodes.iter().map(|node| node.name.clone()).collect()
+        };
+
+        let mut children = vec![
+            node("src", true),
+            node("b.txt", false),
+            node("d.txt", false),
+        ];
+        merge_batch(
+            &mut children,
+            vec![
+                node("assets", true),
+                node("a.txt", false),
+                node("C.txt", false),
+            ],
+        );
+        assert_eq!(
+            names(&children),
+            ["assets", "src", "a.txt", "b.txt", "C.txt", "d.txt"]
+        );
+
+        // A batch that sorts after everything is appended as is.
+        merge_batch(&mut children, vec![node("e.txt", false)]);
+        merge_batch(&mut children, Vec::new());
+        assert_eq!(names(&children).last().unwrap(), "e.txt");
+        assert_eq!(children.len(), 7);
+    }
+
+    #[test]
+    fn queues_more_listings_than_workers() {
+        let directories: Vec<TempDir> = (0..MAX_LISTING_WORKERS * 3)
+            .map(|index| {
+                let directory = TempDir::new(&format!("directory_listing_queue_{index}"));
+                fs::write(directory.join("file.txt"), "").unwrap();
+                directory
+            })
+            .collect();
+
+        let listings: Vec<DirectoryListing> = directories
+            .iter()
+            .map(|directory| DirectoryListing::spawn(directory).unwrap())
+            .collect();
+
+        for listing in &listings {
+            let mut listed = 0;
+            loop {
+                match listing.try_next() {
+                    Some(DirectoryListingEvent::Batch(batch)) => listed += batch.len(),
+                    Some(DirectoryListingEvent::Finished(result)) => break result.unwrap(),
+                    None => thread::sleep(Duration::from_millis(1)),
+                }
+            }
+            assert_eq!(listed, 1);
+        }
+    }
+}
@@ -1,10 +1,14 @@
 pub mod error;
 pub mod file_tree;
+mod listing;
 mod operations;
 pub mod result;
 mod types;
+mod visible;
+mod watcher;
 
 pub use error::*;
 pub use file_tree::FileTree;
 pub use result::*;
 pub use types::FileNode;
+pub use watcher::{FileChange, FileWatcher, WatchKind};
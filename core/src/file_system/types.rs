@@ -1,5 +1,15 @@
 use crate::{FileSystemError, FileSystemResult};
-use std::{fs::DirEntry, os::unix::ffi::OsStrExt, path::PathBuf, time::UNIX_EPOCH};
+use std::{
+    cmp::Ordering,
+    fs::DirEntry,
+    os::unix::ffi::OsStrExt,
+    path::{Path, PathBuf},
+    time::UNIX_EPOCH,
+};
+
+/// Last path component of the row shown while a directory's children are being listed. The NUL
+/// byte keeps its path from ever matching a real entry.
+const PLACEHOLDER_FILE_NAME: &str = "\0loading";
 
 /// Represents a node within a [`super::FileTree`], containing various info like the node path,
 /// name, size, whether it's a directory, etc.
@@ -13,40 +23,51 @@ pub struct FileNode {
     pub is_dir: bool,
     /// Indicates whether the `FileNode` is considered hidden.
     pub is_hidden: bool,
-    /// The size of the `FileNode`.
+    /// The size of the `FileNode`. Always 0 for directories, which are listed without a stat.
     pub size: u64,
-    /// The modified date of the `FileNode`.
+    /// The modified date of the `FileNode`. Always 0 for directories, which are listed without a
+    /// stat.
     pub modified: u64,
     /// The "depth" of the `FileNode`, e.g. how nested it is within the folder structure of the [`super::FileTree`].
     pub depth: usize,
+    /// Indicates whether the `FileNode` is the "Loading…" row standing in for the children of a
+    /// directory that is still being listed, rather than a real entry.
+    pub is_placeholder: bool,
 }
 
 impl FileNode {
     /// Converts a `DirEntry` into a new `FileNode` result.
-    pub fn from_entry(entry: DirEntry, depth: usize) -> FileSystemResult<Self> {
+    ///
+    /// `parent_is_hidden` is whether the directory being listed is hidden (see
+    /// [`FileNode::path_is_hidden`]), so that each entry only has to check its own name. The entry
+    /// type usually comes straight from the directory listing, so only files need a stat.
+    pub fn from_entry(
+        entry: &DirEntry,
+        depth: usize,
+        parent_is_hidden: bool,
+    ) -> FileSystemResult<Self> {
         let path = entry.path();
-        let metadata = entry.metadata()?;
         let name = path
             .file_name()
             .ok_or(FileSystemError::MissingName)?
             .to_string_lossy()
             .into_owned();
 
-        let is_dir = metadata.is_dir();
+        let is_dir = entry.file_type()?.is_dir();
+        let is_hidden = parent_is_hidden || name.starts_with('.');
 
-        // A path is considered hidden if any ancestor starts with '.'
-        let is_hidden = path.ancestors().any(|a| {
-            a.file_name()
-                .map(|n| n.as_bytes().first() == Some(&b'.'))
-                .unwrap_or(false)
-        });
+        let (size, modified) = if is_dir {
+            (0, 0)
+        } else {
+            let metadata = entry.metadata()?;
+            let modified = metadata
+                .modified()?
+                .duration_since(UNIX_EPOCH)
+                .map_err(FileSystemError::BadSystemTime)?
+                .as_secs();
 
-        let size = metadata.len();
-        let modified = metadata
-            .modified()?
-            .duration_since(UNIX_EPOCH)
-            .map_err(FileSystemError::BadSystemTime)?
-            .as_secs();
+            (metadata.len(), modified)
+        };
 
         Ok(FileNode {
             path,
@@ -56,6 +77,40 @@ impl FileNode {
             size,
             modified,
             depth,
+            is_placeholder: false,
+        })
+    }
+
+    /// Creates the row shown in place of `directory_path`'s children while they are being listed.
+    pub fn placeholder(directory_path: &Path, depth: usize) -> Self {
+        FileNode {
+            path: directory_path.join(PLACEHOLDER_FILE_NAME),
+            name: "Loading…".to_string(),
+            is_dir: false,
+            is_hidden: false,
+            size: 0,
+            modified: 0,
+            depth,
+            is_placeholder: true,
+        }
+    }
+
+    /// Returns `true` if the path or any of its ancestors starts with '.'.
+    pub fn path_is_hidden(path: &Path) -> bool {
+        path.ancestors().any(|ancestor| {
+            ancestor
+                .file_name()
+                .is_some_and(|name| name.as_bytes().first() == Some(&b'.'))
+        })
+    }
+
+    /// Orders nodes as the tree displays them: directories first, then by case-insensitive name.
+    pub fn cmp_display_order(&self, other: &Self) -> Ordering {
+        other.is_dir.cmp(&self.is_dir).then_with(|| {
+            self.name
+                .chars()
+                .flat_map(char::to_lowercase)
+                .cmp(other.name.chars().flat_map(char::to_lowercase))
         })
     }
 
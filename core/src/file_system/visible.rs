@@ -0,0 +1,306 @@
+use crate::FileNode;
+use std::{
+    collections::HashMap,
+    ops::Range,
+    path::{Path, PathBuf},
+};
+
+/// Preferred number of rows per chunk of [`VisibleNodes`].
+const CHUNK_LEN: usize = 512;
+
+/// The flattened, visible rows of a [`super::FileTree`], in display order.
+///
+/// Rows are stored in chunks of roughly [`CHUNK_LEN`], so splicing a directory's children in or out
+/// only moves the chunks the splice touches, and the rows after it shift by renumbering chunk
+/// starts rather than nodes. Each path maps to its chunk and offset, so looking up a row by path
+/// stays constant time however often rows above it shift.
+#[derive(Debug, Default)]
+pub struct VisibleNodes {
+    chunks: Vec<Chunk>,
+    /// Row of the first node of each chunk.
+    starts: Vec<usize>,
+    /// Position in `chunks` of each chunk id.
+    chunk_positions: HashMap<u64, usize>,
+    /// Chunk id and offset within it of every visible path.
+    locations: HashMap<PathBuf, (u64, usize)>,
+    next_chunk_id: u64,
+    len: usize,
+}
+
+#[derive(Debug)]
+struct Chunk {
+    /// Stays the same while the chunk's nodes do, so `locations` only change for spliced chunks.
+    id: u64,
+    nodes: Vec<FileNode>,
+}
+
+impl VisibleNodes {
+    pub fn from_nodes(nodes: Vec<FileNode>) -> Self {
+        let mut visible = Self::default();
+        visible.splice(0..0, nodes);
+        visible
+    }
+
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn get(&self, row: usize) -> Option<&FileNode> {
+        if row >= self.len {
+            return None;
+        }
+
+        let (chunk, offset) = self.locate(row);
+        self.chunks[chunk].nodes.get(offset)
+    }
+
+    /// Returns the row of the node with the given path, if it is visible.
+    pub fn index_of(&self, path: &Path) -> Option<usize> {
+        let (id, offset) = self.locations.get(path)?;
+        let chunk = self.chunk_positions[id];
+
+        Some(self.starts[chunk] + offset)
+    }
+
+    pub fn iter(&self) -> impl DoubleEndedIterator<Item = &FileNode> {
+        self.range(0..self.len)
+    }
+
+    /// Iterates over the nodes in `rows`, clamped to the visible rows.
+    pub fn range(&self, rows: Range<usize>) -> impl DoubleEndedIterator<Item = &FileNode> {
+        let end = rows.end.min(self.len);
+        let start = rows.start.min(end);
+
+        let (chunks, first, last) = if start < end {
+            let (first_chunk, first_offset) = self.locate(start);
+            let (last_chunk, last_offset) = self.locate(end - 1);
+            (
+                first_chunk..last_chunk + 1,
+                (first_chunk, first_offset),
+                (last_chunk, last_offset),
+            )
+        } else {
+            (0..0, (0, 0), (0, 0))
+        };
+
+        self.chunks[chunks.clone()]
+            .iter()
+            .zip(chunks)
+            .flat_map(move |(chunk, index)| {
+                let from = if index == first.0 { first.1 } else { 0 };
+                let to = if index == last.0 {
+                    last.1 + 1
+                } else {
+                    chunk.nodes.len()
+                };
+
+                chunk.nodes[from..to].iter()
+            })
+    }
+
+    /// Replaces the nodes in `rows` with `nodes`.
+    ///
+    /// Only the chunks overlapping `rows` are rebuilt, along with a small neighbour when the result
+    /// would otherwise leave a runt chunk behind.
+    pub fn splice(&mut self, rows: Range<usize>, nodes: Vec<FileNode>) {
+        let end = rows.end.min(self.len);
+        let start = rows.start.min(end);
+
+        if self.chunks.is_empty() {
+            self.insert_chunks(0..0, nodes);
+            return;
+        }
+
+        // The chunks to rebuild: the one holding `start` (or the last one, when appending)
+        // through the one holding the last removed row.
+        let (first_chunk, start_offset) = if start == self.len {
+            let last = self.chunks.len() - 1;
+            (last, self.chunks[last].nodes.len())
+        } else {
+            self.locate(start)
+        };
+        let (mut last_chunk, end_offset) = if end > start {
+            let (chunk, offset) = self.locate(end - 1);
+            (chunk, offset + 1)
+        } else {
+            (first_chunk, start_offset)
+        };
+
+        let mut joined = Vec::with_capacity(start_offset + nodes.len() + CHUNK_LEN);
+        let mut tail = Vec::new();
+
+        for index in first_chunk..=last_chunk {
+            let chunk = std::mem::take(&mut self.chunks[index].nodes);
+
+            for (offset, node) in chunk.into_iter().enumerate() {
+                let is_before = index == first_chunk && offset < start_offset;
+                let is_after = index == last_chunk && offset >= end_offset;
+
+                if is_before {
+                    joined.push(node);
+                } else if is_after {
+                    tail.push(node);
+                } else {
+                    self.locations.remove(&node.path);
+                }
+            }
+        }
+
+        joined.extend(nodes);
+        joined.append(&mut tail);
+
+        while joined.len() < CHUNK_LEN / 2 && last_chunk + 1 < self.chunks.len() {
+            last_chunk += 1;
+            joined.append(&mut self.chunks[last_chunk].nodes);
+        }
+
+        for chunk in &self.chunks[first_chunk..=last_chunk] {
+            self.chunk_positions.remove(&chunk.id);
+        }
+
+        self.insert_chunks(first_chunk..last_chunk + 1, joined);
+    }
+
+    /// Replaces the chunks in `replaced` with `nodes`, cut into new chunks, and renumbers the rest.
+    ///
+    /// The nodes are cut evenly, so that every chunk but the last holds at least half of
+    /// [`CHUNK_LEN`].
+    fn insert_chunks(&mut self, replaced: Range<usize>, nodes: Vec<FileNode>) {
+        let mut new_chunks = Vec::new();
+        let mut remaining = nodes.len();
+        let mut nodes = nodes.into_iter();
+
+        for chunks_left in (1..=remaining.div_ceil(CHUNK_LEN)).rev() {
+            let id = self.next_chunk_id;
+            self.next_chunk_id += 1;
+
+            let size = remaining.div_ceil(chunks_left);
+            remaining -= size;
+
+            let chunk_nodes: Vec<FileNode> = nodes.by_ref().take(size).collect();
+            for (offset, node) in chunk_nodes.iter().enumerate() {
+                self.locations.insert(node.path.clone(), (id, offset));
+            }
+
+            new_chunks.push(Chunk {
+                id,
+                nodes: chunk_nodes,
+            });
+        }
+
+        let first = replaced.start;
+        self.chunks.splice(replaced, new_chunks);
+        self.reindex(first);
+    }
+
+    /// Recomputes the starts and positions of the chunks from `first` on.
+    fn reindex(&mut self, first: usize) {
+        self.starts.truncate(first);
+        let mut row = if first == 0 {
+            0
+        } else {
+            self.starts[first - 1] + self.chunks[first - 1].nodes.len()
+        };
+
+        for (index, chunk) in self.chunks.iter().enumerate().skip(first) {
+            self.starts.push(row);
+            self.chunk_positions.insert(chunk.id, index);
+            row += chunk.nodes.len();
+        }
+
+        self.len = row;
+    }
+
+    /// Returns the chunk holding `row` and the row's offset within it. `row` must be visible.
+    fn locate(&self, row: usize) -> (usize, usize) {
+        let chunk = self.starts.partition_point(|&start| start <= row) - 1;
+        (chunk, row - self.starts[chunk])
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::collections::HashSet;
+
+    fn nodes(prefix: &str, count: usize) -> Vec<FileNode> {
+        (0..count)
+            .map(|index| FileNode::placeholder(&Path::new(prefix).join(index.to_string()), 0))
+            .collect()
+    }
+
+    fn assert_matches(visible: &VisibleNodes, expected: &[FileNode]) {
+        let paths: Vec<&Path> = visible.iter().map(|node| node.path.as_path()).collect();
+        let expected_paths: Vec<&Path> = expected.iter().map(|node| node.path.as_path()).collect();
+        assert_eq!(paths, expected_paths);
+        assert_eq!(visible.len(), expected.len());
+
+        for (row, node) in expected.iter().enumerate() {
+            assert_eq!(visible.index_of(&node.path), Some(row));
+            assert_eq!(visible.get(row).unwrap().path, node.path);
+        }
+    }
+
+    #[test]
+    fn splices_match_a_flat_list_across_chunks() {
+        let mut expected = nodes("/root", CHUNK_LEN * 3 + 7);
+        let original = expected.clone();
+        let mut visible = VisibleNodes::from_nodes(expected.clone());
+        assert_matches(&visible, &expected);
+
+        let edits = [
+            (10, 10, nodes("/insert_small", 5)),
+            (
+                CHUNK_LEN - 3,
+                CHUNK_LEN + 20,
+                nodes("/across", CHUNK_LEN * 2),
+            ),
+            (100, CHUNK_LEN * 2 + 50, Vec::new()),
+            (0, 0, nodes("/front", 3)),
+            (expected.len(), expected.len(), nodes("/back", 40)),
+            (5, 6, Vec::new()),
+        ];
+
+        for (start, end, inserted) in edits {
+            let end = end.min(expected.len());
+            let start = start.min(end);
+            expected.splice(start..end, inserted.clone());
+            visible.splice(start..end, inserted);
+
+            assert_matches(&visible, &expected);
+        }
+
+        // Removed paths can't be looked up anymore.
+        let kept: HashSet<&Path> = expected.iter().map(|node| node.path.as_path()).collect();
+        for node in original
+            .iter()
+            .filter(|node| !kept.contains(node.path.as_path()))
+        {
+            assert!(visible.index_of(&node.path).is_none());
+        }
+    }
+
+    #[test]
+    fn ranges_clamp_and_run_both_ways() {
+        let all = nodes("/root", CHUNK_LEN + 10);
+        let visible = VisibleNodes::from_nodes(all.clone());
+
+        let forward: Vec<&Path> = visible
+            .range(CHUNK_LEN - 2..CHUNK_LEN + 2)
+            .map(|node| node.path.as_path())
+            .collect();
+        let expected: Vec<&Path> = all[CHUNK_LEN - 2..CHUNK_LEN + 2]
+            .iter()
+            .map(|node| node.path.as_path())
+            .collect();
+        assert_eq!(forward, expected);
+
+        let backward = visible.range(0..3).next_back().unwrap();
+        assert_eq!(backward.path, all[2].path);
+
+        assert_eq!(visible.range(all.len() - 1..usize::MAX).count(), 1);
+        let (start, end) = (5, 2);
+        assert_eq!(visible.range(start..end).count(), 0);
+        assert_eq!(VisibleNodes::default().iter().count(), 0);
+    }
+}
@@ -0,0 +1,301 @@
+use crc32fast::Hasher;
+use std::{
+    collections::{HashMap, HashSet},
+    fs::{self, File},
+    io::{self, Read},
+    path::{Path, PathBuf},
+    sync::{
+        Arc, Mutex, MutexGuard, PoisonError,
+        atomic::{AtomicBool, Ordering},
+        mpsc::{self, Receiver},
+    },
+    thread,
+    time::{Duration, Instant, SystemTime},
+};
+
+/// How often the watched paths are checked.
+const POLL_INTERVAL: Duration = Duration::from_millis(250);
+/// Changes are held back until a check finds nothing new, but never for longer than this, so a
+/// path that keeps changing is still reported.
+const MAX_DEBOUNCE: Duration = Duration::from_secs(2);
+
+/// What a watched path is, which decides what is reported when it changes.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum WatchKind {
+    /// Reported when entries are added to, removed from or renamed in the directory.
+    Directory,
+    /// Reported along with a checksum of the new content, so that owners can tell their own
+    /// writes apart from external ones.
+    File,
+}
+
+/// A watched path that changed on disk.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct FileChange {
+    pub path: PathBuf,
+    /// The CRC32 of a [`WatchKind::File`]'s new content. `None` for directories, and for files
+    /// that were removed or can't be read.
+    pub checksum: Option<u32>,
+}
+
+/// The metadata that changes along with a path: its modification time and size, or `None` if
+/// the path doesn't exist.
+type Stamp = Option<(Option<SystemTime>, u64)>;
+
+#[derive(Debug)]
+struct Watch {
+    kind: WatchKind,
+    stamp: Stamp,
+}
+
+/// Watches files and directories for changes made on disk, by checking their metadata from a
+/// worker thread.
+///
+/// A directory's modification time changes whenever an entry is added, removed or renamed in it,
+/// so each check costs one stat per watched path. Changes are debounced, so a burst of writes is
+/// reported once. Dropping the watcher stops the worker.
+#[derive(Debug)]
+pub struct FileWatcher {
+    watches: Arc<Mutex<HashMap<PathBuf, Watch>>>,
+    changes: Receiver<Vec<FileChange>>,
+    stopped: Arc<AtomicBool>,
+}
+
+impl FileWatcher {
+    pub fn spawn() -> io::Result<Self> {
+        Self::spawn_with_interval(POLL_INTERVAL)
+    }
+
+    fn spawn_with_interval(interval: Duration) -> io::Result<Self> {
+        let watches = Arc::new(Mutex::new(HashMap::new()));
+        let stopped = Arc::new(AtomicBool::new(false));
+        let (sender, changes) = mpsc::channel();
+
+        let worker_watches = Arc::clone(&watches);
+        let worker_stopped = Arc::clone(&stopped);
+
+        thread::Builder::new()
+            .name("neko-file-watcher".to_string())
+            .spawn(move || {
+                let mut pending = HashSet::new();
+                let mut pending_since = None;
+
+                while !worker_stopped.load(Ordering::Relaxed) {
+                    thread::sleep(interval);
+
+                    let changed = Self::check(&worker_watches);
+                    let now = Instant::now();
+                    let is_quiet = changed.is_empty();
+
+                    if !is_quiet {
+                        pending_since.get_or_insert(now);
+                        pending.extend(changed);
+                    }
+
+                    let waited_too_long = pending_since
+                        .is_some_and(|since: Instant| now.duration_since(since) >= MAX_DEBOUNCE);
+
+                    if !pending.is_empty() && (is_quiet || waited_too_long) {
+                        let batch = Self::describe(&worker_watches, pending.drain());
+                        pending_since = None;
+
+                        // The receiver is gone once the watcher is dropped.
+                        if !batch.is_empty() && sender.send(batch).is_err() {
+                            break;
+                        }
+                    }
+                }
+            })?;
+
+        Ok(Self {
+            watches,
+            changes,
+            stopped,
+        })
+    }
+
+    /// Starts watching `path`, or resets its baseline if it is already watched, so that only
+    /// changes made from now on are reported.
+    pub fn watch(&self, path: &Path, kind: WatchKind) {
+        let watch = Watch {
+            kind,
+            stamp: stamp(path),
+        };
+
+        lock(&self.watches).insert(path.to_path_buf(), watch);
+    }
+
+    pub fn unwatch(&self, path: &Path) {
+        lock(&self.watches).remove(path);
+    }
+
+    pub fn is_watching(&self, path: &Path) -> bool {
+        lock(&self.watches).contains_key(path)
+    }
+
+    /// Returns the changes reported since the last call, without blocking.
+    pub fn try_changes(&self) -> Vec<FileChange> {
+        self.changes.try_iter().flatten().collect()
+    }
+
+    /// Stats every watched path and returns the ones that changed since the previous check.
+    fn check(watches: &Mutex<HashMap<PathBuf, Watch>>) -> Vec<PathBuf> {
+        // Stat without holding the lock, so `watch` calls are never kept waiting on the disk.
+        let recorded: Vec<(PathBuf, Stamp)> = lock(watches)
+            .iter()
+            .map(|(path, watch)| (path.clone(), watch.stamp))
+            .collect();
+        let changed: Vec<(PathBuf, Stamp, Stamp)> = recorded
+            .into_iter()
+            .filter_map(|(path, old)| {
+                let new = stamp(&path);
+                (new != old).then_some((path, old, new))
+            })
+            .collect();
+
+        let mut watches = lock(watches);
+
+        changed
+            .into_iter()
+            .filter_map(|(path, old, new)| {
+                let watch = watches.get_mut(&path)?;
+
+                // Skip paths that were re-watched, with a new baseline, while being checked.
+                if watch.stamp != old {
+                    return None;
+                }
+
+                watch.stamp = new;
+                Some(path)
+            })
+            .collect()
+    }
+
+    /// Turns changed paths into [`FileChange`]s, dropping any that stopped being watched.
+    fn describe(
+        watches: &Mutex<HashMap<PathBuf, Watch>>,
+        paths: impl Iterator<Item = PathBuf>,
+    ) -> Vec<FileChange> {
+        let paths: Vec<(PathBuf, WatchKind)> = {
+            let watches = lock(watches);
+            paths
+                .filter_map(|path| {
+                    let kind = watches.get(&path)?.kind;
+                    Some((path, kind))
+                })
+                .collect()
+        };
+
+        paths
+            .into_iter()
+            .map(|(path, kind)| {
+                let checksum = match kind {
+                    WatchKind::Directory => None,
+                    WatchKind::File => checksum(&path).ok(),
+                };
+
+                FileChange { path, checksum }
+            })
+            .collect()
+    }
+}
+
+impl Drop for FileWatcher {
+    fn drop(&mut self) {
+        self.stopped.store(true, Ordering::Relaxed);
+    }
+}
+
+fn lock<T>(mutex: &Mutex<T>) -> MutexGuard<'_, T> {
+    mutex.lock().unwrap_or_else(PoisonError::into_inner)
+}
+
+fn stamp(path: &Path) -> Stamp {
+    fs::metadata(path)
+        .ok()
+        .map(|metadata| (metadata.modified().ok(), metadata.len()))
+}
+
+/// Hashes the file at `path` the same way [`crate::Buffer::checksum`] hashes its content.
+fn checksum(path: &Path) -> io::Result<u32> {
+    let mut file = File::open(path)?;
+    let mut hasher = Hasher::new();
+    let mut chunk = vec![0; 64 * 1024];
+
+    loop {
+        match file.read(&mut chunk) {
+            Ok(0) => return Ok(hasher.finalize()),
+            Ok(read) => hasher.update(&chunk[..read]),
+            Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+            Err(error) => return Err(error),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_utils::TempDir;
+
+    fn wait_for_changes(watcher: &FileWatcher) -> Vec<FileChange> {
+        let deadline = Instant::now() + Duration::from_secs(5);
+
+        loop {
+            let changes = watcher.try_changes();
+            if !changes.is_empty() || Instant::now() > deadline {
+                return changes;
+            }
+
+            thread::sleep(Duration::from_millis(5));
+        }
+    }
+
+    #[test]
+    fn reports_directory_and_file_changes() {
+        let directory = TempDir::new("file_watcher");
+        let file = directory.join("watched.txt");
+        fs::write(&file, "before").unwrap();
+
+        let watcher = FileWatcher::spawn_with_interval(Duration::from_millis(10)).unwrap();
+        watcher.watch(directory.path(), WatchKind::Directory);
+        watcher.watch(&file, WatchKind::File);
+
+        fs::write(directory.join("new.txt"), "").unwrap();
+        fs::write(&file, "after, and longer").unwrap();
+
+        let mut changes = wait_for_changes(&watcher);
+        // Both changes may not land in the same check.
+        if changes.len() < 2 {
+            changes.extend(wait_for_changes(&watcher));
+        }
+        changes.sort_by(|a, b| a.path.cmp(&b.path));
+
+        assert_eq!(
+            changes,
+            [
+                FileChange {
+                    path: directory.to_path_buf(),
+                    checksum: None,
+                },
+                FileChange {
+                    path: file.clone(),
+                    checksum: Some(crate::Buffer::from("after, and longer").checksum()),
+                },
+            ]
+        );
+    }
+
+    #[test]
+    fn ignores_unwatched_paths() {
+        let directory = TempDir::new("file_watcher_unwatched");
+
+        let watcher = FileWatcher::spawn_with_interval(Duration::from_millis(10)).unwrap();
+        watcher.watch(directory.path(), WatchKind::Directory);
+        watcher.unwatch(directory.path());
+
+        fs::write(directory.join("new.txt"), "").unwrap();
+        thread::sleep(Duration::from_millis(100));
+
+        assert!(watcher.try_changes().is_empty());
+    }
+}
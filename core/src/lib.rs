@@ -3,6 +3,7 @@ pub mod commands;
 pub mod config;
 mod ffi;
 pub mod file_system;
+pub mod session;
 pub mod shortcuts;
 pub mod tab;
 #[cfg(test)]
@@ -21,13 +22,16 @@ pub use commands::{
     run_file_explorer_command, run_tab_command, tab_command_state,
 };
 pub use config::{Config, ConfigManager};
-pub use file_system::{FileNode, FileTree, error::*, result::*};
+pub use file_system::{FileNode, FileTree, FileWatcher, WatchKind, error::*, result::*};
+pub use session::{SessionSnapshot, SessionStore, SessionTab};
 pub use shortcuts::{Shortcut, ShortcutsManager};
 pub use tab::{Tab, TabManager, error::*, types::*};
 use text::CursorManager;
 pub use text::{
     AddCursorDirection, Buffer, Change, ChangeSet, Cursor, CursorEntry, Document, DocumentId,
-    DocumentManager, DocumentResult, Editor, Selection, SelectionManager, View, ViewId,
-    ViewManager, Viewport, document::error::*, view::error::*,
+    DocumentLoad, DocumentLoadEvent, DocumentLoadStatus, DocumentLoadUpdate, DocumentManager,
+    DocumentReload, DocumentResult, DocumentSave, DocumentSaveUpdate, DocumentStub, Editor,
+    LoadProgress, MemoryUsage, SavePoint, Selection, SelectionManager, View, ViewId, ViewManager,
+    Viewport, document::error::*, view::error::*,
 };
 pub use theme::{Theme, ThemeManager};
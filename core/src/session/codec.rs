@@ -0,0 +1,387 @@
+//! The on-disk format of a [`SessionSnapshot`].
+//!
+//! A session is a fixed header (magic bytes and a format version), a payload of little-endian
+//! integers and length-prefixed UTF-8 paths, and a CRC-32 of the payload. It is a few kilobytes
+//! even for hundreds of tabs, so it is read with a single `read` and decoded in one pass.
+
+use super::{SessionSnapshot, SessionTab};
+use crate::{ClosedTabInfo, Cursor, CursorEntry, Selection};
+use std::{
+    io,
+    path::{Path, PathBuf},
+};
+
+const MAGIC: &[u8; 4] = b"NKSS";
+const VERSION: u32 = 1;
+const HEADER_LEN: usize = MAGIC.len() + size_of::<u32>();
+const CHECKSUM_LEN: usize = size_of::<u32>();
+
+/// Encodes `snapshot`. Paths are stored as UTF-8, lossily if they are not valid UTF-8.
+pub fn encode(snapshot: &SessionSnapshot) -> Vec<u8> {
+    let mut writer = Writer::default();
+    writer.bytes(MAGIC);
+    writer.u32(VERSION);
+
+    let payload_start = writer.buf.len();
+
+    writer.len(snapshot.tabs.len());
+    for tab in &snapshot.tabs {
+        writer.path(&tab.path);
+        writer.u8(tab.is_pinned as u8);
+        writer.i32(tab.scroll_offsets.0);
+        writer.i32(tab.scroll_offsets.1);
+        writer.cursors(&tab.cursors);
+        writer.selection(&tab.selection);
+        writer.u32(tab.checksum);
+        writer.usize(tab.line_count);
+        writer.u8(tab.modified as u8);
+    }
+
+    writer.optional_index(snapshot.active_tab);
+
+    writer.len(snapshot.closed_tabs.len());
+    for info in &snapshot.closed_tabs {
+        writer.path(&info.path);
+        writer.usize(info.scroll_offsets.0);
+        writer.usize(info.scroll_offsets.1);
+        writer.cursors(&info.cursors);
+        writer.selection(&info.selections);
+    }
+
+    writer.len(snapshot.history.len());
+    for &idx in &snapshot.history {
+        writer.usize(idx);
+    }
+
+    let checksum = crc32fast::hash(&writer.buf[payload_start..]);
+    writer.u32(checksum);
+
+    writer.buf
+}
+
+/// Decodes a session written by [`encode`]. Fails with [`io::ErrorKind::InvalidData`] if `bytes`
+/// are not a session of this version, or were damaged.
+pub fn decode(bytes: &[u8]) -> io::Result<SessionSnapshot> {
+    if bytes.len() < HEADER_LEN + CHECKSUM_LEN || &bytes[..MAGIC.len()] != MAGIC {
+        return Err(invalid_data("not a session file"));
+    }
+
+    let mut header = Reader::new(&bytes[MAGIC.len()..HEADER_LEN]);
+    let version = header.u32()?;
+    if version != VERSION {
+        return Err(invalid_data(format!(
+            "unsupported session version {version}"
+        )));
+    }
+
+    let (payload, checksum) = bytes[HEADER_LEN..].split_at(bytes.len() - HEADER_LEN - CHECKSUM_LEN);
+    if crc32fast::hash(payload) != Reader::new(checksum).u32()? {
+        return Err(invalid_data("session checksum mismatch"));
+    }
+
+    let mut reader = Reader::new(payload);
+
+    let tab_count = reader.len()?;
+    let mut tabs = Vec::with_capacity(tab_count);
+    for _ in 0..tab_count {
+        tabs.push(SessionTab {
+            path: reader.path()?,
+            is_pinned: reader.u8()? != 0,
+            scroll_offsets: (reader.i32()?, reader.i32()?),
+            cursors: reader.cursors()?,
+            selection: reader.selection()?,
+            checksum: reader.u32()?,
+            line_count: reader.usize()?,
+            modified: reader.u8()? != 0,
+        });
+    }
+
+    let active_tab = reader.optional_index()?;
+
+    let closed_count = reader.len()?;
+    let mut closed_tabs = Vec::with_capacity(closed_count);
+    for _ in 0..closed_count {
+        closed_tabs.push(ClosedTabInfo {
+            path: reader.path()?,
+            scroll_offsets: (reader.usize()?, reader.usize()?),
+            cursors: reader.cursors()?,
+            selections: reader.selection()?,
+        });
+    }
+
+    let history_len = reader.len()?;
+    let mut history = Vec::with_capacity(history_len);
+    for _ in 0..history_len {
+        history.push(reader.usize()?);
+    }
+
+    let entry_count = tabs.len() + closed_tabs.len();
+    if active_tab.is_some_and(|idx| idx >= tabs.len())
+        || history.iter().any(|&idx| idx >= entry_count)
+    {
+        return Err(invalid_data("session refers to a tab it does not contain"));
+    }
+
+    Ok(SessionSnapshot {
+        tabs,
+        active_tab,
+        closed_tabs,
+        history,
+    })
+}
+
+/// The checksum an encoded session ends with, which identifies its content. (A checksum of the
+/// whole encoding would not: with its own CRC appended, every payload has the same CRC.)
+pub fn checksum(encoded: &[u8]) -> u32 {
+    encoded
+        .last_chunk::<CHECKSUM_LEN>()
+        .map_or(0, |checksum| u32::from_le_bytes(*checksum))
+}
+
+fn invalid_data(message: impl Into<String>) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, message.into())
+}
+
+#[derive(Default)]
+struct Writer {
+    buf: Vec<u8>,
+}
+
+impl Writer {
+    fn bytes(&mut self, bytes: &[u8]) {
+        self.buf.extend_from_slice(bytes);
+    }
+
+    fn u8(&mut self, value: u8) {
+        self.buf.push(value);
+    }
+
+    fn u32(&mut self, value: u32) {
+        self.bytes(&value.to_le_bytes());
+    }
+
+    fn i32(&mut self, value: i32) {
+        self.bytes(&value.to_le_bytes());
+    }
+
+    fn u64(&mut self, value: u64) {
+        self.bytes(&value.to_le_bytes());
+    }
+
+    fn usize(&mut self, value: usize) {
+        self.u64(value as u64);
+    }
+
+    fn len(&mut self, len: usize) {
+        self.u32(u32::try_from(len).unwrap_or(u32::MAX));
+    }
+
+    /// Stored off by one, so that 0 means none.
+    fn optional_index(&mut self, idx: Option<usize>) {
+        self.u64(idx.map_or(0, |idx| idx as u64 + 1));
+    }
+
+    fn path(&mut self, path: &Path) {
+        let path = path.to_string_lossy();
+        self.len(path.len());
+        self.bytes(path.as_bytes());
+    }
+
+    fn cursor(&mut self, cursor: &Cursor) {
+        self.usize(cursor.row);
+        self.usize(cursor.column);
+        self.usize(cursor.sticky_column);
+    }
+
+    fn cursors(&mut self, cursors: &[CursorEntry]) {
+        self.len(cursors.len());
+        for entry in cursors {
+            self.u64(entry.id);
+            self.cursor(&entry.cursor);
+            self.optional_index(entry.column_group.map(|group| group as usize));
+        }
+    }
+
+    fn selection(&mut self, selection: &Selection) {
+        self.cursor(&selection.start);
+        self.cursor(&selection.end);
+        self.cursor(&selection.anchor);
+        self.u8(selection.is_active() as u8);
+    }
+}
+
+struct Reader<'a> {
+    bytes: &'a [u8],
+}
+
+impl<'a> Reader<'a> {
+    fn new(bytes: &'a [u8]) -> Self {
+        Self { bytes }
+    }
+
+    fn take<const N: usize>(&mut self) -> io::Result<[u8; N]> {
+        let (head, rest) = self
+            .bytes
+            .split_first_chunk::<N>()
+            .ok_or_else(|| invalid_data("session ends unexpectedly"))?;
+        self.bytes = rest;
+        Ok(*head)
+    }
+
+    fn u8(&mut self) -> io::Result<u8> {
+        Ok(self.take::<1>()?[0])
+    }
+
+    fn u32(&mut self) -> io::Result<u32> {
+        self.take().map(u32::from_le_bytes)
+    }
+
+    fn i32(&mut self) -> io::Result<i32> {
+        self.take().map(i32::from_le_bytes)
+    }
+
+    fn u64(&mut self) -> io::Result<u64> {
+        self.take().map(u64::from_le_bytes)
+    }
+
+    fn usize(&mut self) -> io::Result<usize> {
+        usize::try_from(self.u64()?).map_err(|_| invalid_data("session value out of range"))
+    }
+
+    /// A length or count. Every entry takes at least a byte, which bounds what is allocated for
+    /// a damaged count to the size of the file.
+    fn len(&mut self) -> io::Result<usize> {
+        let len = self.u32()? as usize;
+
+        if len > self.bytes.len() {
+            return Err(invalid_data("session ends unexpectedly"));
+        }
+
+        Ok(len)
+    }
+
+    fn optional_index(&mut self) -> io::Result<Option<usize>> {
+        Ok(self.usize()?.checked_sub(1))
+    }
+
+    fn path(&mut self) -> io::Result<PathBuf> {
+        let len = self.len()?;
+        let (path, rest) = self.bytes.split_at(len);
+        self.bytes = rest;
+
+        std::str::from_utf8(path)
+            .map(PathBuf::from)
+            .map_err(|_| invalid_data("session path is not valid UTF-8"))
+    }
+
+    fn cursor(&mut self) -> io::Result<Cursor> {
+        Ok(Cursor {
+            row: self.usize()?,
+            column: self.usize()?,
+            sticky_column: self.usize()?,
+        })
+    }
+
+    fn cursors(&mut self) -> io::Result<Vec<CursorEntry>> {
+        let count = self.len()?;
+        let mut cursors = Vec::with_capacity(count);
+
+        for _ in 0..count {
+            cursors.push(CursorEntry {
+                id: self.u64()?,
+                cursor: self.cursor()?,
+                column_group: self.optional_index()?.map(|group| group as u64),
+            });
+        }
+
+        Ok(cursors)
+    }
+
+    fn selection(&mut self) -> io::Result<Selection> {
+        Ok(Selection::from_parts(
+            self.cursor()?,
+            self.cursor()?,
+            self.cursor()?,
+            self.u8()? != 0,
+        ))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn cursor(row: usize, column: usize) -> Cursor {
+        Cursor {
+            row,
+            column,
+            sticky_column: column,
+        }
+    }
+
+    fn snapshot() -> SessionSnapshot {
+        let selection = Selection::from_parts(cursor(2, 0), cursor(4, 3), cursor(2, 0), true);
+
+        SessionSnapshot {
+            tabs: vec![
+                SessionTab {
+                    path: PathBuf::from("/tmp/pinned.rs"),
+                    is_pinned: true,
+                    scroll_offsets: (0, 1200),
+                    cursors: vec![
+                        CursorEntry::individual(0, &cursor(40, 7)),
+                        CursorEntry {
+                            id: 3,
+                            cursor: cursor(41, 7),
+                            column_group: Some(1),
+                        },
+                    ],
+                    selection,
+                    checksum: 0xDEAD_BEEF,
+                    line_count: 120,
+                    modified: false,
+                },
+                SessionTab {
+                    path: PathBuf::from("/tmp/other.rs"),
+                    is_pinned: false,
+                    scroll_offsets: (-1, 0),
+                    cursors: vec![CursorEntry::individual(0, &cursor(0, 0))],
+                    selection: Selection::new(),
+                    checksum: 0,
+                    line_count: 1,
+                    modified: true,
+                },
+            ],
+            active_tab: Some(1),
+            closed_tabs: vec![ClosedTabInfo {
+                path: PathBuf::from("/tmp/closed.rs"),
+                scroll_offsets: (5, 80),
+                cursors: vec![CursorEntry::individual(1, &cursor(9, 2))],
+                selections: Selection::new(),
+            }],
+            history: vec![2, 0, 1],
+        }
+    }
+
+    #[test]
+    fn decodes_what_it_encodes() {
+        let snapshot = snapshot();
+        let decoded = decode(&encode(&snapshot)).unwrap();
+
+        assert_eq!(decoded, snapshot);
+        assert!(decoded.tabs[0].selection.is_active());
+    }
+
+    #[test]
+    fn rejects_damaged_or_truncated_sessions() {
+        let bytes = encode(&snapshot());
+
+        let mut damaged = bytes.clone();
+        damaged[HEADER_LEN + 10] ^= 0xFF;
+        assert!(decode(&damaged).is_err());
+
+        assert!(decode(&bytes[..bytes.len() - 1]).is_err());
+        assert!(decode(b"NKSS").is_err());
+        assert!(decode(&[]).is_err());
+    }
+}
@@ -0,0 +1,6 @@
+pub mod codec;
+pub mod store;
+pub mod types;
+
+pub use store::SessionStore;
+pub use types::*;
@@ -0,0 +1,191 @@
+use super::{SessionSnapshot, codec};
+use crate::{ConfigManager, FileIoManager};
+use std::{
+    fs,
+    io::{self, Write},
+    path::{Path, PathBuf},
+    sync::mpsc::{self, Receiver, TryRecvError},
+    thread,
+};
+
+/// Saves the workspace to a session file and restores it at startup.
+///
+/// Saving is meant to be requested often. A snapshot identical to the last one written is not
+/// written again, and writes happen on a worker thread so the UI never waits on the disk.
+#[derive(Debug)]
+pub struct SessionStore {
+    path: PathBuf,
+    /// Checksum of the session file's content as of the last read or write, if known (see
+    /// [`codec::checksum`]).
+    written: Option<u32>,
+    /// The write in flight, with the checksum of what it writes.
+    save: Option<(Receiver<io::Result<()>>, u32)>,
+}
+
+impl Default for SessionStore {
+    fn default() -> Self {
+        Self::new(Self::default_path())
+    }
+}
+
+impl SessionStore {
+    pub fn new(path: PathBuf) -> Self {
+        Self {
+            path,
+            written: None,
+            save: None,
+        }
+    }
+
+    /// `session.bin`, next to the config file.
+    pub fn default_path() -> PathBuf {
+        ConfigManager::get_config_path().with_file_name("session.bin")
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    /// Reads the saved session. Returns `None` if there is none yet.
+    pub fn load(&mut self) -> io::Result<Option<SessionSnapshot>> {
+        let bytes = match fs::read(&self.path) {
+            Ok(bytes) => bytes,
+            Err(error) if error.kind() == io::ErrorKind::NotFound => return Ok(None),
+            Err(error) => return Err(error),
+        };
+
+        let snapshot = codec::decode(&bytes)?;
+        self.written = Some(codec::checksum(&bytes));
+
+        Ok(Some(snapshot))
+    }
+
+    /// Starts writing `snapshot` on a worker thread, unless it matches what was last written or
+    /// the previous write is still in flight (the next call picks the change up then). Returns
+    /// whether a write was started.
+    pub fn save_in_background(&mut self, snapshot: &SessionSnapshot) -> bool {
+        if !self.finish_save(false) {
+            return false;
+        }
+
+        let bytes = codec::encode(snapshot);
+        let checksum = codec::checksum(&bytes);
+        if self.written == Some(checksum) {
+            return false;
+        }
+
+        let (sender, result) = mpsc::channel();
+        let path = self.path.clone();
+
+        let spawned = thread::Builder::new()
+            .name("neko-session-save".to_string())
+            .spawn(move || {
+                let saved =
+                    FileIoManager::write_file_atomically(&path, |file| file.write_all(&bytes));
+                _ = sender.send(saved);
+            });
+
+        match spawned {
+            Ok(_) => {
+                self.save = Some((result, checksum));
+                true
+            }
+            Err(error) => {
+                eprintln!("Failed to start saving the session: {error}");
+                false
+            }
+        }
+    }
+
+    /// Writes `snapshot` before returning, e.g. when the app is about to quit. Waits for a write
+    /// in flight first, so it cannot land after this one.
+    pub fn save(&mut self, snapshot: &SessionSnapshot) -> io::Result<()> {
+        self.finish_save(true);
+
+        let bytes = codec::encode(snapshot);
+        let checksum = codec::checksum(&bytes);
+        if self.written == Some(checksum) {
+            return Ok(());
+        }
+
+        FileIoManager::write_file_atomically(&self.path, |file| file.write_all(&bytes))?;
+        self.written = Some(checksum);
+
+        Ok(())
+    }
+
+    /// Picks up the outcome of the write in flight, if any, waiting for it if `block` is set.
+    /// Returns whether no write is in flight anymore.
+    fn finish_save(&mut self, block: bool) -> bool {
+        let Some((result, checksum)) = &self.save else {
+            return true;
+        };
+
+        let outcome = if block {
+            result
+                .recv()
+                .unwrap_or_else(|_| Err(io::Error::other("session save worker exited")))
+        } else {
+            match result.try_recv() {
+                Ok(outcome) => outcome,
+                Err(TryRecvError::Empty) => return false,
+                Err(TryRecvError::Disconnected) => {
+                    Err(io::Error::other("session save worker exited"))
+                }
+            }
+        };
+
+        match outcome {
+            Ok(()) => self.written = Some(*checksum),
+            Err(error) => eprintln!("Failed to save the session: {error}"),
+        }
+        self.save = None;
+
+        true
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{SessionTab, test_utils::TempDir};
+    use std::time::Duration;
+
+    fn snapshot(path: &str) -> SessionSnapshot {
+        SessionSnapshot {
+            tabs: vec![SessionTab {
+                path: PathBuf::from(path),
+                is_pinned: false,
+                scroll_offsets: (0, 300),
+                cursors: Vec::new(),
+                selection: Default::default(),
+                checksum: 1,
+                line_count: 2,
+                modified: false,
+            }],
+            active_tab: Some(0),
+            ..Default::default()
+        }
+    }
+
+    #[test]
+    fn saves_in_background_only_when_the_session_changed() {
+        let directory = TempDir::new("session_store");
+        let path = directory.join("session.bin");
+        let mut store = SessionStore::new(path.clone());
+
+        assert!(store.load().unwrap().is_none());
+        assert!(store.save_in_background(&snapshot("/tmp/a.rs")));
+
+        while !store.finish_save(false) {
+            thread::sleep(Duration::from_millis(1));
+        }
+
+        assert!(!store.save_in_background(&snapshot("/tmp/a.rs")));
+        store.save(&snapshot("/tmp/b.rs")).unwrap();
+
+        let mut reopened = SessionStore::new(path.clone());
+        assert_eq!(reopened.load().unwrap(), Some(snapshot("/tmp/b.rs")));
+        assert!(!reopened.save_in_background(&snapshot("/tmp/b.rs")));
+    }
+}
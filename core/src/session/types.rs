@@ -0,0 +1,34 @@
+use crate::{ClosedTabInfo, CursorEntry, Selection};
+use std::path::PathBuf;
+
+/// The workspace as saved by [`super::SessionStore`]: the open tabs in order, the tabs that can
+/// still be reopened from history, and the history itself.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct SessionSnapshot {
+    pub tabs: Vec<SessionTab>,
+    /// Index into `tabs` of the active tab.
+    pub active_tab: Option<usize>,
+    pub closed_tabs: Vec<ClosedTabInfo>,
+    /// Tab activation history, oldest first. Each entry indexes `tabs`, or `closed_tabs` past the
+    /// end of `tabs`.
+    pub history: Vec<usize>,
+}
+
+/// An open tab in a [`SessionSnapshot`].
+#[derive(Debug, Clone, PartialEq)]
+pub struct SessionTab {
+    pub path: PathBuf,
+    pub is_pinned: bool,
+    pub scroll_offsets: (i32, i32),
+    pub cursors: Vec<CursorEntry>,
+    pub selection: Selection,
+    /// Checksum of the content the cursors refer to, which tells whether they still apply once
+    /// the file is read again.
+    pub checksum: u32,
+    /// Line count of that content, to lay the view out with before the file is read.
+    pub line_count: usize,
+    /// Whether the tab had unsaved edits. They are not part of the session, so `checksum` is of
+    /// the saved content while `line_count` is of the edited one, and the tab has no cursors. It
+    /// is reloaded as changed.
+    pub modified: bool,
+}
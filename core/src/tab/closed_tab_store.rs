@@ -7,8 +7,6 @@ pub struct ClosedTabStore {
 }
 
 impl ClosedTabStore {
-    // TODO(scarlet): Add session restoration persistance? E.g. allowing history navigation even if
-    // history is empty by reopening past tabs
     pub fn record_closed_tabs<F>(&mut self, ids: &[TabId], mut get_tab_info: F)
     where
         F: FnMut(TabId) -> Option<ClosedTabInfo>,
@@ -34,4 +32,12 @@ impl ClosedTabStore {
     pub fn has(&self, id: TabId) -> bool {
         self.closed_tabs.contains_key(&id)
     }
+
+    pub fn insert(&mut self, id: TabId, info: ClosedTabInfo) {
+        self.closed_tabs.insert(id, info);
+    }
+
+    pub fn iter(&self) -> impl Iterator<Item = (TabId, &ClosedTabInfo)> {
+        self.closed_tabs.iter().map(|(&id, info)| (id, info))
+    }
 }
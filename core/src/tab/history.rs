@@ -26,6 +26,17 @@ impl TabHistoryManager {
             .rposition(|&id| predicate(id))
     }
 
+    /// Activated tab ids, oldest first.
+    pub fn ids(&self) -> &[TabId] {
+        &self.active_tab_history
+    }
+
+    /// Replaces the whole history, e.g. with one restored from a saved session.
+    pub fn replace(&mut self, ids: Vec<TabId>) {
+        self.active_tab_history = ids;
+        self.history_pos = None;
+    }
+
     pub fn id_at(&self, idx: usize) -> TabId {
         self.active_tab_history[idx]
     }
@@ -1,4 +1,7 @@
-use std::path::Path;
+use std::{
+    collections::{HashMap, HashSet},
+    path::Path,
+};
 
 use super::{ClosedTabStore, TabHistoryManager};
 use crate::{
@@ -19,6 +22,9 @@ pub enum ResolveOutcome {
 #[derive(Debug)]
 pub struct TabManager {
     tabs: Vec<Tab>,
+    /// Position of every tab in `tabs`, updated whenever tabs are added, removed or reordered.
+    indices: HashMap<TabId, usize>,
+    document_tabs: HashMap<DocumentId, TabId>,
     active_tab_id: TabId,
     next_tab_id: TabId,
     history_manager: TabHistoryManager,
@@ -35,6 +41,8 @@ impl TabManager {
     pub fn new() -> Self {
         Self {
             tabs: Vec::new(),
+            indices: HashMap::new(),
+            document_tabs: HashMap::new(),
             active_tab_id: TabId::new(1).expect("Tab id should not be 0"),
             next_tab_id: TabId::new(2).expect("Tab id should not be 0"),
             history_manager: TabHistoryManager::new(),
@@ -55,22 +63,27 @@ impl TabManager {
         &self.tabs
     }
 
-    pub fn get_tabs_mut(&mut self) -> &mut Vec<Tab> {
-        &mut self.tabs
+    /// Tabs that were closed but can still be reopened from history, by the id they had.
+    pub fn closed_tabs(&self) -> impl Iterator<Item = (TabId, &ClosedTabInfo)> {
+        self.closed_store.iter()
     }
 
     pub fn get_tab(&self, id: TabId) -> Result<&Tab, TabError> {
-        self.tabs
-            .iter()
-            .find(|tab| tab.get_id() == id)
+        self.get_tab_index(id)
+            .map(|idx| &self.tabs[idx])
             .ok_or(TabError::NotFound(id))
     }
 
     pub fn get_tab_mut(&mut self, id: TabId) -> Result<&mut Tab, TabError> {
-        self.tabs
-            .iter_mut()
-            .find(|tab| tab.get_id() == id)
-            .ok_or(TabError::NotFound(id))
+        match self.get_tab_index(id) {
+            Some(idx) => Ok(&mut self.tabs[idx]),
+            None => Err(TabError::NotFound(id)),
+        }
+    }
+
+    /// Returns the position of the tab with `id` in [`Self::get_tabs`].
+    pub fn get_tab_index(&self, id: TabId) -> Option<usize> {
+        self.indices.get(&id).copied()
     }
 
     pub fn get_active_tab_id(&self) -> TabId {
@@ -87,9 +100,7 @@ impl TabManager {
 
         let find_anchor_index = || -> Result<usize, TabError> {
             let anchor_id = anchor_tab_id.ok_or(TabError::NoIdProvided)?;
-            self.tabs
-                .iter()
-                .position(|tab| tab.get_id() == anchor_id)
+            self.get_tab_index(anchor_id)
                 .ok_or(TabError::NotFound(anchor_id))
         };
 
@@ -130,10 +141,14 @@ impl TabManager {
     }
 
     pub fn find_tab_by_document(&self, document_id: DocumentId) -> Option<TabId> {
-        self.tabs
-            .iter()
-            .find(|tab| tab.get_document_id() == document_id)
-            .map(|tab| tab.get_id())
+        self.document_tabs.get(&document_id).copied()
+    }
+
+    /// Renumbers the tabs from `start` onwards after they were inserted, removed or reordered.
+    fn reindex_from(&mut self, start: usize) {
+        for (idx, tab) in self.tabs.iter().enumerate().skip(start) {
+            self.indices.insert(tab.get_id(), idx);
+        }
     }
 
     // Setters
@@ -154,6 +169,8 @@ impl TabManager {
         let new_tab_id = self.generate_next_id();
         let tab = Tab::new(new_tab_id, document_id, view_id);
 
+        self.indices.insert(new_tab_id, self.tabs.len());
+        self.document_tabs.entry(document_id).or_insert(new_tab_id);
         self.tabs.push(tab);
         if add_to_history {
             self.activate_tab(new_tab_id);
@@ -164,6 +181,14 @@ impl TabManager {
         new_tab_id
     }
 
+    /// Records a tab closed in an earlier session, so it can be reopened from history like any
+    /// other closed tab. Returns the id it is known by from now on.
+    pub fn restore_closed_tab(&mut self, info: ClosedTabInfo) -> TabId {
+        let id = self.generate_next_id();
+        self.closed_store.insert(id, info);
+        id
+    }
+
     pub fn close_tabs(
         &mut self,
         tabs_with_info: Vec<(TabId, Option<ClosedTabInfo>)>,
@@ -174,17 +199,19 @@ impl TabManager {
         }
 
         let ids_to_close: Vec<TabId> = tabs_with_info.iter().map(|(id, _)| *id).collect();
-        let info_map: std::collections::HashMap<TabId, Option<ClosedTabInfo>> =
-            tabs_with_info.into_iter().collect();
+        let info_map: HashMap<TabId, Option<ClosedTabInfo>> = tabs_with_info.into_iter().collect();
 
         self.closed_store
             .record_closed_tabs(&ids_to_close, |id| info_map.get(&id).cloned().flatten());
 
-        let id_set: std::collections::HashSet<TabId> = ids_to_close.iter().copied().collect();
+        let id_set: HashSet<TabId> = ids_to_close.iter().copied().collect();
         self.tabs.retain(|t| !id_set.contains(&t.get_id()));
+        self.indices.retain(|id, _| !id_set.contains(id));
+        self.document_tabs.retain(|_, id| !id_set.contains(id));
 
         self.switch_to_last_active_tab(history_enabled);
         self.tabs.sort_by_key(|t| !t.get_is_pinned());
+        self.reindex_from(0);
 
         Ok(ids_to_close)
     }
@@ -215,11 +242,7 @@ impl TabManager {
         // History disabled, use linear order.
         if !use_history {
             let tab_count = self.tabs.len() as i64;
-            let current_idx = self
-                .tabs
-                .iter()
-                .position(|t| t.get_id() == self.active_tab_id)
-                .unwrap_or(0) as i64;
+            let current_idx = self.get_tab_index(self.active_tab_id).unwrap_or(0) as i64;
 
             let next_idx = (current_idx + delta).rem_euclid(tab_count) as usize;
             let tab_id = self.tabs[next_idx].get_id();
@@ -341,11 +364,7 @@ impl TabManager {
     }
 
     pub fn pin_tab(&mut self, id: TabId) -> Result<(), TabError> {
-        let idx = self
-            .tabs
-            .iter()
-            .position(|t| t.get_id() == id)
-            .ok_or(TabError::NotFound(id))?;
+        let idx = self.get_tab_index(id).ok_or(TabError::NotFound(id))?;
 
         // Bail if the tab is already pinned.
         if self.tabs[idx].get_is_pinned() {
@@ -362,16 +381,13 @@ impl TabManager {
             .unwrap_or(self.tabs.len());
 
         self.tabs.insert(insert_idx, tab);
+        self.reindex_from(idx.min(insert_idx));
 
         Ok(())
     }
 
     pub fn unpin_tab(&mut self, id: TabId) -> Result<(), TabError> {
-        let idx = self
-            .tabs
-            .iter()
-            .position(|t| t.get_id() == id)
-            .ok_or(TabError::NotFound(id))?;
+        let idx = self.get_tab_index(id).ok_or(TabError::NotFound(id))?;
 
         if !self.tabs[idx].get_is_pinned() {
             return Ok(());
@@ -386,6 +402,7 @@ impl TabManager {
         };
 
         self.tabs.insert(insert_idx, tab);
+        self.reindex_from(idx.min(insert_idx));
 
         Ok(())
     }
@@ -420,6 +437,7 @@ impl TabManager {
 
         let tab = self.tabs.remove(from);
         self.tabs.insert(to, tab);
+        self.reindex_from(from.min(to));
         Ok(())
     }
 
@@ -452,7 +470,7 @@ impl TabManager {
             // Walk history backwards and pick the most recent tab that still exists.
             if let Some(idx) = self
                 .history_manager
-                .last_matching(|id| self.tabs.iter().any(|t| t.get_id() == id))
+                .last_matching(|id| self.indices.contains_key(&id))
             {
                 let id = self.history_manager.id_at(idx);
                 self.active_tab_id = id;
@@ -479,7 +497,7 @@ impl TabManager {
         F: Fn(&Path) -> Option<DocumentId>,
     {
         // If the tab still exists, use it.
-        if self.tabs.iter().any(|t| t.get_id() == id) {
+        if self.indices.contains_key(&id) {
             return ResolveOutcome::Existing(id);
         }
 
@@ -575,6 +593,32 @@ mod test {
         assert!(result.is_err())
     }
 
+    #[test]
+    fn tab_lookups_follow_reordered_and_closed_tabs() {
+        let mut tm = TabManager::new();
+        let ids: Vec<TabId> = (1..=4)
+            .map(|n| {
+                tm.add_tab_for_document(DocumentId::new(n).unwrap(), ViewId::new(n).unwrap(), true)
+            })
+            .collect();
+
+        tm.move_tab(0, 3).unwrap();
+        tm.pin_tab(ids[2]).unwrap();
+        tm.close_tabs(vec![(ids[1], None)], true).unwrap();
+
+        for (idx, tab) in tm.get_tabs().iter().enumerate() {
+            assert_eq!(tm.get_tab_index(tab.get_id()), Some(idx));
+            assert_eq!(tm.get_tab(tab.get_id()).unwrap().get_id(), tab.get_id());
+        }
+        assert!(tm.get_tab(ids[1]).is_err());
+        assert_eq!(tm.find_tab_by_document(DocumentId::new(2).unwrap()), None);
+        assert_eq!(
+            tm.find_tab_by_document(DocumentId::new(4).unwrap()),
+            Some(ids[3])
+        );
+        assert_eq!(tm.get_tab_index(ids[2]), Some(0));
+    }
+
     #[test]
     // TODO(scarlet): Fix this
     fn pin_tab_reorders_tabs_and_updates_active_index() {
@@ -11,4 +11,6 @@ pub use error::*;
 use history::TabHistoryManager;
 pub use manager::TabManager;
 pub use tab::Tab;
-pub use types::{CloseTabOperationType, ClosedTabInfo, MoveActiveTabResult, ScrollOffsets};
+pub use types::{
+    CloseTabOperationType, ClosedTabInfo, MoveActiveTabResult, ScrollOffsets, TabEvent,
+};
@@ -45,7 +45,7 @@ pub enum CloseTabOperationType {
     All,
 }
 
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, PartialEq)]
 pub struct ClosedTabInfo {
     pub path: PathBuf,
     pub scroll_offsets: (usize, usize),
@@ -74,3 +74,12 @@ pub struct OpenTabResult {
     pub tab_id: Option<TabId>,
     pub tab_already_exists: bool,
 }
+
+/// A change to how a tab is presented, reported by [`crate::AppState::take_tab_events`] so the UI
+/// can update just that tab.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TabEvent {
+    ModifiedChanged { id: TabId, modified: bool },
+    TitleChanged(TabId),
+    ActiveChanged(TabId),
+}
@@ -1,4 +1,10 @@
 use crate::Buffer;
+use std::{
+    fs,
+    ops::Deref,
+    path::{Path, PathBuf},
+    sync::atomic::{AtomicUsize, Ordering},
+};
 
 pub fn create_buffer_from(content: &str) -> Buffer {
     Buffer::from(content)
@@ -7,3 +13,50 @@ pub fn create_buffer_from(content: &str) -> Buffer {
 pub fn create_empty_buffer() -> Buffer {
     Buffer::new()
 }
+
+/// A fresh directory under the system temp dir, unique to this process and call, so tests can
+/// run in parallel (and alongside other runs). It is removed with everything in it when dropped,
+/// including when the test panics.
+#[derive(Debug)]
+pub struct TempDir {
+    path: PathBuf,
+}
+
+impl TempDir {
+    pub fn new(name: &str) -> Self {
+        static NEXT: AtomicUsize = AtomicUsize::new(0);
+
+        let unique = NEXT.fetch_add(1, Ordering::Relaxed);
+        let path =
+            std::env::temp_dir().join(format!("neko_{name}_{}_{unique}", std::process::id()));
+
+        _ = fs::remove_dir_all(&path);
+        fs::create_dir_all(&path).expect("Failed to create test directory");
+
+        Self { path }
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+}
+
+impl Deref for TempDir {
+    type Target = Path;
+
+    fn deref(&self) -> &Path {
+        &self.path
+    }
+}
+
+impl AsRef<Path> for TempDir {
+    fn as_ref(&self) -> &Path {
+        &self.path
+    }
+}
+
+impl Drop for TempDir {
+    fn drop(&mut self) {
+        _ = fs::remove_dir_all(&self.path);
+    }
+}
@@ -7,7 +7,7 @@ pub enum AddCursorDirection {
     At { row: usize, col: usize },
 }
 
-#[derive(Debug, Clone, Default)]
+#[derive(Debug, Clone, Default, PartialEq)]
 pub struct CursorEntry {
     pub id: u64,
     pub cursor: Cursor,
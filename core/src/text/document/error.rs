@@ -7,6 +7,9 @@ pub enum DocumentError {
     InvalidId(u64),
     NoPath(DocumentId),
     NotFound(DocumentId),
+    Loading(DocumentId),
+    SaveInProgress(DocumentId),
+    Lossy(DocumentId),
     ViewNotFound,
 }
 
@@ -17,6 +20,16 @@ impl fmt::Display for DocumentError {
             DocumentError::InvalidId(_) => write!(f, "Document id must not be 0"),
             DocumentError::NoPath(id) => write!(f, "Document {id:?} has no path"),
             DocumentError::NotFound(id) => write!(f, "Document {id:?} not found"),
+            DocumentError::Loading(id) => write!(f, "Document {id:?} is still loading"),
+            DocumentError::SaveInProgress(id) => {
+                write!(f, "Document {id:?} is already being saved")
+            }
+            DocumentError::Lossy(id) => {
+                write!(
+                    f,
+                    "Document {id:?} is not valid UTF-8 and can only be saved elsewhere"
+                )
+            }
             DocumentError::ViewNotFound => write!(f, "View not found"),
         }
     }
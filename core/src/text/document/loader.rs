@@ -0,0 +1,229 @@
+use crate::{Buffer, FileIoManager, LoadProgress, text::editor::LoadedBuffer};
+use std::{
+    fs::File,
+    io::{self, Cursor, Read},
+    path::PathBuf,
+    sync::{
+        Arc,
+        atomic::{AtomicBool, AtomicU64, Ordering},
+        mpsc::{self, Receiver, TryRecvError},
+    },
+    thread,
+};
+
+/// How much of the file is read before a preview of the first screenful is handed over.
+const PREVIEW_BYTES: usize = 64 * 1024;
+
+/// Output of a [`DocumentLoad`] worker, in the order it is produced.
+#[derive(Debug)]
+pub enum DocumentLoadEvent {
+    /// Complete lines from the start of the file, available before the whole file has been read.
+    Preview(String),
+    /// The fully built buffer, or the error that stopped the load.
+    Finished(io::Result<LoadedBuffer>),
+}
+
+/// A file being streamed into a [`Buffer`] on a worker thread.
+///
+/// The worker hands its results back over a channel so that the owner can poll for them without
+/// blocking. Dropping the load cancels it; the worker stops at its next read.
+#[derive(Debug)]
+pub struct DocumentLoad {
+    events: Receiver<DocumentLoadEvent>,
+    cancelled: Arc<AtomicBool>,
+    bytes_read: Arc<AtomicU64>,
+    total_bytes: u64,
+}
+
+impl DocumentLoad {
+    /// Opens `path` and starts reading it on a worker thread.
+    ///
+    /// The file is opened on the calling thread so that errors such as a missing file are
+    /// reported immediately rather than through [`DocumentLoadEvent::Finished`].
+    pub fn spawn(path: PathBuf) -> io::Result<Self> {
+        let file = FileIoManager::open_file(&path)?;
+        let total_bytes = file.metadata().map(|metadata| metadata.len()).unwrap_or(0);
+
+        let (sender, events) = mpsc::channel();
+        let cancelled = Arc::new(AtomicBool::new(false));
+        let bytes_read = Arc::new(AtomicU64::new(0));
+
+        let reader = CancellableReader {
+            inner: file,
+            cancelled: Arc::clone(&cancelled),
+        };
+        let progress = Arc::clone(&bytes_read);
+
+        thread::Builder::new()
+            .name("neko-document-load".to_string())
+            .spawn(move || {
+                let result = Self::run(reader, &progress, |preview| {
+                    // The receiver is gone if the load was dropped, which is fine to ignore.
+                    _ = sender.send(DocumentLoadEvent::Preview(preview));
+                });
+                _ = sender.send(DocumentLoadEvent::Finished(result));
+            })?;
+
+        Ok(Self {
+            events,
+            cancelled,
+            bytes_read,
+            total_bytes,
+        })
+    }
+
+    fn run(
+        mut reader: CancellableReader<File>,
+        bytes_read: &AtomicU64,
+        on_preview: impl FnOnce(String),
+    ) -> io::Result<LoadedBuffer> {
+        let mut head = vec![0; PREVIEW_BYTES];
+        let head_len = read_up_to(&mut reader, &mut head)?;
+        head.truncate(head_len);
+
+        // Only preview files that are large enough to be worth it, and only whole lines so the
+        // preview never ends in a split character.
+        if head_len == PREVIEW_BYTES {
+            if let Some(last_newline) = head.iter().rposition(|&byte| byte == b'\n') {
+                on_preview(String::from_utf8_lossy(&head[..=last_newline]).into_owned());
+            }
+        }
+
+        Buffer::from_reader(Cursor::new(head).chain(reader), |read| {
+            bytes_read.store(read, Ordering::Relaxed)
+        })
+    }
+
+    /// Asks the worker to stop. A cancelled load finishes with an error.
+    pub fn cancel(&self) {
+        self.cancelled.store(true, Ordering::Relaxed);
+    }
+
+    pub fn progress(&self) -> LoadProgress {
+        LoadProgress {
+            bytes_read: self.bytes_read.load(Ordering::Relaxed),
+            total_bytes: self.total_bytes,
+        }
+    }
+
+    /// Returns the next event from the worker without blocking, if there is one.
+    pub fn try_next(&self) -> Option<DocumentLoadEvent> {
+        match self.events.try_recv() {
+            Ok(event) => Some(event),
+            Err(TryRecvError::Empty) => None,
+            // The worker can only disconnect after sending `Finished`, unless it panicked.
+            Err(TryRecvError::Disconnected) => Some(DocumentLoadEvent::Finished(Err(
+                io::Error::other("document load worker exited unexpectedly"),
+            ))),
+        }
+    }
+}
+
+impl Drop for DocumentLoad {
+    fn drop(&mut self) {
+        self.cancel();
+    }
+}
+
+/// Fills as much of `buf` as the reader allows, returning the number of bytes read.
+fn read_up_to(reader: &mut impl Read, buf: &mut [u8]) -> io::Result<usize> {
+    let mut filled = 0;
+
+    while filled < buf.len() {
+        match reader.read(&mut buf[filled..]) {
+            Ok(0) => break,
+            Ok(read) => filled += read,
+            Err(error) if error.kind() == io::ErrorKind::Interrupted => continue,
+            Err(error) => return Err(error),
+        }
+    }
+
+    Ok(filled)
+}
+
+/// Fails every read once its flag is set, which unwinds [`Buffer::from_reader`] early.
+struct CancellableReader<R> {
+    inner: R,
+    cancelled: Arc<AtomicBool>,
+}
+
+impl<R: Read> Read for CancellableReader<R> {
+    fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+        if self.cancelled.load(Ordering::Relaxed) {
+            return Err(io::Error::other("document load cancelled"));
+        }
+
+        self.inner.read(buf)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_utils::TempDir;
+    use std::{fs, time::Duration};
+
+    fn wait_for_finish(load: &DocumentLoad) -> io::Result<LoadedBuffer> {
+        loop {
+            match load.try_next() {
+                Some(DocumentLoadEvent::Finished(result)) => return result,
+                Some(DocumentLoadEvent::Preview(_)) => {}
+                None => thread::sleep(Duration::from_millis(1)),
+            }
+        }
+    }
+
+    #[test]
+    fn loads_file_on_worker_thread() {
+        let directory = TempDir::new("document_load_small");
+        let path = directory.join("small.txt");
+        fs::write(&path, "hello\nworld").unwrap();
+
+        let load = DocumentLoad::spawn(path.clone()).unwrap();
+        let loaded = wait_for_finish(&load).unwrap();
+
+        assert_eq!(loaded.buffer.get_text(), "hello\nworld");
+        assert_eq!(load.progress().bytes_read, 11);
+        assert_eq!(load.progress().total_bytes, 11);
+    }
+
+    #[test]
+    fn previews_whole_lines_of_large_files() {
+        let directory = TempDir::new("document_load_large");
+        let path = directory.join("large.txt");
+        let line = "x".repeat(99) + "\n";
+        let content = line.repeat(PREVIEW_BYTES / line.len() * 2);
+        fs::write(&path, &content).unwrap();
+
+        let load = DocumentLoad::spawn(path.clone()).unwrap();
+        let preview = loop {
+            match load.try_next() {
+                Some(DocumentLoadEvent::Preview(preview)) => break preview,
+                Some(DocumentLoadEvent::Finished(_)) => panic!("expected a preview first"),
+                None => thread::sleep(Duration::from_millis(1)),
+            }
+        };
+
+        assert!(preview.ends_with('\n'));
+        assert!(content.starts_with(&preview));
+        assert_eq!(wait_for_finish(&load).unwrap().buffer.get_text(), content);
+    }
+
+    #[test]
+    fn cancelled_reader_stops_reading() {
+        let cancelled = Arc::new(AtomicBool::new(true));
+        let mut reader = CancellableReader {
+            inner: Cursor::new(b"abc".to_vec()),
+            cancelled,
+        };
+
+        assert!(reader.read(&mut [0; 3]).is_err());
+    }
+
+    #[test]
+    fn missing_file_fails_to_spawn() {
+        let directory = TempDir::new("document_load_missing");
+
+        assert!(DocumentLoad::spawn(directory.join("missing.txt")).is_err());
+    }
+}
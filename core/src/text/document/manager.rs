@@ -1,6 +1,10 @@
-use crate::{Buffer, Document, DocumentError, DocumentId, DocumentResult, FileIoManager};
+use crate::{
+    Buffer, Document, DocumentError, DocumentId, DocumentLoad, DocumentLoadEvent,
+    DocumentLoadStatus, DocumentLoadUpdate, DocumentReload, DocumentResult, DocumentSave,
+    DocumentSaveUpdate, DocumentStub, FileIoManager, FileWatcher, LoadProgress, WatchKind,
+};
 use std::{
-    collections::HashMap,
+    collections::{HashMap, HashSet},
     fs,
     path::{Path, PathBuf},
 };
@@ -14,6 +18,20 @@ pub struct DocumentManager {
     documents: HashMap<DocumentId, Document>,
     next_document_id: DocumentId,
     path_index: HashMap<PathBuf, DocumentId>,
+    loads: HashMap<DocumentId, DocumentLoad>,
+    /// Loads that bring back evicted documents, with what the file's metadata suggested about
+    /// its content when the load started.
+    reloads: HashMap<DocumentId, DocumentReload>,
+    /// Reloads that report [`DocumentReload::Changed`] whatever is read (see
+    /// [`DocumentStub::had_unsaved_edits`]), rather than settling it by checksum.
+    forced_reloads: HashSet<DocumentId>,
+    saves: HashMap<DocumentId, DocumentSave>,
+    /// Bytes that loaded text and undo histories should stay within (see [`Self::evict`]). `None`
+    /// means no limit.
+    memory_budget: Option<usize>,
+    /// Watches the file behind every entry in `path_index` (see [`Self::poll_disk_changes`]).
+    /// Spawned when the first file is opened.
+    watcher: Option<FileWatcher>,
 }
 
 impl Default for DocumentManager {
@@ -28,6 +46,12 @@ impl DocumentManager {
             documents: HashMap::new(),
             next_document_id: DocumentId::new(1).expect("Document id should not be 0"),
             path_index: HashMap::new(),
+            loads: HashMap::new(),
+            reloads: HashMap::new(),
+            forced_reloads: HashSet::new(),
+            saves: HashMap::new(),
+            memory_budget: None,
+            watcher: None,
         }
     }
 
@@ -53,6 +77,11 @@ impl DocumentManager {
             saved_revision: 0,
             saved_hash,
             modified: false,
+            loading: false,
+            changed_on_disk: false,
+            lossy: false,
+            line_count_hint: None,
+            stub: None,
         };
 
         self.documents.insert(id, document);
@@ -63,32 +92,153 @@ impl DocumentManager {
     /// Loads a file from disk and creates a new [`Document`], returning the corresponding
     /// [`DocumentId`].
     pub fn open_document(&mut self, path: &Path) -> DocumentResult<DocumentId> {
+        self.open_document_with_progress(path, |_| {})
+    }
+
+    /// Like [`Self::open_document`], reporting progress as the file is streamed into the buffer.
+    ///
+    /// The file is read in chunks straight into the rope, so peak memory stays close to the file
+    /// size. Invalid UTF-8 is replaced rather than rejected, and the document is marked
+    /// [`Document::lossy`].
+    pub fn open_document_with_progress(
+        &mut self,
+        path: &Path,
+        mut on_progress: impl FnMut(LoadProgress),
+    ) -> DocumentResult<DocumentId> {
+        let canon_path = fs::canonicalize(path)?;
+
+        // If already open, reuse it. A stub is read in the background like any other hydration.
+        if let Some(document_id) = self.path_index.get(&canon_path).copied() {
+            self.hydrate(document_id)?;
+            return Ok(document_id);
+        }
+
+        // Stream file content into a new document
+        let file = FileIoManager::open_file(&canon_path)?;
+        let total_bytes = file.metadata().map(|metadata| metadata.len()).unwrap_or(0);
+        let loaded = Buffer::from_reader(file, |bytes_read| {
+            on_progress(LoadProgress {
+                bytes_read,
+                total_bytes,
+            })
+        })?;
+
+        if loaded.lossy {
+            eprintln!(
+                "{} is not valid UTF-8, invalid bytes were replaced",
+                canon_path.display()
+            );
+        }
+
+        let buffer = loaded.buffer;
+        let saved_hash = loaded.checksum;
+
+        let document_id = self.generate_next_id();
+        let document = Document {
+            id: document_id,
+            path: Some(canon_path.clone()),
+            title: title_for_path(&canon_path),
+            buffer,
+            saved_hash,
+            saved_revision: 0,
+            modified: false,
+            loading: false,
+            changed_on_disk: false,
+            lossy: loaded.lossy,
+            line_count_hint: None,
+            stub: None,
+        };
+
+        self.watch_path(&canon_path);
+        self.path_index.insert(canon_path, document_id);
+        self.documents.insert(document_id, document);
+
+        Ok(document_id)
+    }
+
+    /// Like [`Self::open_document`], but returns as soon as the file is open and streams its
+    /// content in on a worker thread.
+    ///
+    /// The new document starts out empty and marked as loading. Its buffer is filled in by
+    /// [`Self::poll_loads`].
+    pub fn open_document_in_background(&mut self, path: &Path) -> DocumentResult<DocumentId> {
         let canon_path = fs::canonicalize(path)?;
 
-        // If already open, reuse it
+        // If already open (or already loading), reuse it
         if let Some(document_id) = self.path_index.get(&canon_path).copied() {
+            self.hydrate(document_id)?;
             return Ok(document_id);
         }
 
-        // Read file content into a new document
-        let file_content = FileIoManager::read_file(&canon_path)?;
+        let load = DocumentLoad::spawn(canon_path.clone())?;
 
-        let buffer = Buffer::from(&file_content);
+        let document_id = self.generate_next_id();
+        let buffer = Buffer::new();
         let saved_hash = buffer.checksum();
+        let document = Document {
+            id: document_id,
+            path: Some(canon_path.clone()),
+            title: title_for_path(&canon_path),
+            buffer,
+            saved_hash,
+            saved_revision: 0,
+            modified: false,
+            loading: true,
+            changed_on_disk: false,
+            lossy: false,
+            line_count_hint: None,
+            stub: None,
+        };
+
+        self.watch_path(&canon_path);
+        self.path_index.insert(canon_path, document_id);
+        self.documents.insert(document_id, document);
+        self.loads.insert(document_id, load);
+
+        Ok(document_id)
+    }
+
+    /// Creates a stub [`Document`] for the file at `path` without reading it, so opening many
+    /// files only costs a `stat` each. The file is read once the document is hydrated (see
+    /// [`Self::hydrate`]), and is not watched for outside changes until then.
+    pub fn open_document_deferred(&mut self, path: &Path) -> DocumentResult<DocumentId> {
+        let canon_path = fs::canonicalize(path)?;
+
+        // If already open (in whatever state), reuse it
+        if let Some(document_id) = self.path_index.get(&canon_path).copied() {
+            return Ok(document_id);
+        }
+
+        let metadata = fs::metadata(&canon_path)?;
+        if metadata.is_dir() {
+            return Err(std::io::Error::new(
+                std::io::ErrorKind::InvalidInput,
+                "Path is a directory",
+            )
+            .into());
+        }
 
         let document_id = self.generate_next_id();
+        let buffer = Buffer::new();
+        let saved_hash = buffer.checksum();
         let document = Document {
             id: document_id,
             path: Some(canon_path.clone()),
-            title: canon_path
-                .file_name()
-                .and_then(|name| name.to_str())
-                .unwrap_or("Untitled")
-                .to_string(),
+            title: title_for_path(&canon_path),
             buffer,
             saved_hash,
             saved_revision: 0,
             modified: false,
+            loading: false,
+            changed_on_disk: false,
+            lossy: false,
+            line_count_hint: None,
+            stub: Some(DocumentStub {
+                size: metadata.len(),
+                modified: metadata.modified().ok(),
+                evicted: false,
+                had_unsaved_edits: false,
+            }),
         };
 
         self.path_index.insert(canon_path, document_id);
@@ -97,6 +247,262 @@ impl DocumentManager {
         Ok(document_id)
     }
 
+    /// Creates a stub [`Document`] for a file that was open in a saved session, as if it had been
+    /// evicted: `checksum` is the content the session's cursors refer to and `line_count` its line
+    /// count. Once hydrated, the load reports whether the file still has that content (see
+    /// [`Self::hydrate`]). If the document `had_unsaved_edits`, that content was never written,
+    /// and the load always reports it as changed.
+    ///
+    /// Errors if the file no longer exists or is a directory.
+    pub fn restore_document(
+        &mut self,
+        path: &Path,
+        checksum: u32,
+        line_count: usize,
+        had_unsaved_edits: bool,
+    ) -> DocumentResult<DocumentId> {
+        if let Some(document_id) = self.path_index.get(path).copied() {
+            return Ok(document_id);
+        }
+
+        // Sessions only hold canonical paths, so a `stat` is enough to validate one.
+        let metadata = fs::metadata(path)?;
+        if metadata.is_dir() {
+            return Err(std::io::Error::new(
+                std::io::ErrorKind::InvalidInput,
+                "Path is a directory",
+            )
+            .into());
+        }
+
+        let document_id = self.generate_next_id();
+        let document = Document {
+            id: document_id,
+            path: Some(path.to_path_buf()),
+            title: title_for_path(path),
+            buffer: Buffer::new(),
+            saved_hash: checksum,
+            saved_revision: 0,
+            modified: false,
+            loading: false,
+            changed_on_disk: false,
+            lossy: false,
+            stub: Some(DocumentStub {
+                size: metadata.len(),
+                modified: metadata.modified().ok(),
+                evicted: true,
+                had_unsaved_edits,
+            }),
+            line_count_hint: Some(line_count),
+        };
+
+        self.path_index.insert(path.to_path_buf(), document_id);
+        self.documents.insert(document_id, document);
+
+        Ok(document_id)
+    }
+
+    /// Starts reading a stub document's file on a worker thread, exactly like
+    /// [`Self::open_document_in_background`] would have. Returns whether a load was started,
+    /// which is not the case for documents that were already read (or are being read).
+    ///
+    /// For an evicted document, the file's size and modification time are compared against the
+    /// ones recorded at eviction, and the updates [`Self::poll_loads`] reports for the load say
+    /// whether the file looks unchanged.
+    pub fn hydrate(&mut self, document_id: DocumentId) -> DocumentResult<bool> {
+        let document = self
+            .documents
+            .get(&document_id)
+            .ok_or(DocumentError::NotFound(document_id))?;
+
+        let Some(stub) = document.stub else {
+            return Ok(false);
+        };
+
+        let path = document
+            .path
+            .clone()
+            .ok_or(DocumentError::NoPath(document_id))?;
+        let load = DocumentLoad::spawn(path.clone())?;
+
+        if stub.evicted {
+            let unchanged = !stub.had_unsaved_edits
+                && fs::metadata(&path).is_ok_and(|metadata| {
+                    metadata.len() == stub.size && metadata.modified().ok() == stub.modified
+                });
+            let reload = if unchanged {
+                DocumentReload::Unchanged
+            } else {
+                DocumentReload::Changed
+            };
+
+            self.reloads.insert(document_id, reload);
+            if stub.had_unsaved_edits {
+                self.forced_reloads.insert(document_id);
+            }
+        }
+
+        self.watch_path(&path);
+        self.loads.insert(document_id, load);
+
+        if let Some(document) = self.documents.get_mut(&document_id) {
+            document.stub = None;
+            document.loading = true;
+        }
+
+        Ok(true)
+    }
+
+    pub fn has_pending_loads(&self) -> bool {
+        !self.loads.is_empty()
+    }
+
+    /// Moves whatever the background loads have produced since the last call into their
+    /// documents, without blocking. Returns one update per load that was pending.
+    pub fn poll_loads(&mut self) -> Vec<DocumentLoadUpdate> {
+        let mut updates = Vec::with_capacity(self.loads.len());
+        let mut finished = Vec::new();
+
+        for (&document_id, load) in &self.loads {
+            let mut status = DocumentLoadStatus::Loading;
+            let mut reload = self.reloads.get(&document_id).copied();
+
+            while let Some(event) = load.try_next() {
+                let Some(document) = self.documents.get_mut(&document_id) else {
+                    break;
+                };
+
+                match event {
+                    DocumentLoadEvent::Preview(text) => {
+                        document.buffer = Buffer::from(&text);
+                        status = DocumentLoadStatus::Preview;
+                    }
+                    DocumentLoadEvent::Finished(Ok(loaded)) => {
+                        if loaded.lossy {
+                            eprintln!(
+                                "{} is not valid UTF-8, invalid bytes were replaced",
+                                document.title
+                            );
+                        }
+
+                        // The checksum settles what the file's metadata only suggested.
+                        if reload.is_some() && !self.forced_reloads.contains(&document_id) {
+                            reload = Some(if loaded.checksum == document.saved_hash {
+                                DocumentReload::Unchanged
+                            } else {
+                                DocumentReload::Changed
+                            });
+                        }
+
+                        document.buffer = loaded.buffer;
+                        document.saved_hash = loaded.checksum;
+                        document.lossy = loaded.lossy;
+                        document.loading = false;
+                        document.line_count_hint = None;
+                        // Changes seen while the file was being read are already in the buffer.
+                        if let (Some(watcher), Some(path)) = (&self.watcher, &document.path) {
+                            watcher.watch(path, WatchKind::File);
+                        }
+                        status = DocumentLoadStatus::Finished;
+                        finished.push(document_id);
+                        break;
+                    }
+                    DocumentLoadEvent::Finished(Err(error)) => {
+                        eprintln!("Failed to load {}: {error}", document.title);
+
+                        // Keep the tab, but make sure a save can never overwrite the file with
+                        // the partial content.
+                        document.buffer = Buffer::new();
+                        document.saved_hash = document.buffer.checksum();
+                        document.loading = false;
+                        document.line_count_hint = None;
+                        if reload.is_some() {
+                            reload = Some(DocumentReload::Changed);
+                        }
+                        if let Some(path) = document.path.take() {
+                            self.path_index.remove(&path);
+
+                            if let Some(watcher) = &self.watcher {
+                                watcher.unwatch(&path);
+                            }
+                        }
+
+                        status = DocumentLoadStatus::Failed;
+                        finished.push(document_id);
+                        break;
+                    }
+                }
+            }
+
+            updates.push(DocumentLoadUpdate {
+                document_id,
+                status,
+                progress: load.progress(),
+                reload,
+            });
+        }
+
+        for document_id in finished {
+            self.loads.remove(&document_id);
+            self.reloads.remove(&document_id);
+            self.forced_reloads.remove(&document_id);
+        }
+
+        updates
+    }
+
+    pub fn memory_budget(&self) -> Option<usize> {
+        self.memory_budget
+    }
+
+    pub fn set_memory_budget(&mut self, budget: Option<usize>) {
+        self.memory_budget = budget;
+    }
+
+    /// The number of bytes of text held by loaded documents.
+    pub fn buffer_memory(&self) -> usize {
+        self.documents
+            .values()
+            .map(|document| document.buffer.byte_len())
+            .sum()
+    }
+
+    /// Drops the buffer of an unmodified document, turning it back into a stub that is reloaded
+    /// from disk when next hydrated. Returns the number of bytes freed, or `None` if the buffer
+    /// has to stay: the document is a stub already, modified, being loaded or saved, not backed
+    /// by a file, or its file changed on disk.
+    pub fn evict(&mut self, document_id: DocumentId) -> Option<usize> {
+        if self.saves.contains_key(&document_id) {
+            return None;
+        }
+
+        let document = self.documents.get_mut(&document_id)?;
+
+        if document.is_stub() || document.modified || document.loading || document.changed_on_disk {
+            return None;
+        }
+
+        let path = document.path.as_ref()?;
+        let metadata = fs::metadata(path).ok()?;
+
+        let freed = document.buffer.byte_len();
+        document.line_count_hint = Some(document.buffer.line_count());
+        document.buffer = Buffer::new();
+        document.stub = Some(DocumentStub {
+            size: metadata.len(),
+            modified: metadata.modified().ok(),
+            evicted: true,
+            had_unsaved_edits: false,
+        });
+
+        // Stubs are not watched; `hydrate` starts over from the file as it is then.
+        if let Some(watcher) = &self.watcher {
+            watcher.unwatch(path);
+        }
+
+        Some(freed)
+    }
+
     pub fn get_document(&self, document_id: DocumentId) -> Option<&Document> {
         self.documents.get(&document_id)
     }
@@ -113,45 +519,116 @@ impl DocumentManager {
 
     /// Attempts to save the [`Document`] with the provided [`DocumentId`] under the associated
     /// path.
+    ///
+    /// The buffer is streamed into a temporary file that replaces the original only once fully
+    /// written (see [`FileIoManager::write_file_atomically`]), and is hashed in the same pass.
     pub fn save_document(
         &mut self,
         document_id: DocumentId,
         current_revision: usize,
     ) -> DocumentResult<()> {
-        let (path, content) = {
-            let document = self
-                .documents
-                .get(&document_id)
-                .expect("Invalid document id");
+        let document = self
+            .documents
+            .get_mut(&document_id)
+            .expect("Invalid document id");
 
-            let path = document
-                .path
-                .clone()
-                .ok_or(DocumentError::NoPath(document_id))?;
-            let content = document.buffer.get_text();
+        if document.loading || document.is_stub() {
+            return Err(DocumentError::Loading(document_id));
+        }
 
-            (path, content)
-        };
+        if document.lossy {
+            return Err(DocumentError::Lossy(document_id));
+        }
+
+        if self.saves.contains_key(&document_id) {
+            return Err(DocumentError::SaveInProgress(document_id));
+        }
 
-        FileIoManager::write_file(&path, &content)?;
+        let path = document
+            .path
+            .as_ref()
+            .ok_or(DocumentError::NoPath(document_id))?;
+        let saved_hash =
+            FileIoManager::write_file_atomically(path, |file| document.buffer.write_to(file))?;
 
-        let document = self.documents.get_mut(&document_id).unwrap();
         document.modified = false;
         document.saved_revision = current_revision;
-        document.saved_hash = document.buffer.checksum();
+        document.saved_hash = saved_hash;
+        document.changed_on_disk = false;
 
         Ok(())
     }
 
-    /// Removes a document and cleans up its path index.
+    /// Removes a document and cleans up its path index. A load still in flight for it is
+    /// cancelled; a save in flight is left to finish on its own.
     pub fn close_document(&mut self, document_id: DocumentId) {
+        self.loads.remove(&document_id);
+        self.reloads.remove(&document_id);
+        self.forced_reloads.remove(&document_id);
+        self.saves.remove(&document_id);
+
         if let Some(document) = self.documents.remove(&document_id) {
             if let Some(path) = document.path {
                 self.path_index.remove(&path);
+                self.unwatch_path(&path);
             }
         }
     }
 
+    /// Flags documents whose files were changed by something other than the editor, comparing
+    /// the new content against what was last loaded or saved. The flag clears again if the file
+    /// goes back to that content. Returns the documents whose flag changed.
+    pub fn poll_disk_changes(&mut self) -> Vec<DocumentId> {
+        let Some(watcher) = &self.watcher else {
+            return Vec::new();
+        };
+
+        let mut updated = Vec::new();
+
+        for change in watcher.try_changes() {
+            let Some(&document_id) = self.path_index.get(&change.path) else {
+                continue;
+            };
+
+            // The editor's own loads and saves touch the file too. Each resets the watch when it
+            // finishes, so whatever happens in the meantime is not reported.
+            if self.loads.contains_key(&document_id) || self.saves.contains_key(&document_id) {
+                continue;
+            }
+
+            let Some(document) = self.documents.get_mut(&document_id) else {
+                continue;
+            };
+
+            // A removed or unreadable file has no checksum, and counts as changed.
+            let changed_on_disk = change.checksum != Some(document.saved_hash);
+
+            if document.changed_on_disk != changed_on_disk {
+                document.changed_on_disk = changed_on_disk;
+                updated.push(document_id);
+            }
+        }
+
+        updated
+    }
+
+    fn watch_path(&mut self, path: &Path) {
+        if self.watcher.is_none() {
+            // Documents still open and save without a watcher; outside changes just go unnoticed.
+            self.watcher = FileWatcher::spawn().ok();
+        }
+
+        if let Some(watcher) = &self.watcher {
+            watcher.watch(path, WatchKind::File);
+        }
+    }
+
+    fn unwatch_path(&self, path: &Path) {
+        if let Some(watcher) = &self.watcher {
+            watcher.unwatch(path);
+        }
+    }
+
     // TODO(scarlet): Handle the case where 'save as' occurs and the provided new path matches a different
     // stored Document's path.
     /// Attempts to save the [`Document`] with the provided [`DocumentId`] under the provided path.
@@ -161,35 +638,312 @@ impl DocumentManager {
         new_path: &Path,
         current_revision: usize,
     ) -> DocumentResult<()> {
-        let canon_new_path = FileIoManager::canonicalize(new_path)?;
-        let content = {
-            let document = self
-                .documents
-                .get(&document_id)
-                .ok_or(DocumentError::NotFound(document_id))?;
-
-            document.buffer.get_text()
-        };
+        let canon_new_path = canonicalize_save_path(new_path)?;
+        let document = self
+            .documents
+            .get_mut(&document_id)
+            .ok_or(DocumentError::NotFound(document_id))?;
+
+        if document.loading || document.is_stub() {
+            return Err(DocumentError::Loading(document_id));
+        }
 
-        FileIoManager::write_file(&canon_new_path, &content)?;
+        if document.lossy && document.path.as_ref() == Some(&canon_new_path) {
+            return Err(DocumentError::Lossy(document_id));
+        }
 
-        let document = self.documents.get_mut(&document_id).unwrap();
-        if let Some(old_path) = document.path.take() {
-            self.path_index.remove(&old_path);
+        if self.saves.contains_key(&document_id) {
+            return Err(DocumentError::SaveInProgress(document_id));
         }
 
-        document.path = Some(canon_new_path.to_path_buf());
-        document.title = canon_new_path
-            .file_name()
-            .and_then(|name| name.to_str())
-            .unwrap_or("Untitled")
-            .to_string();
+        let saved_hash = FileIoManager::write_file_atomically(&canon_new_path, |file| {
+            document.buffer.write_to(file)
+        })?;
         document.modified = false;
-        document.saved_revision = current_revision;
 
-        self.path_index
-            .insert(canon_new_path.to_path_buf(), document_id);
+        self.record_save(document_id, canon_new_path, current_revision, saved_hash);
+
+        Ok(())
+    }
+
+    /// Starts saving the [`Document`] on a worker thread, under `new_path` if one is given and
+    /// under its associated path otherwise. The buffer is snapshotted, so it can keep being edited
+    /// while the save runs. Call [`Self::poll_saves`] to find out how it went.
+    pub fn begin_save(
+        &mut self,
+        document_id: DocumentId,
+        new_path: Option<&Path>,
+        current_revision: usize,
+    ) -> DocumentResult<()> {
+        let document = self
+            .documents
+            .get(&document_id)
+            .ok_or(DocumentError::NotFound(document_id))?;
+
+        if document.loading || document.is_stub() {
+            return Err(DocumentError::Loading(document_id));
+        }
+
+        if self.saves.contains_key(&document_id) {
+            return Err(DocumentError::SaveInProgress(document_id));
+        }
+
+        let path = match new_path {
+            Some(new_path) => canonicalize_save_path(new_path)?,
+            None => document
+                .path
+                .clone()
+                .ok_or(DocumentError::NoPath(document_id))?,
+        };
+
+        if document.lossy && document.path.as_ref() == Some(&path) {
+            return Err(DocumentError::Lossy(document_id));
+        }
+
+        let save = DocumentSave::spawn(document.buffer.clone(), path, current_revision)?;
+        self.saves.insert(document_id, save);
 
         Ok(())
     }
+
+    pub fn has_pending_saves(&self) -> bool {
+        !self.saves.is_empty()
+    }
+
+    /// Records the saves that finished since the last call, without blocking. The `modified` flag
+    /// is left alone, since only the editor knows whether edits were made while the save ran.
+    pub fn poll_saves(&mut self) -> Vec<DocumentSaveUpdate> {
+        let finished: Vec<_> = self
+            .saves
+            .iter()
+            .filter_map(|(&document_id, save)| Some((document_id, save.try_finish()?)))
+            .collect();
+
+        let mut updates = Vec::with_capacity(finished.len());
+
+        for (document_id, result) in finished {
+            let Some(save) = self.saves.remove(&document_id) else {
+                continue;
+            };
+
+            let (succeeded, renamed) = match result {
+                Ok(saved_hash) => {
+                    let renamed = self.record_save(
+                        document_id,
+                        save.path().to_path_buf(),
+                        save.revision(),
+                        saved_hash,
+                    );
+                    (true, renamed)
+                }
+                Err(error) => {
+                    eprintln!("Failed to save {}: {error}", save.path().display());
+                    (false, false)
+                }
+            };
+
+            updates.push(DocumentSaveUpdate {
+                document_id,
+                succeeded,
+                renamed,
+            });
+        }
+
+        updates
+    }
+
+    /// Records that the document's content at `revision` is now on disk at `path`, moving the
+    /// document over to `path` if it was saved somewhere new. Returns whether it moved.
+    fn record_save(
+        &mut self,
+        document_id: DocumentId,
+        path: PathBuf,
+        revision: usize,
+        saved_hash: u32,
+    ) -> bool {
+        let Some(document) = self.documents.get_mut(&document_id) else {
+            return false;
+        };
+
+        let renamed = document.path.as_ref() != Some(&path);
+        if renamed {
+            if let Some(old_path) = document.path.take() {
+                self.path_index.remove(&old_path);
+
+                if let Some(watcher) = &self.watcher {
+                    watcher.unwatch(&old_path);
+                }
+            }
+
+            document.title = title_for_path(&path);
+            self.path_index.insert(path.clone(), document_id);
+            document.path = Some(path.clone());
+        }
+
+        document.saved_revision = revision;
+        document.saved_hash = saved_hash;
+        document.changed_on_disk = false;
+        // Saves of a lossy document only ever go to a new path, which now holds valid UTF-8.
+        document.lossy = false;
+
+        // Start over from the written file, so the save itself is never reported as a change.
+        self.watch_path(&path);
+
+        renamed
+    }
+}
+
+/// Canonicalizes a path to save to, which unlike a path to open may not exist yet. Its directory
+/// has to.
+fn canonicalize_save_path(path: &Path) -> std::io::Result<PathBuf> {
+    match FileIoManager::canonicalize(path) {
+        Err(error) if error.kind() == std::io::ErrorKind::NotFound => {
+            let Some(name) = path.file_name() else {
+                return Err(error);
+            };
+            let parent = path
+                .parent()
+                .filter(|parent| !parent.as_os_str().is_empty())
+                .unwrap_or(Path::new("."));
+
+            Ok(FileIoManager::canonicalize(parent)?.join(name))
+        }
+        result => result,
+    }
+}
+
+fn title_for_path(path: &Path) -> String {
+    path.file_name()
+        .and_then(|name| name.to_str())
+        .unwrap_or("Untitled")
+        .to_string()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_utils::TempDir;
+    use std::{thread, time::Duration};
+
+    /// Polls until every background load has finished, returning the last update of each.
+    fn finish_loads(manager: &mut DocumentManager) -> Vec<DocumentLoadUpdate> {
+        let mut finished = Vec::new();
+
+        while manager.has_pending_loads() {
+            finished.extend(
+                manager
+                    .poll_loads()
+                    .into_iter()
+                    .filter(|update| update.status != DocumentLoadStatus::Loading),
+            );
+            thread::sleep(Duration::from_millis(1));
+        }
+
+        finished
+    }
+
+    #[test]
+    fn lossy_documents_are_only_saved_under_a_new_path() {
+        let directory = TempDir::new("document_manager_lossy");
+        let path = fs::canonicalize(directory.path())
+            .unwrap()
+            .join("latin1.txt");
+        let original = b"caf\xE9\n".to_vec();
+        fs::write(&path, &original).unwrap();
+
+        let mut manager = DocumentManager::new();
+        let document_id = manager.open_document(&path).unwrap();
+        assert!(manager.get_document(document_id).unwrap().lossy);
+
+        assert!(matches!(
+            manager.save_document(document_id, 0),
+            Err(DocumentError::Lossy(_))
+        ));
+        assert!(matches!(
+            manager.begin_save(document_id, None, 0),
+            Err(DocumentError::Lossy(_))
+        ));
+        assert!(matches!(
+            manager.begin_save(document_id, Some(&path), 0),
+            Err(DocumentError::Lossy(_))
+        ));
+        assert!(matches!(
+            manager.save_document_as(document_id, &path, 0),
+            Err(DocumentError::Lossy(_))
+        ));
+        assert_eq!(fs::read(&path).unwrap(), original);
+
+        let copy = path.with_file_name("utf8.txt");
+        manager.save_document_as(document_id, &copy, 0).unwrap();
+
+        assert_eq!(fs::read_to_string(&copy).unwrap(), "caf\u{FFFD}\n");
+        assert_eq!(fs::read(&path).unwrap(), original);
+        assert!(!manager.get_document(document_id).unwrap().lossy);
+    }
+
+    #[test]
+    fn background_loads_flag_lossy_documents() {
+        let directory = TempDir::new("document_manager_lossy_background");
+        let path = directory.join("latin1.txt");
+        fs::write(&path, b"caf\xE9\n").unwrap();
+
+        let mut manager = DocumentManager::new();
+        let document_id = manager.open_document_in_background(&path).unwrap();
+        finish_loads(&mut manager);
+
+        assert!(manager.get_document(document_id).unwrap().lossy);
+        assert!(matches!(
+            manager.save_document(document_id, 0),
+            Err(DocumentError::Lossy(_))
+        ));
+    }
+
+    #[test]
+    fn deferred_documents_stay_stubs_until_hydrated() {
+        let directory = TempDir::new("document_manager_deferred");
+        let path = directory.join("file.txt");
+        fs::write(&path, "one\ntwo\n").unwrap();
+
+        let mut manager = DocumentManager::new();
+        let document_id = manager.open_document_deferred(&path).unwrap();
+        assert_eq!(manager.open_document_deferred(&path).unwrap(), document_id);
+
+        let document = manager.get_document(document_id).unwrap();
+        assert!(document.is_stub());
+        assert!(!document.loading);
+        assert!(document.buffer.is_empty());
+        assert!(!manager.has_pending_loads());
+
+        // A stub's empty buffer is not its content, so it must not be written anywhere.
+        assert!(matches!(
+            manager.save_document(document_id, 0),
+            Err(DocumentError::Loading(_))
+        ));
+        assert!(matches!(
+            manager.begin_save(document_id, None, 0),
+            Err(DocumentError::Loading(_))
+        ));
+        assert!(matches!(
+            manager.save_document_as(document_id, &directory.join("copy.txt"), 0),
+            Err(DocumentError::Loading(_))
+        ));
+        assert_eq!(fs::read_to_string(&path).unwrap(), "one\ntwo\n");
+        assert!(!directory.join("copy.txt").exists());
+
+        assert!(manager.hydrate(document_id).unwrap());
+        assert!(!manager.hydrate(document_id).unwrap());
+        let document = manager.get_document(document_id).unwrap();
+        assert!(!document.is_stub());
+        assert!(document.loading);
+
+        let updates = finish_loads(&mut manager);
+        assert_eq!(updates.len(), 1);
+        // A first load has nothing to compare against.
+        assert_eq!(updates[0].reload, None);
+
+        let document = manager.get_document(document_id).unwrap();
+        assert!(!document.loading);
+        assert_eq!(document.buffer.get_text(), "one\ntwo\n");
+        assert!(manager.save_document(document_id, 0).is_ok());
+    }
 }
@@ -1,9 +1,13 @@
 pub mod error;
+pub mod loader;
 pub mod manager;
 pub mod result;
+pub mod saver;
 pub mod types;
 
 pub use error::*;
+pub use loader::{DocumentLoad, DocumentLoadEvent};
 pub use manager::DocumentManager;
 pub use result::*;
+pub use saver::DocumentSave;
 pub use types::*;
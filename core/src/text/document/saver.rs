@@ -0,0 +1,90 @@
+use crate::{Buffer, FileIoManager};
+use std::{
+    io,
+    path::{Path, PathBuf},
+    sync::mpsc::{self, Receiver, TryRecvError},
+    thread,
+};
+
+/// A [`Buffer`] snapshot being written to disk on a worker thread.
+///
+/// Snapshots are cheap because the rope is persistent, so the document can keep being edited while
+/// the worker writes. Dropping the save does not stop it; an atomic write is left to complete so
+/// the file is never left half written.
+#[derive(Debug)]
+pub struct DocumentSave {
+    result: Receiver<io::Result<u32>>,
+    path: PathBuf,
+    revision: usize,
+}
+
+impl DocumentSave {
+    /// Starts writing `buffer` to `path` (see [`FileIoManager::write_file_atomically`]).
+    /// `revision` is the editor revision the snapshot was taken at.
+    pub fn spawn(buffer: Buffer, path: PathBuf, revision: usize) -> io::Result<Self> {
+        let (sender, result) = mpsc::channel();
+        let target = path.clone();
+
+        thread::Builder::new()
+            .name("neko-document-save".to_string())
+            .spawn(move || {
+                let saved =
+                    FileIoManager::write_file_atomically(&target, |file| buffer.write_to(file));
+                _ = sender.send(saved);
+            })?;
+
+        Ok(Self {
+            result,
+            path,
+            revision,
+        })
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    pub fn revision(&self) -> usize {
+        self.revision
+    }
+
+    /// Returns the checksum of the written content once the worker is done, without blocking.
+    pub fn try_finish(&self) -> Option<io::Result<u32>> {
+        match self.result.try_recv() {
+            Ok(result) => Some(result),
+            Err(TryRecvError::Empty) => None,
+            Err(TryRecvError::Disconnected) => Some(Err(io::Error::other(
+                "document save worker exited unexpectedly",
+            ))),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_utils::TempDir;
+    use std::{fs, time::Duration};
+
+    #[test]
+    fn writes_snapshot_on_worker_thread() {
+        let directory = TempDir::new("document_save");
+        let path = directory.join("saved.txt");
+        let mut buffer = Buffer::from("saved");
+        let save = DocumentSave::spawn(buffer.clone(), path.clone(), 3).unwrap();
+
+        // Edits after the snapshot must not reach the file.
+        buffer.insert(5, " later");
+
+        let checksum = loop {
+            match save.try_finish() {
+                Some(result) => break result.unwrap(),
+                None => thread::sleep(Duration::from_millis(1)),
+            }
+        };
+
+        assert_eq!(fs::read_to_string(&path).unwrap(), "saved");
+        assert_eq!(checksum, Buffer::from("saved").checksum());
+        assert_eq!(save.revision(), 3);
+    }
+}
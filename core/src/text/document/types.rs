@@ -1,5 +1,5 @@
 use crate::{Buffer, DocumentError};
-use std::{num::NonZeroU64, path::PathBuf};
+use std::{num::NonZeroU64, path::PathBuf, time::SystemTime};
 
 /// Represents the id associated with a given [`Document`].
 #[derive(Eq, Hash, PartialEq, Clone, Copy, Debug)]
@@ -44,4 +44,107 @@ pub struct Document {
     pub modified: bool,
     pub saved_hash: u32,
     pub saved_revision: usize,
+    /// Set while the content is still being streamed in by a background load. Edits and saves
+    /// are refused until it clears.
+    pub loading: bool,
+    /// Set when the file was changed on disk by something else since it was loaded or saved
+    /// (see [`crate::DocumentManager::poll_disk_changes`]).
+    pub changed_on_disk: bool,
+    /// Set when the file was not valid UTF-8 and the invalid bytes were replaced with U+FFFD on
+    /// load. Saving over the file would lose the original bytes, so that is refused; the
+    /// document can still be saved under a new path.
+    pub lossy: bool,
+    /// Set while the file has not been read at all. The buffer stays empty until the document is
+    /// hydrated (see [`crate::DocumentManager::hydrate`]), and edits and saves are refused.
+    pub stub: Option<DocumentStub>,
+    /// The line count the document had when it was last loaded, kept while it is a stub or being
+    /// read again so views can be laid out (and scrolled) before the content is back.
+    pub line_count_hint: Option<usize>,
+}
+
+impl Document {
+    /// Whether the file behind the document has not been read yet.
+    pub fn is_stub(&self) -> bool {
+        self.stub.is_some()
+    }
+
+    /// The number of lines to lay views of the document out for: the buffer's, or while the
+    /// content is not back yet, the count it had when last loaded.
+    pub fn line_count(&self) -> usize {
+        self.line_count_hint
+            .unwrap_or_else(|| self.buffer.line_count())
+    }
+}
+
+/// What is known about the file behind a document that has not been read yet.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct DocumentStub {
+    pub size: u64,
+    /// The file's modification time, if the platform reports one.
+    pub modified: Option<SystemTime>,
+    /// Set if the document was loaded before, and evicted (see
+    /// [`crate::DocumentManager::evict`]) or restored from a saved session, rather than never
+    /// read.
+    pub evicted: bool,
+    /// Set if the document had unsaved edits when its session was saved. The content its views
+    /// were laid out for was never written, so it reloads as changed whatever the file holds.
+    pub had_unsaved_edits: bool,
+}
+
+/// Memory held by open documents, as reported by [`crate::AppState::memory_usage`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct MemoryUsage {
+    /// Bytes of loaded text and undo history.
+    pub used: usize,
+    pub budget: Option<usize>,
+}
+
+/// How a document reloaded after being evicted (or restored from a session) compares to the
+/// content it had before.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DocumentReload {
+    /// The file is unchanged, so the state of the views showing it still applies.
+    Unchanged,
+    /// The file was changed in the meantime. Cursors and undo history no longer match it.
+    Changed,
+}
+
+/// Progress of a document being streamed in from disk.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct LoadProgress {
+    pub bytes_read: u64,
+    /// The file size when loading started. Zero if it could not be determined.
+    pub total_bytes: u64,
+}
+
+/// State of a background load reported by [`crate::DocumentManager::poll_loads`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum DocumentLoadStatus {
+    /// Still reading; the buffer is unchanged since the last poll.
+    Loading,
+    /// The buffer now holds the first part of the file.
+    Preview,
+    /// The buffer holds the whole file.
+    Finished,
+    /// Reading failed. The document is left empty and detached from its path.
+    Failed,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct DocumentLoadUpdate {
+    pub document_id: DocumentId,
+    pub status: DocumentLoadStatus,
+    pub progress: LoadProgress,
+    /// Set when the document is being reloaded after eviction. Until the load finishes this is
+    /// only a guess based on the file's size and modification time.
+    pub reload: Option<DocumentReload>,
+}
+
+/// Outcome of a background save reported by [`crate::DocumentManager::poll_saves`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct DocumentSaveUpdate {
+    pub document_id: DocumentId,
+    pub succeeded: bool,
+    /// The document was saved under a new path, and so has a new title.
+    pub renamed: bool,
 }
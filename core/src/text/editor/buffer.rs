@@ -1,26 +1,138 @@
 use crc32fast::Hasher;
-use crop::Rope;
-use std::mem::swap;
+use crop::{Rope, RopeBuilder};
+use std::{
+    io::{self, IoSlice, Read, Write},
+    mem::swap,
+    sync::atomic::{AtomicU64, Ordering},
+};
 
-#[derive(Debug, Default)]
+/// Size of each read when streaming a file into a [`Buffer`].
+const LOAD_CHUNK_SIZE: usize = 256 * 1024;
+
+/// Number of rope chunks handed to each vectored write when streaming a [`Buffer`] out.
+const WRITE_BATCH_CHUNKS: usize = 64;
+
+/// Hands out [`Buffer::version`]s. Zero is left for [`Buffer::default`].
+static NEXT_VERSION: AtomicU64 = AtomicU64::new(1);
+
+fn next_version() -> u64 {
+    NEXT_VERSION.fetch_add(1, Ordering::Relaxed)
+}
+
+#[derive(Debug, Default, Clone)]
 pub struct Buffer {
     content: Rope,
+    version: u64,
+}
+
+/// A [`Buffer`] streamed from a reader, along with the checksum of its content.
+#[derive(Debug)]
+pub struct LoadedBuffer {
+    pub buffer: Buffer,
+    pub checksum: u32,
+    /// Set when invalid UTF-8 had to be replaced with U+FFFD.
+    pub lossy: bool,
 }
 
 impl Buffer {
     pub fn new() -> Self {
         Self {
             content: Rope::new(),
+            version: next_version(),
         }
     }
 
     pub fn from(content: &str) -> Self {
         Self {
             content: Rope::from(content),
+            version: next_version(),
+        }
+    }
+
+    /// Streams `reader` into a new buffer one chunk at a time, hashing the content on the way, so
+    /// the file is never held in memory twice. Invalid UTF-8 is replaced with U+FFFD instead of
+    /// failing the whole load.
+    ///
+    /// `on_progress` receives the total number of bytes read so far after every chunk.
+    pub fn from_reader<R: Read>(
+        mut reader: R,
+        mut on_progress: impl FnMut(u64),
+    ) -> io::Result<LoadedBuffer> {
+        let mut builder = RopeBuilder::new();
+        let mut hasher = Hasher::new();
+        let mut append = |text: &str| {
+            builder.append(text);
+            hasher.update(text.as_bytes());
+        };
+
+        let mut chunk = vec![0u8; LOAD_CHUNK_SIZE];
+        // Leading bytes of a UTF-8 sequence that was split across two reads
+        let mut pending = 0;
+        let mut bytes_read = 0u64;
+        let mut lossy = false;
+
+        loop {
+            let read = match reader.read(&mut chunk[pending..]) {
+                Ok(0) => break,
+                Ok(read) => read,
+                Err(e) if e.kind() == io::ErrorKind::Interrupted => continue,
+                Err(e) => return Err(e),
+            };
+
+            bytes_read += read as u64;
+            let filled = pending + read;
+            let mut rest = &chunk[..filled];
+
+            pending = loop {
+                match std::str::from_utf8(rest) {
+                    Ok(text) => {
+                        append(text);
+                        break 0;
+                    }
+                    Err(error) => {
+                        let (valid, invalid) = rest.split_at(error.valid_up_to());
+                        append(std::str::from_utf8(valid).expect("Prefix is valid UTF-8"));
+
+                        match error.error_len() {
+                            Some(len) => {
+                                append("\u{FFFD}");
+                                lossy = true;
+                                rest = &invalid[len..];
+                            }
+                            // Incomplete sequence at the end of the chunk
+                            None => break invalid.len(),
+                        }
+                    }
+                }
+            };
+
+            chunk.copy_within(filled - pending..filled, 0);
+            on_progress(bytes_read);
         }
+
+        if pending > 0 {
+            append("\u{FFFD}");
+            lossy = true;
+        }
+
+        Ok(LoadedBuffer {
+            buffer: Self {
+                content: builder.build(),
+                version: next_version(),
+            },
+            checksum: hasher.finalize(),
+            lossy,
+        })
     }
 
     // Getters
+    /// Identifies the content: two buffers with the same version hold the same text. Every new
+    /// buffer and every edit gets a version no buffer in the process has had, so a renderer can
+    /// tell that a cache was drawn from other text, including after a buffer was swapped out.
+    pub fn version(&self) -> u64 {
+        self.version
+    }
+
     pub fn is_empty(&self) -> bool {
         self.content.is_empty()
     }
@@ -47,8 +159,15 @@ impl Buffer {
         self.content.line(line_idx).to_string()
     }
 
-    pub fn get_lines(&self) -> Vec<String> {
-        (0..self.line_count()).map(|i| self.get_line(i)).collect()
+    /// Returns the lines in the inclusive range `first..=last`, clamped to the buffer.
+    pub fn get_lines_range(&self, first: usize, last: usize) -> Vec<String> {
+        let last = last.min(self.line_count().saturating_sub(1));
+
+        if first > last {
+            return Vec::new();
+        }
+
+        (first..=last).map(|i| self.get_line(i)).collect()
     }
 
     pub fn get_text_range(&self, start_idx: usize, end_idx: usize) -> String {
@@ -198,11 +317,13 @@ impl Buffer {
     pub fn insert(&mut self, pos: usize, text: &str) {
         if pos <= self.content.byte_len() {
             self.content.insert(pos, text);
+            self.version = next_version();
         }
     }
 
     pub fn clear(&mut self) {
         self.content.delete(0..);
+        self.version = next_version();
     }
 
     pub fn backspace(&mut self, pos: usize) {
@@ -211,6 +332,7 @@ impl Buffer {
         }
 
         self.content.delete(pos - 1..pos);
+        self.version = next_version();
     }
 
     pub fn delete_at(&mut self, pos: usize) -> String {
@@ -218,6 +340,7 @@ impl Buffer {
 
         if pos < self.content.byte_len() {
             self.content.delete(pos..pos + 1);
+            self.version = next_version();
             deleted
         } else {
             String::new()
@@ -237,6 +360,7 @@ impl Buffer {
 
         if start != end {
             self.content.delete(start..end);
+            self.version = next_version();
         }
 
         deleted
@@ -252,11 +376,76 @@ impl Buffer {
 
         hasher.finalize()
     }
+
+    /// Writes the buffer to `writer` straight from the rope's chunks, without building a `String`
+    /// of the whole content, and returns the checksum of what was written (the same value as
+    /// [`Self::checksum`]).
+    pub fn write_to<W: Write>(&self, mut writer: W) -> io::Result<u32> {
+        let mut hasher = Hasher::new();
+        let mut chunks = self.content.chunks();
+        let mut batch = Vec::with_capacity(WRITE_BATCH_CHUNKS);
+
+        loop {
+            batch.clear();
+            batch.extend(chunks.by_ref().take(WRITE_BATCH_CHUNKS).map(|chunk| {
+                hasher.update(chunk.as_bytes());
+                IoSlice::new(chunk.as_bytes())
+            }));
+
+            if batch.is_empty() {
+                break;
+            }
+
+            write_all_vectored(&mut writer, &mut batch)?;
+        }
+
+        writer.flush()?;
+        Ok(hasher.finalize())
+    }
+}
+
+/// Writes every slice in full, retrying on short writes.
+fn write_all_vectored<W: Write>(writer: &mut W, mut slices: &mut [IoSlice<'_>]) -> io::Result<()> {
+    // Skip leading empty slices so that a zero-length write below really means failure.
+    IoSlice::advance_slices(&mut slices, 0);
+
+    while !slices.is_empty() {
+        match writer.write_vectored(slices) {
+            Ok(0) => {
+                return Err(io::Error::new(
+                    io::ErrorKind::WriteZero,
+                    "failed to write whole buffer",
+                ));
+            }
+            Ok(written) => IoSlice::advance_slices(&mut slices, written),
+            Err(e) if e.kind() == io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(e),
+        }
+    }
+
+    Ok(())
 }
 
 #[cfg(test)]
 mod tests {
+    use super::Buffer;
     use crate::test_utils::{create_buffer_from, create_empty_buffer};
+    use std::io::{self, Read, Write};
+
+    /// Hands out at most one byte per read, so every multi-byte character is split across reads.
+    struct OneByteReader<'a>(&'a [u8]);
+
+    impl Read for OneByteReader<'_> {
+        fn read(&mut self, buf: &mut [u8]) -> io::Result<usize> {
+            let Some((&first, rest)) = self.0.split_first() else {
+                return Ok(0);
+            };
+
+            buf[0] = first;
+            self.0 = rest;
+            Ok(1)
+        }
+    }
 
     #[test]
     fn ends_with_lf_returns_true_when_buffer_ends_with_lf() {
@@ -344,6 +533,30 @@ mod tests {
         assert_eq!(b.get_line(idx), String::new());
     }
 
+    #[test]
+    fn get_lines_range_returns_only_requested_lines() {
+        let b = create_buffer_from("a\nb\nc\nd");
+        assert_eq!(
+            b.get_lines_range(1, 2),
+            vec!["b".to_string(), "c".to_string()]
+        );
+    }
+
+    #[test]
+    fn get_lines_range_clamps_last_to_line_count() {
+        let b = create_buffer_from("a\nb\n");
+        assert_eq!(
+            b.get_lines_range(1, 100),
+            vec!["b".to_string(), String::new()]
+        );
+    }
+
+    #[test]
+    fn get_lines_range_returns_empty_when_first_is_out_of_bounds() {
+        let b = create_buffer_from("a\nb");
+        assert!(b.get_lines_range(5, 10).is_empty());
+    }
+
     #[test]
     fn get_text_range_returns_correct_slice_on_out_of_bounds_idx() {
         let b = create_buffer_from("hello");
@@ -633,4 +846,108 @@ mod tests {
         let b = create_buffer_from("a\n");
         assert_eq!(b.line_to_byte(1), b.byte_len());
     }
+
+    #[test]
+    fn from_reader_reassembles_characters_split_across_reads() {
+        let text = "héllo\n wörld ✓\n";
+        let loaded = Buffer::from_reader(OneByteReader(text.as_bytes()), |_| {}).unwrap();
+
+        assert_eq!(loaded.buffer.get_text(), text);
+        assert_eq!(loaded.checksum, loaded.buffer.checksum());
+        assert!(!loaded.lossy);
+    }
+
+    #[test]
+    fn from_reader_replaces_invalid_utf8() {
+        let bytes = b"ok\xffstill ok\xe2\x9c";
+        let loaded = Buffer::from_reader(&bytes[..], |_| {}).unwrap();
+
+        assert_eq!(loaded.buffer.get_text(), "ok\u{FFFD}still ok\u{FFFD}");
+        assert!(loaded.lossy);
+    }
+
+    #[test]
+    fn from_reader_reports_progress_in_bytes() {
+        let text = "abc";
+        let mut progress = Vec::new();
+
+        Buffer::from_reader(OneByteReader(text.as_bytes()), |read| progress.push(read)).unwrap();
+
+        assert_eq!(progress, vec![1, 2, 3]);
+    }
+
+    /// Accepts at most three bytes per write, so every chunk has to be resumed part way through.
+    struct ShortWriter(Vec<u8>);
+
+    impl Write for ShortWriter {
+        fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+            let len = buf.len().min(3);
+            self.0.extend_from_slice(&buf[..len]);
+            Ok(len)
+        }
+
+        fn flush(&mut self) -> io::Result<()> {
+            Ok(())
+        }
+    }
+
+    #[test]
+    fn write_to_streams_whole_buffer_and_returns_checksum() {
+        let text = "line of text ✓\n".repeat(10_000);
+        let buffer = Buffer::from(&text);
+        let mut writer = ShortWriter(Vec::new());
+
+        let checksum = buffer.write_to(&mut writer).unwrap();
+
+        assert_eq!(writer.0, text.as_bytes());
+        assert_eq!(checksum, buffer.checksum());
+    }
+
+    #[test]
+    fn write_to_handles_empty_buffer() {
+        let buffer = create_empty_buffer();
+        let mut written = Vec::new();
+
+        let checksum = buffer.write_to(&mut written).unwrap();
+
+        assert!(written.is_empty());
+        assert_eq!(checksum, buffer.checksum());
+    }
+
+    #[test]
+    fn every_edit_and_every_new_buffer_gets_a_new_version() {
+        let mut buffer = create_buffer_from("abc");
+        let copy = buffer.clone();
+        assert_eq!(copy.version(), buffer.version());
+        assert_ne!(create_buffer_from("abc").version(), buffer.version());
+
+        let mut seen = vec![buffer.version()];
+        buffer.insert(3, "d");
+        seen.push(buffer.version());
+        buffer.backspace(4);
+        seen.push(buffer.version());
+        buffer.delete_at(0);
+        seen.push(buffer.version());
+        buffer.delete_range(0, 1);
+        seen.push(buffer.version());
+        buffer.clear();
+        seen.push(buffer.version());
+
+        seen.sort_unstable();
+        seen.dedup();
+        assert_eq!(seen.len(), 6);
+    }
+
+    #[test]
+    fn edits_that_change_nothing_keep_the_version() {
+        let mut buffer = create_buffer_from("abc");
+        let version = buffer.version();
+
+        buffer.insert(10, "x");
+        buffer.delete_at(3);
+        buffer.delete_range(1, 1);
+        buffer.backspace(0);
+
+        assert_eq!(buffer.version(), version);
+    }
 }
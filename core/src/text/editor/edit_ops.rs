@@ -3,7 +3,7 @@ use crate::{Buffer, Cursor, CursorEntry, Editor};
 
 impl Editor {
     pub fn insert_text(&mut self, buffer: &mut Buffer, text: &str) -> ChangeSet {
-        let res = self.with_op(
+        self.with_op(
             buffer,
             true,
             OpFlags::BufferViewportWidths,
@@ -32,15 +32,11 @@ impl Editor {
                     c.cursor.move_to(buffer, row, col);
                 }
             },
-        );
-
-        let line_count = buffer.line_count();
-        self.widths_mut().sync_line_widths(line_count);
-        res
+        )
     }
 
     pub fn backspace(&mut self, buffer: &mut Buffer) -> ChangeSet {
-        let res = self.with_op(
+        self.with_op(
             buffer,
             true,
             OpFlags::BufferViewportWidths,
@@ -64,15 +60,11 @@ impl Editor {
                     c.cursor.move_to(buffer, row, col);
                 }
             },
-        );
-
-        let line_count = buffer.line_count();
-        self.widths_mut().sync_line_widths(line_count);
-        res
+        )
     }
 
     pub fn delete(&mut self, buffer: &mut Buffer) -> ChangeSet {
-        let res = self.with_op(
+        self.with_op(
             buffer,
             true,
             OpFlags::BufferViewportWidths,
@@ -96,11 +88,7 @@ impl Editor {
                     c.cursor.move_to(buffer, row, col);
                 }
             },
-        );
-
-        let line_count = buffer.line_count();
-        self.widths_mut().sync_line_widths(line_count);
-        res
+        )
     }
 
     fn invalidate_insert_lines(&mut self, buffer: &Buffer, pos: usize, text: &str, has_nl: bool) {
@@ -109,12 +97,7 @@ impl Editor {
 
         if has_nl {
             let extra_lines = text.bytes().filter(|b| *b == b'\n').count();
-            for offset in 1..=extra_lines {
-                let line = row + offset;
-                if line < buffer.line_count() {
-                    self.widths_mut().invalidate_line_width(line);
-                }
-            }
+            self.widths_mut().insert_lines(row + 1, extra_lines);
         }
     }
 
@@ -160,6 +143,7 @@ impl Editor {
             .map(|c| c.id);
 
         let deleted = buffer.delete_range(start, end);
+        self.splice_widths(buffer, start, &deleted, "");
         self.record_edit(Edit::Delete {
             start,
             end,
@@ -168,9 +152,6 @@ impl Editor {
 
         self.selection_manager_mut().clear_selection();
 
-        let line_count = buffer.line_count();
-        self.widths_mut().clear_and_rebuild_line_widths(line_count);
-
         let mut new_cursors: Vec<CursorEntry> = Vec::new();
         for (entry, idx) in cursor_info {
             let new_idx = if idx <= start {
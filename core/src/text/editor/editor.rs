@@ -1,6 +1,6 @@
 use super::{
-    Change, ChangeSet, CursorMode, DeleteResult, Edit, OpFlags, SelectionMode, Transaction,
-    UndoHistory, ViewState, WidthManager,
+    Change, ChangeSet, CursorMode, DeleteResult, Edit, OpFlags, SavePoint, SelectionMode,
+    Transaction, UndoHistory, ViewState, WidthManager,
 };
 use crate::{
     AddCursorDirection, Buffer, Cursor, CursorEntry, CursorManager, Selection, SelectionManager,
@@ -22,22 +22,61 @@ impl Default for Editor {
 
 impl Editor {
     pub fn new() -> Self {
+        Self::with_line_count(1)
+    }
+
+    /// Creates an editor for an already populated buffer with `line_count` lines, so that every
+    /// line is reported as needing a width measurement.
+    pub fn with_line_count(line_count: usize) -> Self {
         Self {
-            widths: WidthManager::new(),
+            widths: WidthManager::with_line_count(line_count),
             cursor_manager: CursorManager::new(),
             selection_manager: SelectionManager::new(),
             history: UndoHistory::default(),
         }
     }
 
-    pub fn lines(&self, buffer: &Buffer) -> Vec<String> {
-        buffer.get_lines()
+    /// Forgets measured widths after the buffer was replaced wholesale, e.g. when a background
+    /// load hands over more of the file. Every line is reported as unmeasured again.
+    pub fn reset_line_widths(&mut self, line_count: usize) {
+        self.widths = WidthManager::with_line_count(line_count);
+    }
+
+    pub fn lines_range(&self, buffer: &Buffer, first: usize, last: usize) -> Vec<String> {
+        buffer.get_lines_range(first, last)
     }
 
     pub fn revision(&self) -> usize {
         self.history.current_revision()
     }
 
+    pub fn has_unsaved_edits(&self) -> bool {
+        self.history.has_unsaved_edits()
+    }
+
+    pub fn mark_saved(&mut self) {
+        self.history.mark_saved();
+    }
+
+    pub fn save_point(&self) -> SavePoint {
+        self.history.save_point()
+    }
+
+    pub fn mark_saved_at(&mut self, point: SavePoint) {
+        self.history.mark_saved_at(point);
+    }
+
+    /// Roughly how many bytes the undo history takes up (see [`UndoHistory::approximate_size`]).
+    pub fn history_size(&self) -> usize {
+        self.history.approximate_size()
+    }
+
+    /// Shrinks the undo history of an editor that is not being edited, see
+    /// [`UndoHistory::compact`].
+    pub fn compact_history(&mut self) -> bool {
+        self.history.compact()
+    }
+
     pub fn number_of_selections(&self) -> usize {
         // TODO: When converting to multi-selection, update this
         if self.selection_manager.has_active_selection() {
@@ -139,6 +178,10 @@ impl Editor {
             self.cursor_manager.sort_and_dedup_cursors();
         }
 
+        if matches!(flags, OpFlags::BufferViewportWidths) {
+            self.widths.sync_line_widths(buffer.line_count());
+        }
+
         let mut cs = self.end_changes(buffer, lc0, cur0, &sel0);
         match flags {
             OpFlags::ViewportOnly => cs.change |= Change::VIEWPORT,
@@ -159,7 +202,7 @@ impl Editor {
     }
 
     fn end_changes(
-        &self,
+        &mut self,
         buffer: &Buffer,
         before_line_count: usize,
         before_cursors: Vec<CursorEntry>,
@@ -185,12 +228,14 @@ impl Editor {
             c |= Change::SELECTION;
         }
 
+        let dirty_rows = self.widths.take_dirty_rows();
+
         ChangeSet {
             change: c,
             line_count_before: before_line_count,
             line_count_after: after_line_count,
-            dirty_first_row: None,
-            dirty_last_row: None,
+            dirty_first_row: dirty_rows.map(|(first, _)| first),
+            dirty_last_row: dirty_rows.map(|(_, last)| last),
         }
     }
 
@@ -213,7 +258,7 @@ impl Editor {
         cs
     }
 
-    pub(crate) fn apply_delete_result(&mut self, buffer: &Buffer, _i: usize, res: DeleteResult) {
+    pub(crate) fn apply_delete_result(&mut self, _buffer: &Buffer, _i: usize, res: DeleteResult) {
         match res {
             DeleteResult::Text { invalidate } => {
                 if let Some(line) = invalidate {
@@ -226,13 +271,37 @@ impl Editor {
                 if let Some(line) = invalidate {
                     self.widths.invalidate_line_width(line);
                 }
-                if row + 1 < buffer.line_count() {
-                    self.widths.invalidate_line_width(row + 1);
-                }
+                // The following line was joined into `row`
+                self.widths.remove_lines(row + 1, 1);
             }
         }
     }
 
+    /// Keeps line widths in step with an edit that was just applied at byte `pos`: the edited row
+    /// is re-measured, and rows after it are shifted by the number of line breaks removed and
+    /// inserted rather than discarded.
+    pub(crate) fn splice_widths(
+        &mut self,
+        buffer: &Buffer,
+        pos: usize,
+        removed: &str,
+        inserted: &str,
+    ) {
+        let count_newlines = |text: &str| text.bytes().filter(|b| *b == b'\n').count();
+        let row = buffer.byte_to_line(pos);
+
+        self.widths.remove_lines(row + 1, count_newlines(removed));
+        self.widths.insert_lines(row + 1, count_newlines(inserted));
+        self.widths.invalidate_line_width(row);
+    }
+
+    fn splice_widths_for_edit(&mut self, buffer: &Buffer, edit: &Edit) {
+        match edit {
+            Edit::Insert { pos, text } => self.splice_widths(buffer, *pos, "", text),
+            Edit::Delete { start, deleted, .. } => self.splice_widths(buffer, *start, deleted, ""),
+        }
+    }
+
     pub(crate) fn delete_selection_if_active(&mut self, buffer: &mut Buffer) -> bool {
         if self.selection_manager.selection().is_active() {
             self.delete_selection_impl(buffer);
@@ -255,8 +324,7 @@ impl Editor {
             ));
 
         let deleted = buffer.delete_range(start, end);
-        self.widths
-            .clear_and_rebuild_line_widths(buffer.line_count());
+        self.splice_widths(buffer, start, &deleted, "");
         self.record_edit(Edit::Delete {
             start,
             end,
@@ -264,8 +332,6 @@ impl Editor {
         });
 
         self.selection_manager.clear_selection();
-        self.widths
-            .invalidate_line_width(self.cursor_manager.cursors[0].cursor.row);
     }
 
     pub fn for_each_cursor_rev(&mut self, mut f: impl FnMut(&mut Self, usize)) {
@@ -622,6 +688,10 @@ impl Editor {
         self.widths.needs_width_measurement(line_idx)
     }
 
+    pub fn unmeasured_lines(&self, first: usize, last: usize, limit: usize) -> Vec<usize> {
+        self.widths.unmeasured_lines(first, last, limit)
+    }
+
     pub fn update_line_width(&mut self, line_idx: usize, width: f64) {
         self.widths.update_line_width(line_idx, width);
     }
@@ -645,9 +715,8 @@ impl Editor {
     }
 
     pub(crate) fn record_edit(&mut self, edit: Edit) {
-        if let Some(tx) = &mut self.history.current {
-            tx.edits.push(edit);
-        }
+        self.history.note_applied(&edit);
+        self.history.record(edit);
     }
 
     fn commit_tx(&mut self) {
@@ -660,21 +729,21 @@ impl Editor {
 
         self.history.current = None;
 
-        let Some(tx) = self.history.undo.pop() else {
+        let Some(tx) = self.history.pop_undo() else {
             return ChangeSet::default();
         };
 
         for edit in tx.edits.iter().rev() {
-            edit.invert().apply(buffer);
+            let inverse = edit.invert();
+            inverse.apply(buffer);
+            self.splice_widths_for_edit(buffer, &inverse);
+            self.history.note_applied(&inverse);
         }
 
         self.cursor_manager.set_cursors(tx.before.cursors.clone());
         self.selection_manager.set_selection(&tx.before.selection);
 
-        self.widths
-            .clear_and_rebuild_line_widths(buffer.line_count());
-
-        self.history.redo.push(tx);
+        self.history.push_redo(tx);
 
         let mut cs = self.end_changes(buffer, lc0, cur0, &sel0);
         cs.change |= Change::SELECTION
@@ -691,21 +760,20 @@ impl Editor {
 
         self.history.current = None;
 
-        let Some(tx) = self.history.redo.pop() else {
+        let Some(tx) = self.history.pop_redo() else {
             return ChangeSet::default();
         };
 
         for edit in tx.edits.iter() {
             edit.apply(buffer);
+            self.splice_widths_for_edit(buffer, edit);
+            self.history.note_applied(edit);
         }
 
         self.cursor_manager.set_cursors(tx.after.cursors.clone());
         self.selection_manager.set_selection(&tx.after.selection);
 
-        self.widths
-            .clear_and_rebuild_line_widths(buffer.line_count());
-
-        self.history.undo.push(tx);
+        self.history.push_undo(tx);
 
         let mut cs = self.end_changes(buffer, lc0, cur0, &sel0);
         cs.change |= Change::SELECTION
@@ -888,4 +956,243 @@ mod tests {
         assert!(positions.contains(&(0, 2)));
         assert!(positions.contains(&(1, 3)));
     }
+
+    #[test]
+    fn edits_report_dirty_rows_in_change_set() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        let cs = editor.load_file(&mut buffer, "a\nb\nc");
+        assert_eq!((cs.dirty_first_row, cs.dirty_last_row), (Some(0), Some(2)));
+
+        editor.move_to(&mut buffer, 1, 1, true);
+        let cs = editor.insert_text(&mut buffer, "x");
+        assert_eq!((cs.dirty_first_row, cs.dirty_last_row), (Some(1), Some(1)));
+
+        let cs = editor.insert_text(&mut buffer, "\n");
+        assert_eq!((cs.dirty_first_row, cs.dirty_last_row), (Some(1), Some(2)));
+    }
+
+    #[test]
+    fn newline_insert_and_undo_shift_measured_widths() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        editor.load_file(&mut buffer, "a\nbb\nccc");
+        for (line, width) in [1.0, 2.0, 3.0].into_iter().enumerate() {
+            editor.update_line_width(line, width);
+        }
+
+        editor.move_to(&mut buffer, 0, 1, true);
+        editor.insert_text(&mut buffer, "\n");
+
+        // Only the split line and the new line need measuring
+        assert_eq!(editor.unmeasured_lines(0, 3, usize::MAX), vec![0, 1]);
+        assert_eq!(editor.widths().max_width(), 3.0);
+
+        editor.undo(&mut buffer);
+
+        assert_eq!(editor.unmeasured_lines(0, 2, usize::MAX), vec![0]);
+        assert_eq!(editor.widths().max_width(), 3.0);
+    }
+
+    #[test]
+    fn typing_then_deleting_returns_to_save_point() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        editor.load_file(&mut buffer, "abc");
+        editor.move_to(&mut buffer, 0, 3, true);
+
+        editor.insert_text(&mut buffer, "d");
+        editor.insert_text(&mut buffer, "e");
+        assert!(editor.has_unsaved_edits());
+
+        editor.backspace(&mut buffer);
+        assert!(editor.has_unsaved_edits());
+
+        editor.backspace(&mut buffer);
+        assert!(!editor.has_unsaved_edits());
+    }
+
+    #[test]
+    fn undo_and_redo_move_across_save_point() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        editor.load_file(&mut buffer, "abc");
+        editor.move_to(&mut buffer, 0, 3, true);
+        editor.insert_text(&mut buffer, "d");
+        editor.mark_saved();
+
+        editor.undo(&mut buffer);
+        assert!(editor.has_unsaved_edits());
+
+        editor.redo(&mut buffer);
+        assert!(!editor.has_unsaved_edits());
+    }
+
+    #[test]
+    fn edits_during_save_stay_unsaved() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        editor.load_file(&mut buffer, "abc");
+        editor.move_to(&mut buffer, 0, 3, true);
+        editor.insert_text(&mut buffer, "d");
+        let point = editor.save_point();
+
+        editor.insert_text(&mut buffer, "e");
+        editor.mark_saved_at(point);
+        assert!(editor.has_unsaved_edits());
+
+        editor.backspace(&mut buffer);
+        assert!(!editor.has_unsaved_edits());
+    }
+
+    #[test]
+    fn undo_past_pending_save_point_stays_unsaved() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        editor.load_file(&mut buffer, "abc");
+        editor.move_to(&mut buffer, 0, 3, true);
+        editor.insert_text(&mut buffer, "d");
+        let point = editor.save_point();
+
+        editor.undo(&mut buffer);
+        editor.mark_saved_at(point);
+        assert!(editor.has_unsaved_edits());
+
+        editor.redo(&mut buffer);
+        assert!(!editor.has_unsaved_edits());
+    }
+
+    #[test]
+    fn compacted_history_undoes_and_redoes_the_same() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+
+        editor.load_file(&mut buffer, "abc");
+
+        let edits = [
+            vec![
+                Edit::Insert {
+                    pos: 3,
+                    text: "d".to_string(),
+                },
+                Edit::Insert {
+                    pos: 4,
+                    text: "ef".to_string(),
+                },
+            ],
+            vec![
+                Edit::Delete {
+                    start: 5,
+                    end: 6,
+                    deleted: "f".to_string(),
+                },
+                Edit::Delete {
+                    start: 4,
+                    end: 5,
+                    deleted: "e".to_string(),
+                },
+            ],
+        ];
+        for transaction in edits {
+            editor.begin_tx();
+            for edit in transaction {
+                edit.apply(&mut buffer);
+                editor.record_edit(edit);
+            }
+            editor.commit_tx();
+        }
+        editor.mark_saved();
+
+        assert!(editor.compact_history());
+        assert!(
+            editor
+                .history
+                .undo_stack()
+                .iter()
+                .all(|tx| tx.edits.len() == 1)
+        );
+        // Nothing was recorded since, so there is nothing left to shrink.
+        assert!(!editor.compact_history());
+
+        editor.undo(&mut buffer);
+        assert_eq!(buffer.get_text(), "abcdef");
+        editor.undo(&mut buffer);
+        assert_eq!(buffer.get_text(), "abc");
+
+        editor.redo(&mut buffer);
+        editor.redo(&mut buffer);
+        assert_eq!(buffer.get_text(), "abcd");
+        assert!(!editor.has_unsaved_edits());
+    }
+
+    #[test]
+    fn history_size_follows_undo_redo_and_compaction() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+        let assert_size = |editor: &Editor| {
+            assert_eq!(editor.history_size(), editor.history.walked_size());
+        };
+
+        editor.load_file(&mut buffer, "abc\n");
+        for text in ["d", "e", "\n", "fgh"] {
+            editor.insert_text(&mut buffer, text);
+            assert_size(&editor);
+        }
+
+        editor.undo(&mut buffer);
+        editor.undo(&mut buffer);
+        assert_size(&editor);
+        editor.redo(&mut buffer);
+        assert_size(&editor);
+
+        // A new edit drops what is left to redo.
+        editor.insert_text(&mut buffer, "x");
+        assert_size(&editor);
+
+        editor.mark_saved();
+        editor.compact_history();
+        assert_size(&editor);
+    }
+
+    #[test]
+    fn history_is_compacted_again_after_new_edits() {
+        let mut editor = Editor::new();
+        let mut buffer = Buffer::new();
+        editor.load_file(&mut buffer, "abc");
+
+        let record_typing = |editor: &mut Editor, buffer: &mut Buffer| {
+            let pos = buffer.get_text().len();
+            editor.begin_tx();
+            for (offset, text) in ["d", "e"].into_iter().enumerate() {
+                let edit = Edit::Insert {
+                    pos: pos + offset,
+                    text: text.to_string(),
+                };
+                edit.apply(buffer);
+                editor.record_edit(edit);
+            }
+            editor.commit_tx();
+            editor.mark_saved();
+        };
+
+        record_typing(&mut editor, &mut buffer);
+        assert!(editor.compact_history());
+        assert!(!editor.compact_history());
+
+        record_typing(&mut editor, &mut buffer);
+        assert!(editor.compact_history());
+        assert!(
+            editor
+                .history
+                .undo_stack()
+                .iter()
+                .all(|tx| tx.edits.len() == 1)
+        );
+    }
 }
@@ -21,6 +21,62 @@ impl Edit {
         }
     }
 
+    /// Folds `next`, applied right after this edit, into it when the two touch the same span
+    /// (typing forwards, deleting forwards or backspacing). Returns whether it was folded in.
+    fn absorb(&mut self, next: &Edit) -> bool {
+        match (self, next) {
+            (
+                Edit::Insert { pos, text },
+                Edit::Insert {
+                    pos: next_pos,
+                    text: next_text,
+                },
+            ) if *next_pos == *pos + text.len() => {
+                text.push_str(next_text);
+                true
+            }
+            (
+                Edit::Delete {
+                    start,
+                    end,
+                    deleted,
+                },
+                Edit::Delete {
+                    start: next_start,
+                    end: next_end,
+                    deleted: next_deleted,
+                },
+            ) => {
+                if *next_start == *start {
+                    *end += next_end - next_start;
+                    deleted.push_str(next_deleted);
+                    true
+                } else if *next_end == *start {
+                    *start = *next_start;
+                    deleted.insert_str(0, next_deleted);
+                    true
+                } else {
+                    false
+                }
+            }
+            _ => false,
+        }
+    }
+
+    fn text(&self) -> &str {
+        match self {
+            Edit::Insert { text, .. } => text,
+            Edit::Delete { deleted, .. } => deleted,
+        }
+    }
+
+    fn shrink_to_fit(&mut self) {
+        match self {
+            Edit::Insert { text, .. } => text.shrink_to_fit(),
+            Edit::Delete { deleted, .. } => deleted.shrink_to_fit(),
+        }
+    }
+
     pub fn invert(&self) -> Edit {
         match self {
             Edit::Insert { pos, text } => Edit::Delete {
@@ -36,6 +92,52 @@ impl Edit {
     }
 }
 
+/// A compact summary of an applied [`Edit`], used to notice when a later edit exactly reverses an
+/// earlier one without keeping a second copy of the edited text around.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+struct EditFingerprint {
+    inserted: bool,
+    pos: usize,
+    len: usize,
+    checksum: u32,
+}
+
+impl EditFingerprint {
+    fn of(edit: &Edit) -> Self {
+        let (inserted, pos, text) = match edit {
+            Edit::Insert { pos, text } => (true, *pos, text),
+            Edit::Delete { start, deleted, .. } => (false, *start, deleted),
+        };
+
+        Self {
+            inserted,
+            pos,
+            len: text.len(),
+            checksum: crc32fast::hash(text.as_bytes()),
+        }
+    }
+
+    fn reverses(&self, other: &Self) -> bool {
+        self.inserted != other.inserted
+            && self.pos == other.pos
+            && self.len == other.len
+            && self.checksum == other.checksum
+    }
+
+    /// The fingerprint of the edit that undoes this one.
+    fn inverted(&self) -> Self {
+        Self {
+            inserted: !self.inserted,
+            ..*self
+        }
+    }
+}
+
+/// The unsaved edits at the moment a save started. Once the save finishes, the save point is moved
+/// to the content that was actually written, even if editing continued in the meantime.
+#[derive(Clone, Debug, Default)]
+pub struct SavePoint(Vec<EditFingerprint>);
+
 #[derive(Clone, Debug)]
 pub struct ViewState {
     pub cursors: Vec<CursorEntry>,
@@ -50,12 +152,52 @@ pub struct Transaction {
     pub edits: Vec<Edit>,
 }
 
+impl Transaction {
+    fn approximate_size(&self) -> usize {
+        let cursors = self.before.cursors.capacity() + self.after.cursors.capacity();
+        let edits: usize = self.edits.iter().map(|edit| edit.text().len()).sum();
+
+        size_of::<Self>()
+            + cursors * size_of::<CursorEntry>()
+            + self.edits.capacity() * size_of::<Edit>()
+            + edits
+    }
+
+    fn compact(&mut self) {
+        let mut edits: Vec<Edit> = Vec::with_capacity(self.edits.len());
+
+        for edit in self.edits.drain(..) {
+            if !edits.last_mut().is_some_and(|last| last.absorb(&edit)) {
+                edits.push(edit);
+            }
+        }
+
+        for edit in &mut edits {
+            edit.shrink_to_fit();
+        }
+        edits.shrink_to_fit();
+
+        self.edits = edits;
+        self.before.cursors.shrink_to_fit();
+        self.after.cursors.shrink_to_fit();
+    }
+}
+
 #[derive(Debug)]
 pub struct UndoHistory {
-    pub undo: Vec<Transaction>,
-    pub redo: Vec<Transaction>,
+    undo: Vec<Transaction>,
+    redo: Vec<Transaction>,
     pub current: Option<Transaction>,
     next_id: usize,
+    /// Edits applied since the last save, where an edit that reverses the previous one cancels it
+    /// out. An empty stack means the buffer matches its saved content.
+    unsaved_edits: Vec<EditFingerprint>,
+    /// Set by [`Self::compact`] and cleared when a transaction is committed, so idle histories
+    /// are not walked again on every pass.
+    compacted: bool,
+    /// Sum of [`Transaction::approximate_size`] over both stacks, kept up to date as transactions
+    /// are pushed and popped so that measuring the history never walks it.
+    transactions_size: usize,
 }
 
 impl Default for UndoHistory {
@@ -65,6 +207,9 @@ impl Default for UndoHistory {
             redo: Vec::new(),
             current: None,
             next_id: 1,
+            unsaved_edits: Vec::new(),
+            compacted: false,
+            transactions_size: 0,
         }
     }
 }
@@ -76,6 +221,113 @@ impl UndoHistory {
         self.undo.last().map(|tx| tx.id).unwrap_or(0)
     }
 
+    /// Returns true if the edits applied since the last save did not cancel each other out.
+    ///
+    /// This costs O(1) per edit regardless of buffer size. Returning to the saved content through
+    /// an unrelated sequence of edits is conservatively reported as unsaved.
+    pub fn has_unsaved_edits(&self) -> bool {
+        !self.unsaved_edits.is_empty()
+    }
+
+    /// Records that `edit` was applied to the buffer (including edits replayed by undo/redo).
+    pub fn note_applied(&mut self, edit: &Edit) {
+        let fingerprint = EditFingerprint::of(edit);
+        if fingerprint.len == 0 {
+            return;
+        }
+
+        if self
+            .unsaved_edits
+            .last()
+            .is_some_and(|last| last.reverses(&fingerprint))
+        {
+            self.unsaved_edits.pop();
+        } else {
+            self.unsaved_edits.push(fingerprint);
+        }
+    }
+
+    /// Marks the current buffer content as saved.
+    pub fn mark_saved(&mut self) {
+        self.unsaved_edits.clear();
+    }
+
+    /// Captures the current content as a candidate save point, see [`Self::mark_saved_at`].
+    pub fn save_point(&self) -> SavePoint {
+        SavePoint(self.unsaved_edits.clone())
+    }
+
+    /// Marks the content captured by `point` as saved. Edits applied after it was taken stay
+    /// unsaved, including undos that went back past it.
+    pub fn mark_saved_at(&mut self, point: SavePoint) {
+        let common = point
+            .0
+            .iter()
+            .zip(&self.unsaved_edits)
+            .take_while(|(saved, current)| saved == current)
+            .count();
+
+        // Walk back from the saved content to where the two diverge, then forward to the current
+        // content.
+        let mut unsaved_edits: Vec<_> = point.0[common..]
+            .iter()
+            .rev()
+            .map(EditFingerprint::inverted)
+            .collect();
+        unsaved_edits.extend_from_slice(&self.unsaved_edits[common..]);
+
+        self.unsaved_edits = unsaved_edits;
+    }
+
+    /// Roughly how many bytes the undo and redo stacks take up.
+    pub fn approximate_size(&self) -> usize {
+        self.transactions_size
+            + (self.undo.capacity() - self.undo.len() + self.redo.capacity() - self.redo.len())
+                * size_of::<Transaction>()
+            + self.unsaved_edits.capacity() * size_of::<EditFingerprint>()
+    }
+
+    /// [`Self::approximate_size`] computed by walking both stacks, to check the running total
+    /// against.
+    #[cfg(test)]
+    pub(crate) fn walked_size(&self) -> usize {
+        let transactions: usize = self
+            .undo
+            .iter()
+            .chain(&self.redo)
+            .map(Transaction::approximate_size)
+            .sum();
+
+        self.approximate_size() - self.transactions_size + transactions
+    }
+
+    /// Merges consecutive edits within each transaction and releases spare capacity, without
+    /// changing what undo and redo do. Returns whether the history actually shrank.
+    ///
+    /// Skipped while there are unsaved edits: their fingerprints were taken of the edits as
+    /// recorded, and undoing a merged edit would no longer be recognized as reversing them. Also
+    /// skipped when nothing was recorded since the last compaction.
+    pub fn compact(&mut self) -> bool {
+        if self.compacted || self.has_unsaved_edits() || self.current.is_some() {
+            return false;
+        }
+
+        let size = self.approximate_size();
+
+        self.transactions_size = 0;
+        for transaction in self.undo.iter_mut().chain(self.redo.iter_mut()) {
+            transaction.compact();
+            self.transactions_size += transaction.approximate_size();
+        }
+
+        self.undo.shrink_to_fit();
+        self.redo.shrink_to_fit();
+        self.unsaved_edits.shrink_to_fit();
+        self.compacted = true;
+
+        self.approximate_size() < size
+    }
+
     pub fn begin(&mut self, before: ViewState) {
         if self.current.is_none() {
             self.current = Some(Transaction {
@@ -102,21 +354,41 @@ impl UndoHistory {
                 tx.id = self.next_id;
                 self.next_id += 1;
 
-                self.undo.push(tx);
-                self.redo.clear();
+                self.push_undo(tx);
+                for tx in self.redo.drain(..) {
+                    self.transactions_size -= tx.approximate_size();
+                }
+                self.compacted = false;
             }
         }
     }
 
-    pub fn undo(&mut self) -> Option<Transaction> {
-        self.undo.pop().inspect(|tx| {
-            self.redo.push(tx.clone());
-        })
+    /// The transactions that can be undone, oldest first.
+    pub fn undo_stack(&self) -> &[Transaction] {
+        &self.undo
+    }
+
+    /// Takes the transaction to undo. Once it is undone, it goes to [`Self::push_redo`].
+    pub fn pop_undo(&mut self) -> Option<Transaction> {
+        let tx = self.undo.pop()?;
+        self.transactions_size -= tx.approximate_size();
+        Some(tx)
+    }
+
+    /// Takes the transaction to redo. Once it is redone, it goes to [`Self::push_undo`].
+    pub fn pop_redo(&mut self) -> Option<Transaction> {
+        let tx = self.redo.pop()?;
+        self.transactions_size -= tx.approximate_size();
+        Some(tx)
+    }
+
+    pub fn push_undo(&mut self, tx: Transaction) {
+        self.transactions_size += tx.approximate_size();
+        self.undo.push(tx);
     }
 
-    pub fn redo(&mut self) -> Option<Transaction> {
-        self.redo.pop().inspect(|tx| {
-            self.undo.push(tx.clone());
-        })
+    pub fn push_redo(&mut self, tx: Transaction) {
+        self.transactions_size += tx.approximate_size();
+        self.redo.push(tx);
     }
 }
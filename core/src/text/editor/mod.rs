@@ -7,7 +7,7 @@ pub mod result;
 pub mod types;
 pub mod width_manager;
 
-pub use buffer::Buffer;
+pub use buffer::{Buffer, LoadedBuffer};
 pub use editor::Editor;
 pub use history::*;
 use result::*;
@@ -1,16 +1,241 @@
+use std::{collections::BTreeMap, ops::Range};
+
+/// Tracks the measured width of every line, along with the widest one.
+///
+/// Unmeasured lines are stored as `-1.0`. The maximum is kept in a count-by-width index so that
+/// updating, inserting or removing lines never requires rescanning every width.
 #[derive(Debug, Default)]
 pub struct WidthManager {
-    line_widths: Vec<f64>,
-    max_width: f64,
-    max_width_line: usize,
+    line_widths: LineWidths,
+    /// Number of measured lines per width, keyed by [`width_key`].
+    width_counts: BTreeMap<u64, usize>,
+    /// Rows invalidated since the last call to [`Self::take_dirty_rows`].
+    dirty_rows: Option<(usize, usize)>,
+}
+
+/// Measured widths are never negative, so their bit patterns sort the same way the widths do.
+/// Adding `0.0` folds `-0.0` into `0.0`.
+fn width_key(width: f64) -> u64 {
+    (width + 0.0).to_bits()
+}
+
+/// Rows per chunk of [`LineWidths`] when a chunk is split.
+const CHUNK_LEN: usize = 1024;
+
+/// Per-row widths, stored in chunks of up to `2 * CHUNK_LEN` rows.
+///
+/// Inserting or removing rows only moves widths within the chunks it touches (plus the chunk
+/// index), instead of every width below the edit. Rows are found by binary search over the first
+/// row of each chunk, and each chunk counts its unmeasured rows so that finding the next one skips
+/// over measured chunks.
+#[derive(Debug, Default)]
+struct LineWidths {
+    chunks: Vec<Chunk>,
+    /// First row of each chunk.
+    starts: Vec<usize>,
+    len: usize,
+}
+
+#[derive(Debug, Default)]
+struct Chunk {
+    widths: Vec<f64>,
+    /// Number of rows in `widths` that are unmeasured.
+    unmeasured: usize,
+}
+
+fn is_unmeasured(width: f64) -> bool {
+    width == -1.0
+}
+
+impl Chunk {
+    fn new(widths: Vec<f64>) -> Self {
+        let unmeasured = widths.iter().filter(|&&width| is_unmeasured(width)).count();
+        Self { widths, unmeasured }
+    }
+
+    fn append(&mut self, other: Chunk) {
+        self.widths.extend(other.widths);
+        self.unmeasured += other.unmeasured;
+    }
+}
+
+impl LineWidths {
+    fn filled(len: usize, width: f64) -> Self {
+        let mut widths = Self::default();
+        widths.insert(0, len, width);
+        widths
+    }
+
+    fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns the chunk holding `row` and the row's offset in it. `len` maps to the end of the
+    /// last chunk.
+    fn locate(&self, row: usize) -> (usize, usize) {
+        let idx = self
+            .starts
+            .partition_point(|&start| start <= row)
+            .saturating_sub(1);
+
+        (idx, row - self.starts.get(idx).copied().unwrap_or(0))
+    }
+
+    fn get(&self, row: usize) -> f64 {
+        let (idx, offset) = self.locate(row);
+        self.chunks[idx].widths[offset]
+    }
+
+    fn replace(&mut self, row: usize, width: f64) -> f64 {
+        let (idx, offset) = self.locate(row);
+        let chunk = &mut self.chunks[idx];
+        let old = std::mem::replace(&mut chunk.widths[offset], width);
+
+        chunk.unmeasured =
+            chunk.unmeasured + usize::from(is_unmeasured(width)) - usize::from(is_unmeasured(old));
+        old
+    }
+
+    /// Widths from `row` to the last row.
+    #[cfg(test)]
+    fn iter_from(&self, row: usize) -> impl Iterator<Item = f64> + '_ {
+        let (idx, offset) = self.locate(row.min(self.len));
+        let head = self
+            .chunks
+            .get(idx)
+            .map_or(&[][..], |chunk| &chunk.widths[offset..]);
+        let rest = self.chunks.get(idx + 1..).unwrap_or_default();
+
+        head.iter()
+            .chain(rest.iter().flat_map(|chunk| &chunk.widths))
+            .copied()
+    }
+
+    /// Returns the first unmeasured row in `rows`, skipping chunks without one.
+    fn next_unmeasured(&self, rows: Range<usize>) -> Option<usize> {
+        let end = rows.end.min(self.len);
+        if rows.start >= end {
+            return None;
+        }
+
+        let (first, offset) = self.locate(rows.start);
+
+        for (idx, chunk) in self.chunks.iter().enumerate().skip(first) {
+            let start = self.starts[idx];
+            if start >= end {
+                break;
+            }
+            if chunk.unmeasured == 0 {
+                continue;
+            }
+
+            let from = if idx == first { offset } else { 0 };
+            let to = chunk.widths.len().min(end - start);
+            if let Some(position) = chunk.widths[from.min(to)..to]
+                .iter()
+                .position(|&width| is_unmeasured(width))
+            {
+                return Some(start + from + position);
+            }
+        }
+
+        None
+    }
+
+    fn insert(&mut self, row: usize, count: usize, width: f64) {
+        if count == 0 {
+            return;
+        }
+
+        if self.chunks.is_empty() {
+            self.chunks.push(Chunk::default());
+        }
+
+        let (idx, offset) = self.locate(row);
+        let chunk = &mut self.chunks[idx];
+        let tail = chunk.widths.split_off(offset);
+        chunk.widths.extend(std::iter::repeat_n(width, count));
+        chunk.widths.extend(tail);
+        if is_unmeasured(width) {
+            chunk.unmeasured += count;
+        }
+        self.len += count;
+
+        if chunk.widths.len() > 2 * CHUNK_LEN {
+            let widths = std::mem::take(&mut chunk.widths);
+            let pieces: Vec<Chunk> = widths
+                .chunks(CHUNK_LEN)
+                .map(|piece| Chunk::new(piece.to_vec()))
+                .collect();
+            self.chunks.splice(idx..=idx, pieces);
+        }
+
+        self.reindex(idx);
+    }
+
+    /// Removes the rows in `start..end` and returns their widths.
+    fn remove(&mut self, start: usize, end: usize) -> Vec<f64> {
+        let mut removed = Vec::with_capacity(end - start);
+        let (first, mut offset) = self.locate(start);
+        let mut idx = first;
+
+        while removed.len() < end - start {
+            let chunk = &mut self.chunks[idx];
+            let take = (chunk.widths.len() - offset).min(end - start - removed.len());
+            for width in chunk.widths.drain(offset..offset + take) {
+                if is_unmeasured(width) {
+                    chunk.unmeasured -= 1;
+                }
+                removed.push(width);
+            }
+            offset = 0;
+            idx += 1;
+        }
+
+        self.len -= removed.len();
+        self.chunks.retain(|chunk| !chunk.widths.is_empty());
+
+        // Keep chunks from fragmenting into many small ones around the removed range.
+        for idx in [first, first.saturating_sub(1)] {
+            if idx + 1 < self.chunks.len()
+                && self.chunks[idx].widths.len() + self.chunks[idx + 1].widths.len() <= CHUNK_LEN
+            {
+                let next = self.chunks.remove(idx + 1);
+                self.chunks[idx].append(next);
+            }
+        }
+
+        self.reindex(first.saturating_sub(1));
+        removed
+    }
+
+    /// Recomputes the first row of every chunk from `from` on.
+    fn reindex(&mut self, from: usize) {
+        let from = from.min(self.starts.len()).min(self.chunks.len());
+        self.starts.truncate(from);
+
+        let mut start = from
+            .checked_sub(1)
+            .map_or(0, |prev| self.starts[prev] + self.chunks[prev].widths.len());
+
+        for chunk in &self.chunks[from..] {
+            self.starts.push(start);
+            start += chunk.widths.len();
+        }
+    }
 }
 
 impl WidthManager {
     pub fn new() -> Self {
+        Self::with_line_count(1)
+    }
+
+    /// Creates a manager with `line_count` unmeasured rows, without reporting them as dirty.
+    pub fn with_line_count(line_count: usize) -> Self {
         Self {
-            line_widths: vec![-1.0],
-            max_width: 0.0,
-            max_width_line: 0,
+            line_widths: LineWidths::filled(line_count, -1.0),
+            width_counts: BTreeMap::new(),
+            dirty_rows: None,
         }
     }
 
@@ -20,78 +245,156 @@ impl WidthManager {
             return false;
         }
 
-        self.line_widths[line_idx] == -1.0
+        is_unmeasured(self.line_widths.get(line_idx))
     }
 
     pub fn max_width(&self) -> f64 {
-        self.max_width
+        self.width_counts
+            .last_key_value()
+            .map_or(0.0, |(&key, _)| f64::from_bits(key))
     }
 
-    // Setters
-    pub fn invalidate_line_width(&mut self, line_idx: usize) {
-        if line_idx >= self.line_widths.len() {
-            return;
+    /// Returns up to `limit` rows in `first..=last` that still need a width measurement.
+    pub fn unmeasured_lines(&self, first: usize, last: usize, limit: usize) -> Vec<usize> {
+        let mut lines = Vec::new();
+        let mut row = first;
+
+        while lines.len() < limit {
+            let Some(line) = self
+                .line_widths
+                .next_unmeasured(row..last.saturating_add(1))
+            else {
+                break;
+            };
+
+            lines.push(line);
+            row = line + 1;
         }
 
-        self.line_widths[line_idx] = -1.0;
+        lines
+    }
+
+    // Setters
+    /// Returns and resets the range of rows invalidated since the previous call.
+    pub fn take_dirty_rows(&mut self) -> Option<(usize, usize)> {
+        self.dirty_rows.take()
+    }
 
-        if line_idx == self.max_width_line {
-            self.recalculate_max_width();
+    fn mark_dirty(&mut self, first: usize, last: usize) {
+        self.dirty_rows = Some(match self.dirty_rows {
+            Some((a, b)) => (a.min(first), b.max(last)),
+            None => (first, last),
+        });
+    }
+
+    fn count_width(&mut self, width: f64) {
+        if width >= 0.0 {
+            *self.width_counts.entry(width_key(width)).or_insert(0) += 1;
         }
     }
 
-    fn recalculate_max_width(&mut self) {
-        self.max_width = 0.0;
-        self.max_width_line = 0;
+    fn uncount_width(&mut self, width: f64) {
+        if width < 0.0 {
+            return;
+        }
 
-        for (idx, &width) in self.line_widths.iter().enumerate() {
-            if width > self.max_width {
-                self.max_width = width;
-                self.max_width_line = idx;
+        let key = width_key(width);
+        if let Some(count) = self.width_counts.get_mut(&key) {
+            *count -= 1;
+
+            if *count == 0 {
+                self.width_counts.remove(&key);
             }
         }
     }
 
+    pub fn invalidate_line_width(&mut self, line_idx: usize) {
+        if line_idx >= self.line_widths.len() {
+            return;
+        }
+
+        let old = self.line_widths.replace(line_idx, -1.0);
+        self.uncount_width(old);
+        self.mark_dirty(line_idx, line_idx);
+    }
+
     pub fn update_line_width(&mut self, line_idx: usize, width: f64) {
         if line_idx >= self.line_widths.len() {
             return;
         }
 
-        let old = self.line_widths[line_idx];
-        self.line_widths[line_idx] = width;
+        let old = self.line_widths.replace(line_idx, width);
+        self.uncount_width(old);
+        self.count_width(width);
+    }
 
-        if width > self.max_width {
-            self.max_width = width;
-            self.max_width_line = line_idx;
-        } else if line_idx == self.max_width_line && width < old {
-            self.recalculate_max_width();
+    /// Inserts `count` unmeasured rows before `line_idx`, shifting the widths of the following rows
+    /// down instead of discarding them.
+    pub fn insert_lines(&mut self, line_idx: usize, count: usize) {
+        if count == 0 || line_idx > self.line_widths.len() {
+            return;
         }
+
+        self.line_widths.insert(line_idx, count, -1.0);
+
+        // Rows already dirty below the insertion point moved down with their lines.
+        self.dirty_rows = self.dirty_rows.map(|(first, last)| {
+            let shift = |row: usize| if row >= line_idx { row + count } else { row };
+            (shift(first), shift(last))
+        });
+        self.mark_dirty(line_idx, line_idx + count - 1);
+    }
+
+    /// Removes `count` rows starting at `line_idx`, shifting the widths of the following rows up.
+    pub fn remove_lines(&mut self, line_idx: usize, count: usize) {
+        let end = line_idx.saturating_add(count).min(self.line_widths.len());
+        if line_idx >= end {
+            return;
+        }
+
+        for width in self.line_widths.remove(line_idx, end) {
+            self.uncount_width(width);
+        }
+
+        // Dirty rows below the removed range move up with their lines; removed ones are dropped.
+        let removed = end - line_idx;
+        self.dirty_rows = self.dirty_rows.and_then(|(first, last)| {
+            let first = if first >= end {
+                first - removed
+            } else {
+                first.min(line_idx)
+            };
+            let last = if last >= end {
+                last - removed
+            } else if last >= line_idx {
+                line_idx.checked_sub(1)?
+            } else {
+                last
+            };
+
+            (first <= last).then_some((first, last))
+        });
     }
 
     pub fn sync_line_widths(&mut self, line_count: usize) {
-        match line_count.cmp(&self.line_widths.len()) {
-            std::cmp::Ordering::Greater => {
-                // Buffer grew, add invalidated entries
-                self.line_widths.resize(line_count, -1.0);
-            }
-            std::cmp::Ordering::Less => {
-                // Buffer shrunk, remove entries
-                self.line_widths.truncate(line_count);
+        let len = self.line_widths.len();
 
-                // If we removed the max width line, recalculate
-                if self.max_width_line >= line_count {
-                    self.recalculate_max_width();
-                }
-            }
+        match line_count.cmp(&len) {
+            // Buffer grew, add invalidated entries
+            std::cmp::Ordering::Greater => self.insert_lines(len, line_count - len),
+            // Buffer shrunk, remove entries
+            std::cmp::Ordering::Less => self.remove_lines(line_count, len - line_count),
             std::cmp::Ordering::Equal => {}
         }
     }
 
     pub fn clear_and_rebuild_line_widths(&mut self, line_count: usize) {
-        self.line_widths.clear();
-        self.line_widths.resize(line_count, -1.0);
-        self.max_width = 0.0;
-        self.max_width_line = 0;
+        self.line_widths = LineWidths::filled(line_count, -1.0);
+        self.width_counts.clear();
+
+        if line_count > 0 {
+            self.mark_dirty(0, line_count - 1);
+        }
     }
 }
 
@@ -230,4 +533,230 @@ mod tests {
         // Max should become 10.0
         assert_f64_eq(w.max_width(), 10.0);
     }
+
+    #[test]
+    fn unmeasured_lines_returns_only_invalid_rows_in_range() {
+        let mut w = WidthManager::with_line_count(5);
+
+        w.update_line_width(0, 1.0);
+        w.update_line_width(2, 1.0);
+
+        assert_eq!(w.unmeasured_lines(0, 4, usize::MAX), vec![1, 3, 4]);
+        assert_eq!(w.unmeasured_lines(2, 3, usize::MAX), vec![3]);
+        assert_eq!(w.unmeasured_lines(0, 4, 2), vec![1, 3]);
+        assert!(w.unmeasured_lines(10, 20, usize::MAX).is_empty());
+    }
+
+    #[test]
+    fn unmeasured_lines_sees_rows_invalidated_after_measurement() {
+        let mut w = WidthManager::with_line_count(3);
+
+        for line in 0..3 {
+            w.update_line_width(line, 4.0);
+        }
+        assert!(w.unmeasured_lines(0, 2, usize::MAX).is_empty());
+
+        w.invalidate_line_width(1);
+        assert_eq!(w.unmeasured_lines(0, 2, usize::MAX), vec![1]);
+    }
+
+    #[test]
+    fn with_line_count_does_not_report_dirty_rows() {
+        let mut w = WidthManager::with_line_count(3);
+
+        assert!(w.needs_width_measurement(2));
+        assert_eq!(w.take_dirty_rows(), None);
+    }
+
+    #[test]
+    fn take_dirty_rows_merges_invalidations_and_resets() {
+        let mut w = WidthManager::with_line_count(10);
+
+        w.invalidate_line_width(4);
+        w.invalidate_line_width(2);
+        w.sync_line_widths(12);
+
+        assert_eq!(w.take_dirty_rows(), Some((2, 11)));
+        assert_eq!(w.take_dirty_rows(), None);
+
+        w.clear_and_rebuild_line_widths(3);
+        assert_eq!(w.take_dirty_rows(), Some((0, 2)));
+    }
+
+    #[test]
+    fn insert_lines_shifts_existing_widths_down() {
+        let mut w = WidthManager::with_line_count(3);
+
+        w.update_line_width(0, 1.0);
+        w.update_line_width(1, 2.0);
+        w.update_line_width(2, 3.0);
+
+        w.insert_lines(1, 2);
+
+        assert!(!w.needs_width_measurement(0));
+        assert!(w.needs_width_measurement(1));
+        assert!(w.needs_width_measurement(2));
+        assert!(!w.needs_width_measurement(3));
+        assert!(!w.needs_width_measurement(4));
+        assert_eq!(w.unmeasured_lines(0, 4, usize::MAX), vec![1, 2]);
+        assert_f64_eq(w.max_width(), 3.0);
+    }
+
+    #[test]
+    fn remove_lines_shifts_widths_up_and_updates_max() {
+        let mut w = WidthManager::with_line_count(5);
+
+        for (line, width) in [1.0, 9.0, 4.0, 2.0, 3.0].into_iter().enumerate() {
+            w.update_line_width(line, width);
+        }
+
+        // Remove the widest line along with its neighbour
+        w.remove_lines(1, 2);
+
+        assert_f64_eq(w.max_width(), 3.0);
+        assert!(w.unmeasured_lines(0, 2, usize::MAX).is_empty());
+        assert!(!w.needs_width_measurement(1));
+        assert!(!w.needs_width_measurement(2));
+    }
+
+    #[test]
+    fn remove_lines_clamps_to_line_count() {
+        let mut w = WidthManager::with_line_count(3);
+
+        w.update_line_width(0, 5.0);
+        w.remove_lines(1, 100);
+
+        assert!(!w.needs_width_measurement(1));
+        assert_f64_eq(w.max_width(), 5.0);
+    }
+
+    #[test]
+    fn max_width_survives_invalidating_one_of_several_equal_widest_lines() {
+        let mut w = WidthManager::with_line_count(3);
+
+        w.update_line_width(0, 8.0);
+        w.update_line_width(1, 8.0);
+        w.update_line_width(2, 2.0);
+
+        w.invalidate_line_width(0);
+        assert_f64_eq(w.max_width(), 8.0);
+
+        w.invalidate_line_width(1);
+        assert_f64_eq(w.max_width(), 2.0);
+    }
+
+    #[test]
+    fn remove_lines_keeps_unmeasured_rows_after_the_removed_range() {
+        let mut w = WidthManager::with_line_count(4);
+
+        w.update_line_width(0, 1.0);
+        w.update_line_width(1, 1.0);
+        w.update_line_width(2, 1.0);
+
+        w.remove_lines(0, 2);
+
+        assert_eq!(w.unmeasured_lines(0, 1, usize::MAX), vec![1]);
+    }
+
+    #[test]
+    fn remove_lines_shifts_and_clamps_dirty_rows() {
+        let mut w = WidthManager::with_line_count(10);
+
+        w.invalidate_line_width(8);
+        w.remove_lines(2, 3);
+        assert_eq!(w.take_dirty_rows(), Some((5, 5)));
+
+        w.invalidate_line_width(3);
+        w.invalidate_line_width(6);
+        w.remove_lines(5, 2);
+        assert_eq!(w.take_dirty_rows(), Some((3, 4)));
+
+        w.invalidate_line_width(1);
+        w.remove_lines(0, 3);
+        assert_eq!(w.take_dirty_rows(), None);
+    }
+
+    #[test]
+    fn insert_lines_shifts_dirty_rows_below_the_insertion() {
+        let mut w = WidthManager::with_line_count(10);
+
+        w.invalidate_line_width(8);
+        w.insert_lines(2, 3);
+
+        assert_eq!(w.take_dirty_rows(), Some((2, 11)));
+    }
+
+    #[test]
+    fn edits_across_chunks_keep_every_row_in_place() {
+        let line_count = CHUNK_LEN * 5 + 7;
+        let mut w = WidthManager::with_line_count(line_count);
+        let mut expected: Vec<f64> = (0..line_count).map(|line| line as f64).collect();
+
+        for (line, &width) in expected.iter().enumerate() {
+            w.update_line_width(line, width);
+        }
+
+        for (at, count) in [
+            (CHUNK_LEN - 3, 10),
+            (0, 2 * CHUNK_LEN + 1),
+            (line_count / 2, 5),
+        ] {
+            w.insert_lines(at, count);
+            expected.splice(at..at, std::iter::repeat_n(-1.0, count));
+        }
+
+        for (at, count) in [(CHUNK_LEN * 2 - 1, CHUNK_LEN + 2), (5, 1), (0, 7)] {
+            w.remove_lines(at, count);
+            expected.drain(at..at + count);
+        }
+
+        assert_eq!(w.line_widths.len(), expected.len());
+        assert_eq!(w.line_widths.iter_from(0).collect::<Vec<_>>(), expected);
+        for (line, &width) in expected.iter().enumerate() {
+            assert_eq!(w.needs_width_measurement(line), width == -1.0);
+        }
+        for chunk in &w.line_widths.chunks {
+            assert_eq!(
+                chunk.unmeasured,
+                Chunk::new(chunk.widths.clone()).unmeasured
+            );
+        }
+
+        let unmeasured: Vec<usize> = (0..expected.len())
+            .filter(|&line| expected[line] == -1.0)
+            .collect();
+        assert_eq!(
+            w.unmeasured_lines(0, expected.len(), usize::MAX),
+            unmeasured
+        );
+
+        let max = expected.iter().copied().fold(0.0, f64::max);
+        assert_f64_eq(w.max_width(), max);
+    }
+
+    #[test]
+    fn unmeasured_lines_skip_measured_chunks() {
+        let line_count = CHUNK_LEN * 4;
+        let mut w = WidthManager::with_line_count(line_count);
+        for line in 0..line_count {
+            w.update_line_width(line, 1.0);
+        }
+
+        w.invalidate_line_width(CHUNK_LEN * 3 + 5);
+        w.invalidate_line_width(CHUNK_LEN * 3 + 9);
+
+        assert_eq!(
+            w.unmeasured_lines(0, line_count - 1, 1),
+            vec![CHUNK_LEN * 3 + 5]
+        );
+        assert_eq!(
+            w.unmeasured_lines(CHUNK_LEN * 3 + 6, line_count - 1, 10),
+            vec![CHUNK_LEN * 3 + 9]
+        );
+        assert!(w.unmeasured_lines(0, CHUNK_LEN * 3 + 4, 10).is_empty());
+
+        w.update_line_width(CHUNK_LEN * 3 + 5, 2.0);
+        w.update_line_width(CHUNK_LEN * 3 + 9, 2.0);
+        assert!(w.unmeasured_lines(0, line_count - 1, 10).is_empty());
+    }
 }
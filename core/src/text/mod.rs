@@ -5,8 +5,11 @@ pub mod selection;
 pub mod view;
 
 pub use cursor::{CursorManager, types::*};
-pub use document::{Document, DocumentManager, error::*, result::*, types::*};
+pub use document::{
+    Document, DocumentLoad, DocumentLoadEvent, DocumentManager, DocumentSave, error::*, result::*,
+    types::*,
+};
 pub use editor::types::*;
-pub use editor::{Buffer, Edit, Editor, Transaction, UndoHistory, ViewState};
+pub use editor::{Buffer, Edit, Editor, SavePoint, Transaction, UndoHistory, ViewState};
 pub use selection::{SelectionManager, types::*};
 pub use view::{View, ViewId, ViewManager, Viewport};
@@ -18,6 +18,16 @@ impl Selection {
         }
     }
 
+    /// Builds a selection from its parts, e.g. one restored from a saved session.
+    pub(crate) fn from_parts(start: Cursor, end: Cursor, anchor: Cursor, active: bool) -> Self {
+        Self {
+            start,
+            end,
+            anchor,
+            active,
+        }
+    }
+
     pub fn is_active(&self) -> bool {
         self.active && self.start != self.end
     }
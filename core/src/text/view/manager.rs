@@ -62,6 +62,24 @@ impl ViewManager {
             .any(|view| view.document_id() == document_id)
     }
 
+    pub fn views(&self) -> impl Iterator<Item = &View> {
+        self.views.values()
+    }
+
+    pub fn views_mut(&mut self) -> impl Iterator<Item = &mut View> {
+        self.views.values_mut()
+    }
+
+    /// Returns every view that is showing the given document.
+    pub fn views_for_document_mut(
+        &mut self,
+        document_id: DocumentId,
+    ) -> impl Iterator<Item = &mut View> {
+        self.views
+            .values_mut()
+            .filter(move |view| view.document_id() == document_id)
+    }
+
     /// Creates a new [`View`] and returns the corresponding [`ViewId`].
     pub fn create_view(&mut self, document_id: DocumentId, editor: Editor) -> ViewId {
         let id = self.generate_next_id();
@@ -4,13 +4,123 @@
 AppBridge::AppBridge(const AppBridgeProps &props)
     : appController(
           neko::new_app_controller(props.configManager, props.rootPath)),
-      commandController(appController->command_controller()) {}
+      commandController(appController->command_controller()) {
+  backgroundIoTimer.setInterval(BACKGROUND_IO_POLL_INTERVAL_MS);
+  connect(&backgroundIoTimer, &QTimer::timeout, this,
+          &AppBridge::pollBackgroundIo);
+
+  diskChangeTimer.setInterval(DISK_CHANGE_POLL_INTERVAL_MS);
+  connect(&diskChangeTimer, &QTimer::timeout, this,
+          &AppBridge::pollDiskChanges);
+  diskChangeTimer.start();
+
+  prefetchTimer.setSingleShot(true);
+  prefetchTimer.setInterval(PREFETCH_DELAY_MS);
+  connect(&prefetchTimer, &QTimer::timeout, this,
+          &AppBridge::prefetchDocuments);
+
+  memoryBudgetTimer.setInterval(MEMORY_BUDGET_INTERVAL_MS);
+  connect(&memoryBudgetTimer, &QTimer::timeout, this,
+          &AppBridge::enforceMemoryBudget);
+  memoryBudgetTimer.start();
+
+  sessionSaveTimer.setInterval(SESSION_SAVE_INTERVAL_MS);
+  connect(&sessionSaveTimer, &QTimer::timeout, this,
+          &AppBridge::sessionSaveDue);
+  sessionSaveTimer.start();
+}
 
 neko::OpenTabResultFfi AppBridge::openFile(const QString &path,
                                            bool addToHistory) {
   return appController->ensure_tab_for_path(path.toStdString(), addToHistory);
 }
 
+neko::OpenTabResultFfi AppBridge::openFileInBackground(const QString &path,
+                                                       bool addToHistory) {
+  auto result = appController->ensure_tab_for_path_in_background(
+      path.toStdString(), addToHistory);
+  startBackgroundIoPolling();
+
+  return result;
+}
+
+neko::OpenTabResultFfi AppBridge::openFileDeferred(const QString &path,
+                                                   bool addToHistory) {
+  auto result = appController->ensure_tab_for_path_deferred(path.toStdString(),
+                                                            addToHistory);
+  prefetchTimer.start();
+
+  return result;
+}
+
+void AppBridge::activeDocumentChanged() {
+  startBackgroundIoPolling();
+  prefetchTimer.start();
+}
+
+bool AppBridge::restoreSession() {
+  if (!appController->restore_session()) {
+    return false;
+  }
+
+  startBackgroundIoPolling();
+  prefetchTimer.start();
+
+  return true;
+}
+
+void AppBridge::saveSession() { appController->save_session(); }
+
+void AppBridge::saveSessionInBackground() {
+  appController->save_session_in_background();
+}
+
+void AppBridge::startBackgroundIoPolling() {
+  if (!backgroundIoTimer.isActive() &&
+      appController->has_pending_document_io()) {
+    backgroundIoTimer.start();
+  }
+}
+
+void AppBridge::pollBackgroundIo() {
+  for (const auto &event : appController->poll_document_loads()) {
+    emit documentLoadUpdated(event);
+  }
+
+  for (const auto &event : appController->poll_document_saves()) {
+    emit documentSaveFinished(event.document_id, event.succeeded);
+  }
+
+  if (!appController->has_pending_document_io()) {
+    backgroundIoTimer.stop();
+  }
+}
+
+void AppBridge::prefetchDocuments() {
+  // Prefetching only runs while nothing else is being read or written, so it
+  // never delays the file the user is waiting on.
+  if (appController->has_pending_document_io()) {
+    prefetchTimer.start();
+    return;
+  }
+
+  if (appController->prefetch_documents(PREFETCH_TAB_COUNT) > 0) {
+    startBackgroundIoPolling();
+  }
+}
+
+void AppBridge::enforceMemoryBudget() {
+  const auto usage = appController->enforce_memory_budget();
+  emit memoryUsageChanged(usage.used_bytes, usage.budget_bytes);
+}
+
+void AppBridge::pollDiskChanges() {
+  for (const uint64_t documentId :
+       appController->poll_document_disk_changes()) {
+    emit documentChangedOnDisk(documentId);
+  }
+}
+
 rust::Box<neko::EditorController> AppBridge::getEditorController() const {
   return appController->editor_controller();
 }
@@ -64,6 +174,21 @@ bool AppBridge::saveDocumentAs(uint64_t documentId, const std::string &path) {
   return appController->save_document_as(documentId, path);
 }
 
+bool AppBridge::saveDocumentInBackground(uint64_t documentId) {
+  const bool started = appController->begin_save_document(documentId);
+  startBackgroundIoPolling();
+
+  return started;
+}
+
+bool AppBridge::saveDocumentAsInBackground(uint64_t documentId,
+                                           const std::string &path) {
+  const bool started = appController->begin_save_document_as(documentId, path);
+  startBackgroundIoPolling();
+
+  return started;
+}
+
 neko::CommandController *AppBridge::getCommandController() {
   return &*commandController;
 }
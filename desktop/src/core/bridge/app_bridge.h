@@ -3,6 +3,7 @@
 
 #include "types/command_type.h"
 #include <QObject>
+#include <QTimer>
 #include <neko-core/src/ffi/bridge.rs.h>
 #include <vector>
 
@@ -35,6 +36,22 @@ public:
   neko::MoveActiveTabResult moveTabBy(neko::Buffer buffer, int delta,
                                       bool useHistory);
   neko::OpenTabResultFfi openFile(const QString &path, bool addToHistory);
+  neko::OpenTabResultFfi openFileInBackground(const QString &path,
+                                              bool addToHistory);
+  /// Opens a tab for `path` without reading the file, which is loaded once the
+  /// tab is activated or prefetched.
+  neko::OpenTabResultFfi openFileDeferred(const QString &path,
+                                          bool addToHistory);
+  /// Picks up the load the core starts when a tab whose file was not read yet
+  /// is activated, and schedules prefetching the tabs likely to be shown next.
+  void activeDocumentChanged();
+  /// Reopens the tabs of the last session, if any, and starts loading the
+  /// active one. Returns whether anything was restored.
+  bool restoreSession();
+  /// Saves the session right away, e.g. when the app is about to quit.
+  void saveSession();
+  /// Saves the session on a worker thread if it changed since the last save.
+  void saveSessionInBackground();
   bool moveTab(int fromIndex, int toIndex);
   neko::PinTabResult pinTab(int tabId);
   neko::PinTabResult unpinTab(int tabId);
@@ -88,12 +105,53 @@ public:
 
   bool saveDocument(uint64_t documentId);
   bool saveDocumentAs(uint64_t documentId, const std::string &path);
+  bool saveDocumentInBackground(uint64_t documentId);
+  bool saveDocumentAsInBackground(uint64_t documentId,
+                                  const std::string &path);
 
   [[nodiscard]] neko::CommandController *getCommandController();
 
+signals:
+  void documentLoadUpdated(const neko::DocumentLoadEventFfi &event);
+  void documentSaveFinished(uint64_t documentId, bool succeeded);
+  void documentChangedOnDisk(uint64_t documentId);
+  /// `budgetBytes` is 0 if no budget is configured.
+  void memoryUsageChanged(uint64_t usedBytes, uint64_t budgetBytes);
+  /// Emitted periodically so the UI can store state the core only learns
+  /// about on request (like the active tab's scroll offsets) and call
+  /// `saveSessionInBackground`.
+  void sessionSaveDue();
+
 private:
+  void startBackgroundIoPolling();
+  void pollBackgroundIo();
+  void prefetchDocuments();
+  void enforceMemoryBudget();
+  void pollDiskChanges();
+
   rust::Box<neko::AppController> appController;
   rust::Box<neko::CommandController> commandController;
+
+  // Polls the core for files being loaded or saved on worker threads while
+  // any are pending.
+  QTimer backgroundIoTimer;
+  // Picks up open documents whose files were changed outside the editor.
+  QTimer diskChangeTimer;
+  // Fires once tab switching settles, to start reading deferred files.
+  QTimer prefetchTimer;
+  // Unloads files in the background when open files use more memory than
+  // configured.
+  QTimer memoryBudgetTimer;
+  // Asks for the session to be saved, which only writes if it changed.
+  QTimer sessionSaveTimer;
+
+  static constexpr int BACKGROUND_IO_POLL_INTERVAL_MS = 16;
+  static constexpr int DISK_CHANGE_POLL_INTERVAL_MS = 500;
+  static constexpr int PREFETCH_DELAY_MS = 300;
+  static constexpr int MEMORY_BUDGET_INTERVAL_MS = 2000;
+  static constexpr int SESSION_SAVE_INTERVAL_MS = 1000;
+  // Most recently shown tabs whose files are read ahead of being switched to.
+  static constexpr uint32_t PREFETCH_TAB_COUNT = 4;
 };
 
 #endif
@@ -2,33 +2,24 @@
 #include "neko-core/src/ffi/bridge.rs.h"
 #include <QApplication>
 #include <QClipboard>
+#include <QMetaObject>
+#include <utility>
 
 EditorBridge::EditorBridge(EditorBridgeProps props)
     : editorController(std::move(props.editorController)) {}
 
-bool EditorBridge::isEmpty() const {
-  return editorController->buffer_is_empty();
-}
-
 QString EditorBridge::getLine(const int index) const {
   return QString::fromUtf8(editorController->get_line(index));
 }
 
-QStringList EditorBridge::getLines() const {
-  const auto rawLines = editorController->lines();
-  QStringList lines = QStringList();
-
-  for (const auto &line : rawLines) {
-    lines.append(QString::fromUtf8(line));
-  }
-
-  return lines;
-}
-
 int EditorBridge::getLineCount() const {
   return static_cast<int>(editorController->get_line_count());
 }
 
+int EditorBridge::getLayoutLineCount() const {
+  return static_cast<int>(editorController->get_layout_line_count());
+}
+
 Selection EditorBridge::getSelection() {
   const auto selection = editorController->get_selection();
   return {
@@ -54,20 +45,20 @@ std::vector<Cursor> EditorBridge::getCursorPositions() const {
   return cursors;
 }
 
-bool EditorBridge::needsWidthMeasurement(const int index) const {
-  return editorController->needs_width_measurement(index);
+int EditorBridge::getCursorCount() const {
+  return static_cast<int>(editorController->get_cursor_summary().cursor_count);
 }
 
 double EditorBridge::getMaxWidth() const {
   return editorController->get_max_width();
 }
 
-bool EditorBridge::cursorExistsAt(const int row, const int column) const {
-  return editorController->cursor_exists_at(row, column);
+uint64_t EditorBridge::getViewId() const {
+  return editorController->get_view_id();
 }
 
-bool EditorBridge::bufferIsEmpty() const {
-  return editorController->buffer_is_empty();
+bool EditorBridge::cursorExistsAt(const int row, const int column) const {
+  return editorController->cursor_exists_at(row, column);
 }
 
 int EditorBridge::getNumberOfSelections() const {
@@ -86,13 +77,103 @@ int EditorBridge::getLineLength(int index) const {
   return static_cast<int>(editorController->line_length(index));
 }
 
-void EditorBridge::setLineWidth(const int index, const double width) {
-  editorController->update_line_width(index, width);
+const RenderSnapshot &EditorBridge::getRenderSnapshot(const int firstRow,
+                                                     const int lastRow) {
+  const int clampedFirstRow = std::max(0, firstRow);
+  const int clampedLastRow = std::max(clampedFirstRow, lastRow);
+
+  // Rows are clamped to the buffer in the core, so a cached snapshot also
+  // covers any request that only differs past the last line.
+  if (renderSnapshot.has_value()) {
+    const int lastCachedRow = renderSnapshot->lineCount - 1;
+    const bool coversFirst =
+        renderSnapshot->firstRow <= std::min(clampedFirstRow, lastCachedRow);
+    const bool coversLast = renderSnapshotLastRow >=
+                            std::min(clampedLastRow, lastCachedRow);
+
+    if (coversFirst && coversLast) {
+      return *renderSnapshot;
+    }
+  }
+
+  const auto raw =
+      editorController->get_render_snapshot(clampedFirstRow, clampedLastRow);
+
+  RenderSnapshot snapshot;
+  snapshot.firstRow = static_cast<int>(raw.first_row);
+  snapshot.lines.reserve(static_cast<qsizetype>(raw.lines.size()));
+  for (const auto &line : raw.lines) {
+    snapshot.lines.append(QString::fromUtf8(line));
+  }
+
+  snapshot.cursors.reserve(raw.cursors.size());
+  for (const auto &cursor : raw.cursors) {
+    snapshot.cursors.push_back(
+        {static_cast<int>(cursor.row), static_cast<int>(cursor.col)});
+  }
+
+  snapshot.selection = {
+      {static_cast<int>(raw.selection.start.row),
+       static_cast<int>(raw.selection.start.col)},
+      {static_cast<int>(raw.selection.end.row),
+       static_cast<int>(raw.selection.end.col)},
+      {static_cast<int>(raw.selection.anchor.row),
+       static_cast<int>(raw.selection.anchor.col)},
+      raw.selection.active,
+  };
+  snapshot.lineCount = static_cast<int>(raw.line_count);
+  snapshot.bufferVersion = raw.buffer_version;
+  snapshot.isEmpty = raw.is_empty;
+
+  renderSnapshot = std::move(snapshot);
+  renderSnapshotLastRow = clampedLastRow;
+
+  // Changes made outside of this bridge (e.g. a document finishing loading)
+  // aren't seen here, so never keep a snapshot past the current pass.
+  if (!renderSnapshotResetQueued) {
+    renderSnapshotResetQueued = true;
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+          renderSnapshotResetQueued = false;
+          invalidateRenderSnapshot();
+        },
+        Qt::QueuedConnection);
+  }
+
+  return *renderSnapshot;
+}
+
+int EditorBridge::measureLineWidths(
+    const int firstRow, const int lastRow, const int limit,
+    const std::function<double(const QString &)> &measure) {
+  if (lastRow < firstRow || lastRow < 0 || limit <= 0) {
+    return 0;
+  }
+
+  const auto lines = editorController->get_unmeasured_lines(
+      std::max(0, firstRow), lastRow, limit);
+  if (lines.empty()) {
+    return 0;
+  }
+
+  std::vector<neko::LineWidthFfi> widths;
+  widths.reserve(lines.size());
+
+  for (const auto &line : lines) {
+    widths.push_back({line.row, measure(QString::fromUtf8(line.text))});
+  }
+
+  editorController->update_line_widths(
+      rust::Slice<const neko::LineWidthFfi>(widths.data(), widths.size()));
+
+  return static_cast<int>(widths.size());
 }
 
 void EditorBridge::setController(
     rust::Box<neko::EditorController> &&controller) {
   this->editorController = std::move(controller);
+  invalidateRenderSnapshot();
 }
 
 void EditorBridge::selectWord(const int row, const int column) {
@@ -210,20 +291,46 @@ void EditorBridge::addCursor(neko::AddCursorDirectionKind directionKind,
   const auto direction =
       EditorBridge::makeCursorDirection(directionKind, row, column);
   editorController->add_cursor(direction);
+  invalidateRenderSnapshot();
 
-  emitCursorAndSelection();
-  emit viewportChanged();
+  scheduleChanges(ChangeMask::Cursor | ChangeMask::Viewport);
 }
 
 void EditorBridge::removeCursor(int row, int column) {
   editorController->remove_cursor(row, column);
+  invalidateRenderSnapshot();
 
-  emitCursorAndSelection();
-  emit viewportChanged();
+  scheduleChanges(ChangeMask::Cursor | ChangeMask::Viewport);
 }
 
 void EditorBridge::applyChangeSet(const neko::ChangeSetFfi &changeSet) {
-  const auto mask = changeSet.mask;
+  invalidateRenderSnapshot();
+
+  // Row invalidation only drops cached layouts, and has to happen before the
+  // next paint, so it isn't deferred.
+  if (hasFlag(changeSet.mask, ChangeMask::Buffer)) {
+    emitRowsChanged(changeSet);
+  }
+
+  scheduleChanges(changeSet.mask);
+}
+
+void EditorBridge::scheduleChanges(const uint32_t mask) {
+  if (mask == 0) {
+    return;
+  }
+
+  const bool flushQueued = pendingChangeMask != 0;
+  pendingChangeMask |= mask;
+
+  if (!flushQueued) {
+    QMetaObject::invokeMethod(this, &EditorBridge::flushChanges,
+                              Qt::QueuedConnection);
+  }
+}
+
+void EditorBridge::flushChanges() {
+  const uint32_t mask = std::exchange(pendingChangeMask, 0);
 
   if (hasFlag(mask, ChangeMask::Selection)) {
     emitSelectionOnly();
@@ -234,10 +341,6 @@ void EditorBridge::applyChangeSet(const neko::ChangeSetFfi &changeSet) {
     emit viewportChanged();
   }
 
-  if (hasFlag(mask, ChangeMask::LineCount)) {
-    emitLineCountChanged();
-  }
-
   if (hasFlag(mask, ChangeMask::Cursor)) {
     emitCursorAndSelection();
   }
@@ -248,21 +351,15 @@ void EditorBridge::applyChangeSet(const neko::ChangeSetFfi &changeSet) {
 }
 
 void EditorBridge::emitCursorAndSelection() {
-  const auto cursors = editorController->get_cursor_positions();
-  if (cursors.empty()) {
+  const auto summary = editorController->get_cursor_summary();
+  if (summary.cursor_count == 0) {
     return;
   }
 
-  const auto activeIndex = editorController->active_cursor_index();
-  const auto &active = cursors[activeIndex];
-  const auto [row, col] = normalizeCursorPosition(static_cast<int>(active.row),
-                                                  static_cast<int>(active.col));
-
-  const auto cursorCount = static_cast<int>(cursors.size());
-  const auto selectionCount =
-      static_cast<int>(editorController->number_of_selections());
-
-  emit cursorChanged(row, col, cursorCount, selectionCount);
+  emit cursorChanged(static_cast<int>(summary.row),
+                     static_cast<int>(summary.col),
+                     static_cast<int>(summary.cursor_count),
+                     static_cast<int>(summary.selection_count));
 }
 
 void EditorBridge::emitSelectionOnly() {
@@ -271,9 +368,19 @@ void EditorBridge::emitSelectionOnly() {
   emit selectionChanged(selectionCount);
 }
 
-void EditorBridge::emitLineCountChanged() {
-  const int lineCount = static_cast<int>(editorController->get_line_count());
-  emit lineCountChanged(lineCount);
+void EditorBridge::emitRowsChanged(const neko::ChangeSetFfi &changeSet) {
+  const bool lineCountChanged =
+      changeSet.line_count_before != changeSet.line_count_after;
+
+  // Without dirty row info (or when rows shifted) everything from the first
+  // dirty row onwards has to be treated as changed.
+  if (changeSet.dirty_first_row < 0) {
+    emit rowsChanged(0, -1);
+  } else if (lineCountChanged || changeSet.dirty_last_row < 0) {
+    emit rowsChanged(changeSet.dirty_first_row, -1);
+  } else {
+    emit rowsChanged(changeSet.dirty_first_row, changeSet.dirty_last_row);
+  }
 }
 
 void EditorBridge::copyToClipboardAndMaybeDelete(bool deleteAfter) {
@@ -310,16 +417,7 @@ EditorBridge::makeCursorDirection(neko::AddCursorDirectionKind kind,
   return direction;
 }
 
-std::pair<int, int>
-EditorBridge::normalizeCursorPosition(const int row, const int column) const {
-  const int lineCount = static_cast<int>(editorController->get_line_count());
-  const int clampedRow = std::clamp(row, 0, std::max(0, lineCount - 1));
-  const int lineLength =
-      static_cast<int>(editorController->line_length(clampedRow));
-  const int clampedCol = std::clamp(column, 0, std::max(0, lineLength));
-
-  return {clampedRow, clampedCol};
-}
+void EditorBridge::invalidateRenderSnapshot() { renderSnapshot.reset(); }
 
 inline bool EditorBridge::hasFlag(uint32_t mask, uint32_t flag) {
   return (mask & flag) != 0U;
@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <functional>
+#include <optional>
 #include <neko-core/src/ffi/bridge.rs.h>
 
 class EditorBridge : public QObject {
@@ -19,22 +21,36 @@ public:
   ~EditorBridge() override = default;
 
   // Getters
-  [[nodiscard]] bool isEmpty() const;
   [[nodiscard]] QString getLine(int index) const;
-  [[nodiscard]] QStringList getLines() const;
   [[nodiscard]] int getLineCount() const;
+  /// The line count to size the viewport for. Matches `getLineCount` except
+  /// while a file that was unloaded (or restored from the last session) is
+  /// read again, where it is the count the file had, so the scroll position
+  /// survives until the content is back.
+  [[nodiscard]] int getLayoutLineCount() const;
   [[nodiscard]] Selection getSelection();
   [[nodiscard]] std::vector<Cursor> getCursorPositions() const;
-  [[nodiscard]] bool needsWidthMeasurement(int index) const;
+  /// Counts the cursors without copying them across the bridge.
+  [[nodiscard]] int getCursorCount() const;
   [[nodiscard]] double getMaxWidth() const;
+  /// Identifies the view the current controller edits.
+  [[nodiscard]] uint64_t getViewId() const;
   [[nodiscard]] bool cursorExistsAt(int row, int column) const;
-  [[nodiscard]] bool bufferIsEmpty() const;
   [[nodiscard]] int getNumberOfSelections() const;
   [[nodiscard]] Cursor getLastAddedCursor() const;
   [[nodiscard]] int getLineLength(int index) const;
+  /// Fetches everything needed to paint rows `[firstRow, lastRow]` in one
+  /// call. The snapshot is kept until the current event loop pass ends or the
+  /// editor changes, so the editor and gutter share it within a frame.
+  [[nodiscard]] const RenderSnapshot &getRenderSnapshot(int firstRow,
+                                                        int lastRow);
 
   // Setters
-  void setLineWidth(int index, double width);
+  /// Measures up to `limit` rows in `[firstRow, lastRow]` whose width is not
+  /// known yet and reports them back in one batch. Returns the number of rows
+  /// measured, so callers can tell when there is nothing left to do.
+  int measureLineWidths(int firstRow, int lastRow, int limit,
+                        const std::function<double(const QString &)> &measure);
   void setController(rust::Box<neko::EditorController> &&controller);
 
   // Selection/Cursor movement
@@ -68,27 +84,32 @@ public:
                  int column = 0);
   void removeCursor(int row, int column);
 
+  /// Invalidates cached rows right away and queues the remaining
+  /// notifications, so that every change made in one event loop pass is
+  /// reported once (see `flushChanges`).
   void applyChangeSet(const neko::ChangeSetFfi &changeSet);
 
 signals:
   void cursorChanged(int row, int column, int cursorCount, int selectionCount);
   void selectionChanged(int selectionCount);
-  void lineCountChanged(int lineCount);
   void bufferChanged();
   void viewportChanged();
+  // A negative `lastRow` means every row from `firstRow` to the end changed.
+  void rowsChanged(int firstRow, int lastRow);
 
 private:
   // Helpers
+  void scheduleChanges(uint32_t mask);
+  void flushChanges();
   void emitCursorAndSelection();
   void emitSelectionOnly();
-  void emitLineCountChanged();
+  void emitRowsChanged(const neko::ChangeSetFfi &changeSet);
+  void invalidateRenderSnapshot();
 
   void copyToClipboardAndMaybeDelete(bool deleteAfter);
 
   [[nodiscard]] neko::AddCursorDirectionFfi static makeCursorDirection(
       neko::AddCursorDirectionKind kind, int row = 0, int column = 0);
-  [[nodiscard]] std::pair<int, int> normalizeCursorPosition(int row,
-                                                            int column) const;
 
   static inline bool hasFlag(uint32_t mask, uint32_t flag);
 
@@ -99,6 +120,11 @@ private:
            bool shouldSelect);
 
   rust::Box<neko::EditorController> editorController;
+  std::optional<RenderSnapshot> renderSnapshot;
+  int renderSnapshotLastRow = -1;
+  bool renderSnapshotResetQueued = false;
+  // ChangeMask bits waiting for `flushChanges`; non-zero while one is queued.
+  uint32_t pendingChangeMask = 0;
 };
 
 #endif
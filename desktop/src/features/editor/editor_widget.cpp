@@ -2,9 +2,11 @@
 #include "utils/ui_utils.h"
 #include <QApplication>
 #include <QMouseEvent>
+#include <QPaintEvent>
 #include <QPainter>
+#include <QRect>
 #include <QScrollBar>
-#include <QTextLine>
+#include <cstdlib>
 
 EditorWidget::EditorWidget(const EditorProps &props, QWidget *parent)
     : QScrollArea(parent), editorBridge(props.editorBridge),
@@ -16,18 +18,17 @@ EditorWidget::EditorWidget(const EditorProps &props, QWidget *parent)
 
   tripleArmTimer.setSingleShot(true);
   suppressDblTimer.setSingleShot(true);
+  widthMeasureTimer.setInterval(0);
 
   connect(&tripleArmTimer, &QTimer::timeout, this,
           [this] { tripleArmed = false; });
   connect(&suppressDblTimer, &QTimer::timeout, this,
           [this] { suppressNextDouble = false; });
+  connect(&widthMeasureTimer, &QTimer::timeout, this,
+          &EditorWidget::measurePendingWidths);
 
+  renderer->setFont(font);
   setAndApplyTheme(theme);
-
-  connect(verticalScrollBar(), &QScrollBar::valueChanged, this,
-          &EditorWidget::redraw);
-  connect(horizontalScrollBar(), &QScrollBar::valueChanged, this,
-          &EditorWidget::redraw);
 }
 
 void EditorWidget::setAndApplyTheme(const EditorTheme &newTheme) {
@@ -47,12 +48,10 @@ void EditorWidget::updateDimensions() {
     return;
   }
 
-  const int lineCount = editorBridge->getLineCount();
+  const int lineCount = editorBridge->getLayoutLineCount();
   const auto viewportHeight = (lineCount * fontMetrics.height()) -
                               viewport()->height() + VIEWPORT_PADDING;
-  const auto contentWidth = measureWidth();
-  const auto viewportWidth =
-      contentWidth - viewport()->width() + VIEWPORT_PADDING;
+  const auto contentWidth = measureVisibleWidths();
 
   const bool horizontalScrollBarVisible = horizontalScrollBar()->isVisible();
   const double horizontalScrollBarHeight = horizontalScrollBar()->height();
@@ -60,13 +59,24 @@ void EditorWidget::updateDimensions() {
       viewportHeight -
       (horizontalScrollBarVisible ? horizontalScrollBarHeight : 0.0);
 
-  horizontalScrollBar()->setRange(0, static_cast<int>(viewportWidth));
+  updateHorizontalRange(contentWidth);
   verticalScrollBar()->setRange(0, static_cast<int>(adjustedVerticalRange));
   redraw();
 }
 
+void EditorWidget::updateHorizontalRange(const double contentWidth) const {
+  const auto viewportWidth =
+      contentWidth - viewport()->width() + VIEWPORT_PADDING;
+
+  horizontalScrollBar()->setRange(0, static_cast<int>(viewportWidth));
+}
+
 void EditorWidget::setEditorBridge(EditorBridge *newEditorBridge) {
   editorBridge = newEditorBridge;
+
+  if (editorBridge != nullptr) {
+    renderer->setView(editorBridge->getViewId());
+  }
 }
 
 void EditorWidget::onBufferChanged() const { redraw(); }
@@ -80,6 +90,10 @@ void EditorWidget::onSelectionChanged() const { redraw(); }
 
 void EditorWidget::onViewportChanged() { updateDimensions(); }
 
+void EditorWidget::onRowsChanged(const int firstRow, const int lastRow) const {
+  renderer->invalidateRows(firstRow, lastRow);
+}
+
 static int tripleWindowMs() {
   static constexpr int TRIPLE_CLICK_MS = 120;
   return std::max(TRIPLE_CLICK_MS, QApplication::doubleClickInterval() / 2);
@@ -362,23 +376,31 @@ void EditorWidget::paintEvent(QPaintEvent *event) {
   const double viewportWidth = viewport()->width();
   const double lineHeight = fontMetrics.height();
 
-  const int lineCount = editorBridge->getLineCount();
-  const int firstVisibleLine = qMax(
-      0, qMin(static_cast<int>(verticalOffset / lineHeight), lineCount - 1));
-  const int visibleLineCount = static_cast<int>(viewportHeight / lineHeight);
-  const int lastVisibleLine =
-      qMax(0, qMin(firstVisibleLine + visibleLineCount + EXTRA_VERTICAL_LINES,
-                   lineCount - 1));
+  // Only the rows in the exposed area are painted; after a scroll that is
+  // just the strip that moved into view. Text is cached in bands of rows, so
+  // the range is widened to whole bands in case one has to be redrawn.
+  constexpr int tileRows = TextTileCache::TILE_ROWS;
+  const QRect exposedRect = event->rect();
+  const int firstExposedLine = qMax(
+      0, static_cast<int>((verticalOffset + exposedRect.top()) / lineHeight));
+  const int lastExposedLine =
+      static_cast<int>((verticalOffset + exposedRect.bottom()) / lineHeight) +
+      EXTRA_VERTICAL_LINES;
+  const int firstRequestedLine =
+      firstExposedLine - (firstExposedLine % tileRows);
+  const int lastRequestedLine =
+      (((lastExposedLine / tileRows) + 1) * tileRows) - 1;
+
+  const auto &snapshot =
+      editorBridge->getRenderSnapshot(firstRequestedLine, lastRequestedLine);
+  const int lineCount = snapshot.lineCount;
+  const int firstVisibleLine = qMin(firstRequestedLine, qMax(0, lineCount - 1));
+  const int lastVisibleLine = qMax(0, qMin(lastRequestedLine, lineCount - 1));
 
   const ViewportContext ctx = {
       lineHeight,       firstVisibleLine, lastVisibleLine, verticalOffset,
       horizontalOffset, viewportWidth,    viewportHeight};
 
-  const QStringList lines = editorBridge->getLines();
-  const auto cursors = editorBridge->getCursorPositions();
-  const auto selections = editorBridge->getSelection();
-  const bool isEmpty = editorBridge->isEmpty();
-
   const double fontAscent = fontMetrics.ascent();
   const double fontDescent = fontMetrics.descent();
   const bool hasFocus = this->hasFocus();
@@ -393,11 +415,25 @@ void EditorWidget::paintEvent(QPaintEvent *event) {
     return fontMetrics.horizontalAdvance(string);
   };
   const RenderState state = {
-      lines,          cursors,          selections, theme,       lineCount,
-      verticalOffset, horizontalOffset, lineHeight, fontAscent,  fontDescent,
-      font,           hasFocus,         isEmpty,    measureWidth};
+      snapshot.lines,     snapshot.firstRow,  snapshot.cursors,
+      snapshot.selection, theme,              lineCount,
+      verticalOffset,     horizontalOffset,   lineHeight,
+      fontAscent,         fontDescent,        font,
+      hasFocus,           snapshot.isEmpty,   snapshot.bufferVersion,
+      measureWidth};
+
+  renderer->paint(painter, state, ctx);
+}
 
-  EditorRenderer::paint(painter, state, ctx);
+void EditorWidget::scrollContentsBy(const int dx, const int dy) {
+  // Shift what is already on screen and let the paint event fill in the
+  // newly exposed strip. A jump of a whole viewport has nothing to reuse.
+  if (std::abs(dx) < viewport()->width() &&
+      std::abs(dy) < viewport()->height()) {
+    viewport()->scroll(dx, dy);
+  } else {
+    redraw();
+  }
 }
 
 void EditorWidget::wheelEvent(QWheelEvent *event) {
@@ -414,7 +450,6 @@ void EditorWidget::wheelEvent(QWheelEvent *event) {
 
   horizontalScrollBar()->setValue(static_cast<int>(newHorizontalScrollOffset));
   verticalScrollBar()->setValue(static_cast<int>(newVerticalScrollOffset));
-  redraw();
 }
 
 bool EditorWidget::focusNextPrevChild(bool next) { return false; }
@@ -424,26 +459,6 @@ double EditorWidget::getTextWidth(const QString &text,
   return fontMetrics.horizontalAdvance(text) - horizontalOffset;
 }
 
-static int xToCursorIndex(const QString &line, const QFont &font,
-                          const qreal xPos) {
-  static constexpr int MAX_TEXT_LINE_WIDTH = 1e9;
-
-  QTextLayout layout(line, font);
-  layout.beginLayout();
-
-  QTextLine textLine = layout.createLine();
-
-  if (!textLine.isValid()) {
-    return 0;
-  }
-
-  textLine.setLineWidth(MAX_TEXT_LINE_WIDTH);
-
-  layout.endLayout();
-
-  return textLine.xToCursor(xPos);
-}
-
 RowCol EditorWidget::convertMousePositionToRowCol(const double xPos,
                                                   const double yPos) {
   const double lineHeight = fontMetrics.height();
@@ -462,7 +477,7 @@ RowCol EditorWidget::convertMousePositionToRowCol(const double xPos,
   const QString line = editorBridge->getLine(row);
   const auto targetX = static_cast<qreal>(xPos + scrollX);
 
-  int col = xToCursorIndex(line, font, targetX);
+  int col = renderer->xToColumn(row, line, targetX);
   col = std::clamp(col, 0, static_cast<int>(line.length()));
 
   return {static_cast<int>(row), col};
@@ -485,6 +500,7 @@ void EditorWidget::resetFontSize() { setFontSizeInternal(DEFAULT_FONT_SIZE); }
 void EditorWidget::setFontSizeInternal(double newFontSize) {
   font.setPointSizeF(newFontSize);
   fontMetrics = QFontMetricsF(font);
+  renderer->setFont(font);
 
   emit fontSizeChangedByUser(newFontSize);
   updateDimensions();
@@ -496,6 +512,7 @@ void EditorWidget::updateFont(const QFont &newFont) {
   font = newFont;
   setFont(font);
   fontMetrics = QFontMetricsF(font);
+  renderer->setFont(font);
 
   updateDimensions();
   updateGeometry();
@@ -514,7 +531,6 @@ void EditorWidget::scrollToCursor() {
   const double lineHeight = fontMetrics.height();
 
   const QString line = editorBridge->getLine(cursor.row);
-  const QString textBeforeCursor = line.mid(0, cursor.column);
 
   const double viewportWidth = viewport()->width();
   const double viewportHeight = viewport()->height();
@@ -523,7 +539,7 @@ void EditorWidget::scrollToCursor() {
 
   const double targetY = targetRow * lineHeight;
   const double targetYBottom = targetY + lineHeight;
-  const double targetX = fontMetrics.horizontalAdvance(textBeforeCursor);
+  const double targetX = renderer->columnToX(cursor.row, line, cursor.column);
 
   if (targetX > viewportWidth - VIEWPORT_PADDING + horizontalScrollOffset) {
     horizontalScrollBar()->setValue(
@@ -542,20 +558,51 @@ void EditorWidget::scrollToCursor() {
   }
 }
 
-double EditorWidget::measureWidth() const {
+double EditorWidget::measureVisibleWidths() {
   if (editorBridge == nullptr) {
     return 0;
   }
 
-  const int lineCount = editorBridge->getLineCount();
+  const double lineHeight = fontMetrics.height();
+  const int firstVisibleLine =
+      static_cast<int>(verticalScrollBar()->value() / lineHeight);
+  const int lastVisibleLine =
+      firstVisibleLine + static_cast<int>(viewport()->height() / lineHeight) +
+      EXTRA_VERTICAL_LINES;
+  const auto measure = [this](const QString &line) {
+    return fontMetrics.horizontalAdvance(line);
+  };
 
-  for (int i = 0; i < lineCount; i++) {
-    if (editorBridge->needsWidthMeasurement(i)) {
-      const QString line = editorBridge->getLine(i);
-      const double width = fontMetrics.horizontalAdvance(line);
-      editorBridge->setLineWidth(i, width);
-    }
-  }
+  editorBridge->measureLineWidths(firstVisibleLine, lastVisibleLine,
+                                  lastVisibleLine - firstVisibleLine + 1,
+                                  measure);
+
+  // Everything off-screen is picked up by the idle pass.
+  widthMeasureTimer.start();
 
   return editorBridge->getMaxWidth();
 }
+
+void EditorWidget::measurePendingWidths() {
+  if (editorBridge == nullptr) {
+    widthMeasureTimer.stop();
+    return;
+  }
+
+  const double maxWidthBefore = editorBridge->getMaxWidth();
+  const auto measure = [this](const QString &line) {
+    return fontMetrics.horizontalAdvance(line);
+  };
+
+  const int measured = editorBridge->measureLineWidths(
+      0, editorBridge->getLineCount() - 1, WIDTH_MEASURE_BATCH_SIZE, measure);
+
+  if (measured < WIDTH_MEASURE_BATCH_SIZE) {
+    widthMeasureTimer.stop();
+  }
+
+  const double maxWidth = editorBridge->getMaxWidth();
+  if (maxWidth != maxWidthBefore) {
+    updateHorizontalRange(maxWidth);
+  }
+}
@@ -38,6 +38,7 @@ public slots:
   void onCursorChanged();
   void onSelectionChanged() const;
   void onViewportChanged();
+  void onRowsChanged(int firstRow, int lastRow) const;
   void updateFont(const QFont &newFont);
 
 protected:
@@ -47,6 +48,7 @@ protected:
   void mouseMoveEvent(QMouseEvent *event) override;
   void mouseReleaseEvent(QMouseEvent *event) override;
   void paintEvent(QPaintEvent *event) override;
+  void scrollContentsBy(int dx, int dy) override;
   void wheelEvent(QWheelEvent *event) override;
   bool focusNextPrevChild(bool next) override;
 
@@ -66,7 +68,9 @@ private:
   void setFontSizeInternal(double newFontSize);
 
   void scrollToCursor();
-  [[nodiscard]] double measureWidth() const;
+  double measureVisibleWidths();
+  void measurePendingWidths();
+  void updateHorizontalRange(double contentWidth) const;
 
   EditorTheme theme;
 
@@ -75,6 +79,10 @@ private:
   QFont font;
   QFontMetricsF fontMetrics;
 
+  // Measures rows outside of the viewport in batches once the event loop is
+  // idle, so large documents never block on measuring every line at once.
+  QTimer widthMeasureTimer;
+
   QTimer suppressDblTimer;
   bool suppressNextDouble = false;
   QPoint suppressDblPos;
@@ -96,6 +104,7 @@ private:
   const double VIEWPORT_PADDING = 74.0;
 
   static constexpr int TRIPLE_CLICK_MS = 200;
+  static constexpr int WIDTH_MEASURE_BATCH_SIZE = 2000;
 };
 
 #endif // EDITOR_WIDGET_H
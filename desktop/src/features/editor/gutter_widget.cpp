@@ -1,11 +1,14 @@
 #include "gutter_widget.h"
 #include "features/editor/bridge/editor_bridge.h"
 #include "utils/ui_utils.h"
+#include <QPaintEvent>
 #include <QPainter>
+#include <QRect>
 #include <QScrollBar>
 #include <QString>
 #include <QStringList>
 #include <QWheelEvent>
+#include <cstdlib>
 
 GutterWidget::GutterWidget(const GutterProps &props, QWidget *parent)
     : QScrollArea(parent), editorBridge(props.editorBridge),
@@ -18,11 +21,6 @@ GutterWidget::GutterWidget(const GutterProps &props, QWidget *parent)
   setAutoFillBackground(false);
 
   setAndApplyTheme(theme);
-
-  connect(verticalScrollBar(), &QScrollBar::valueChanged, this,
-          &GutterWidget::redraw);
-  connect(horizontalScrollBar(), &QScrollBar::valueChanged, this,
-          &GutterWidget::redraw);
 }
 
 void GutterWidget::redraw() const { viewport()->update(); }
@@ -41,7 +39,7 @@ void GutterWidget::updateDimensions() {
     return;
   }
 
-  const int lineCount = editorBridge->getLineCount();
+  const int lineCount = editorBridge->getLayoutLineCount();
   const auto viewportHeight = (lineCount * fontMetrics.height()) -
                               viewport()->height() + VIEWPORT_PADDING;
   const auto contentWidth = measureWidth();
@@ -76,22 +74,24 @@ void GutterWidget::paintEvent(QPaintEvent *event) {
   const double viewportWidth = viewport()->width();
   const double lineHeight = fontMetrics.height();
 
-  const int lineCount = editorBridge->getLineCount();
-  const int firstVisibleLine = qMax(
-      0, qMin(static_cast<int>(verticalOffset / lineHeight), lineCount - 1));
-  const int visibleLineCount = static_cast<int>(viewportHeight / lineHeight);
-  const int lastVisibleLine =
-      qMax(0, qMin(firstVisibleLine + visibleLineCount + EXTRA_VERTICAL_LINES,
-                   lineCount - 1));
+  // Matches the editor: only rows in the exposed area are painted.
+  const QRect exposedRect = event->rect();
+  const int firstRequestedLine = qMax(
+      0, static_cast<int>((verticalOffset + exposedRect.top()) / lineHeight));
+  const int lastRequestedLine =
+      static_cast<int>((verticalOffset + exposedRect.bottom()) / lineHeight) +
+      EXTRA_VERTICAL_LINES;
+
+  const auto &snapshot =
+      editorBridge->getRenderSnapshot(firstRequestedLine, lastRequestedLine);
+  const int lineCount = snapshot.lineCount;
+  const int firstVisibleLine = qMin(firstRequestedLine, qMax(0, lineCount - 1));
+  const int lastVisibleLine = qMax(0, qMin(lastRequestedLine, lineCount - 1));
 
   const ViewportContext ctx = {
       lineHeight,       firstVisibleLine, lastVisibleLine, verticalOffset,
       horizontalOffset, viewportWidth,    viewportHeight};
 
-  const auto cursors = editorBridge->getCursorPositions();
-  const auto selections = editorBridge->getSelection();
-  const bool isEmpty = editorBridge->bufferIsEmpty();
-
   const double fontAscent = fontMetrics.ascent();
   const double fontDescent = fontMetrics.descent();
   const bool hasFocus = this->hasFocus();
@@ -108,11 +108,24 @@ void GutterWidget::paintEvent(QPaintEvent *event) {
     return fontMetrics.horizontalAdvance(string);
   };
   const RenderState state = {
-      QStringList(),  cursors,          selections, theme,       lineCount,
-      verticalOffset, horizontalOffset, lineHeight, fontAscent,  fontDescent,
-      font,           hasFocus,         isEmpty,    measureWidth};
+      QStringList(),      firstVisibleLine,   snapshot.cursors,
+      snapshot.selection, theme,              lineCount,
+      verticalOffset,     horizontalOffset,   lineHeight,
+      fontAscent,         fontDescent,        font,
+      hasFocus,           snapshot.isEmpty,   snapshot.bufferVersion,
+      measureWidth};
+
+  renderer->paint(painter, state, ctx);
+}
 
-  GutterRenderer::paint(painter, state, ctx);
+void GutterWidget::scrollContentsBy(const int dx, const int dy) {
+  // Blit the existing numbers instead of repainting the whole gutter.
+  if (std::abs(dx) < viewport()->width() &&
+      std::abs(dy) < viewport()->height()) {
+    viewport()->scroll(dx, dy);
+  } else {
+    redraw();
+  }
 }
 
 void GutterWidget::wheelEvent(QWheelEvent *event) {
@@ -122,7 +135,6 @@ void GutterWidget::wheelEvent(QWheelEvent *event) {
   const auto newVerticalScrollOffset = verticalScrollOffset + verticalDelta;
 
   verticalScrollBar()->setValue(static_cast<int>(newVerticalScrollOffset));
-  redraw();
 }
 
 void GutterWidget::onEditorFontSizeChanged(const qreal newSize) {
@@ -132,8 +144,6 @@ void GutterWidget::onEditorFontSizeChanged(const qreal newSize) {
   updateDimensions();
 }
 
-void GutterWidget::onEditorLineCountChanged() { updateDimensions(); }
-
 void GutterWidget::onEditorCursorPositionChanged() const { redraw(); }
 
 void GutterWidget::onBufferChanged() const { redraw(); }
@@ -34,11 +34,11 @@ public:
 protected:
   [[nodiscard]] QSize sizeHint() const override;
   void paintEvent(QPaintEvent *event) override;
+  void scrollContentsBy(int dx, int dy) override;
   void wheelEvent(QWheelEvent *event) override;
 
 public slots:
   void onEditorFontSizeChanged(qreal newSize);
-  void onEditorLineCountChanged();
   void onEditorCursorPositionChanged() const;
 
   void onBufferChanged() const;
@@ -14,3 +14,13 @@ QRectF getLineRect(size_t lineIndex, double x1Pos, double x2Pos,
   return {QPointF(x1Pos, getLineTopY(lineIndex, ctx)),
           QPointF(x2Pos, getLineBottomY(lineIndex, ctx))};
 }
+
+QString getLineText(int lineIndex, const RenderState &state) {
+  const int windowIndex = lineIndex - state.firstLineIndex;
+
+  if (state.isEmpty || windowIndex < 0 || windowIndex >= state.lines.size()) {
+    return {};
+  }
+
+  return state.lines.at(windowIndex);
+}
@@ -10,4 +10,6 @@ double getLineBottomY(size_t lineIndex, const ViewportContext &ctx);
 QRectF getLineRect(size_t lineIndex, double x1Pos, double x2Pos,
                    const ViewportContext &ctx);
 
+QString getLineText(int lineIndex, const RenderState &state);
+
 #endif // EDITOR_RENDER_UTILS_H
@@ -1,46 +1,86 @@
 #include "editor_renderer.h"
 #include "features/editor/render/editor_render_utils.h"
 #include <QPainter>
+#include <QTextLayout>
+#include <QTextLine>
+#include <algorithm>
 
 void EditorRenderer::paint(QPainter &painter, const RenderState &state,
                            const ViewportContext &ctx) {
-  drawText(&painter, state, ctx);
+  lineLayouts.setFont(state.font);
+  textTiles.setFont(state.font);
+
+  // Text comes from cached tiles; carets, highlights and selections are
+  // cheap enough to draw over them on every paint.
+  textTiles.draw(&painter, state, ctx, lineLayouts);
   drawCursors(&painter, state, ctx);
   drawSelections(&painter, state, ctx);
-}
-
-void EditorRenderer::drawText(QPainter *painter, const RenderState &state,
-                              const ViewportContext &ctx) {
-  auto drawLine = [painter, state, ctx](auto line) {
-    const QString lineText = state.isEmpty ? "" : state.lines.at(line);
 
-    const auto actualY =
-        (line * ctx.lineHeight) +
-        (ctx.lineHeight + state.fontAscent - state.fontDescent) / 2.0 -
-        ctx.verticalOffset;
+  // A scroll only paints the rows it exposed, so keep everything in view
+  // rather than just the rows painted this time.
+  const int firstViewportRow =
+      static_cast<int>(ctx.verticalOffset / ctx.lineHeight);
+  const int lastViewportRow =
+      static_cast<int>((ctx.verticalOffset + ctx.height) / ctx.lineHeight);
+  lineLayouts.retainRows(firstViewportRow - LAYOUT_RETAIN_MARGIN,
+                         lastViewportRow + LAYOUT_RETAIN_MARGIN);
+  textTiles.retainRows(firstViewportRow - TextTileCache::TILE_ROWS,
+                       lastViewportRow + TextTileCache::TILE_ROWS);
+}
 
-    painter->drawText(QPointF(-ctx.horizontalOffset, actualY), lineText);
-  };
+void EditorRenderer::setFont(const QFont &font) {
+  lineLayouts.setFont(font);
+  textTiles.setFont(font);
+}
 
-  painter->setPen(state.theme.textColor);
-  painter->setFont(state.font);
+void EditorRenderer::invalidateRows(const int firstRow, const int lastRow) {
+  lineLayouts.invalidateRows(firstRow, lastRow);
+  textTiles.invalidateRows(firstRow, lastRow);
+}
 
-  const int maxLine = std::min(ctx.lastVisibleLine,
-                               static_cast<const int>(state.lines.size()) - 1);
-  if (ctx.firstVisibleLine <= 0 && ctx.lastVisibleLine <= 0) {
-    drawLine(0);
+void EditorRenderer::setView(const uint64_t newViewId) {
+  if (newViewId == viewId) {
     return;
   }
 
-  if (maxLine < ctx.firstVisibleLine) {
-    return;
+  if (viewId != 0) {
+    textTiles.forgetReportedChanges();
+    warmViews.push_front(
+        {viewId, std::move(lineLayouts), std::move(textTiles)});
   }
 
-  for (int line = ctx.firstVisibleLine; line <= maxLine; line++) {
-    drawLine(line);
+  const auto warmView =
+      std::find_if(warmViews.begin(), warmViews.end(),
+                   [newViewId](const WarmView &view) {
+                     return view.viewId == newViewId;
+                   });
+
+  if (warmView != warmViews.end()) {
+    lineLayouts = std::move(warmView->lineLayouts);
+    textTiles = std::move(warmView->textTiles);
+    warmViews.erase(warmView);
+  } else {
+    lineLayouts = LineLayoutCache();
+    textTiles = TextTileCache();
+  }
+
+  viewId = newViewId;
+
+  while (warmViews.size() > WARM_VIEW_LIMIT) {
+    warmViews.pop_back();
   }
 }
 
+double EditorRenderer::columnToX(const int row, const QString &text,
+                                 const int column) {
+  return lineLayouts.columnToX(row, text, column);
+}
+
+int EditorRenderer::xToColumn(const int row, const QString &text,
+                              const double xPos) {
+  return lineLayouts.xToColumn(row, text, xPos);
+}
+
 void EditorRenderer::drawSelections(QPainter *painter, const RenderState &state,
                                     const ViewportContext &ctx) {
   const bool hasActiveSelection = state.selections.active;
@@ -74,20 +114,20 @@ void EditorRenderer::drawSingleLineSelection(QPainter *painter,
                                              // NOLINTNEXTLINE
                                              int startRow, int startCol,
                                              const int endCol) {
-  if (startRow >= state.lines.size()) {
+  if (startRow > ctx.lastVisibleLine || startRow < ctx.firstVisibleLine) {
     return;
   }
 
-  const QString text = state.lines.at(startRow);
-
-  const QString selection_text = text.mid(startCol, endCol - startCol);
-  const QString selection_before_text = text.mid(0, startCol);
+  if (startRow >= state.lineCount) {
+    return;
+  }
 
-  const double width = state.measureWidth(selection_text);
-  const double widthBefore = state.measureWidth(selection_before_text);
+  const QString text = getLineText(startRow, state);
 
-  const double x1Pos = widthBefore - ctx.horizontalOffset;
-  const double x2Pos = widthBefore + width - ctx.horizontalOffset;
+  const double x1Pos =
+      lineLayouts.columnToX(startRow, text, startCol) - ctx.horizontalOffset;
+  const double x2Pos =
+      lineLayouts.columnToX(startRow, text, endCol) - ctx.horizontalOffset;
 
   painter->drawRect(getLineRect(startRow, x1Pos, x2Pos, ctx));
 }
@@ -101,24 +141,20 @@ void EditorRenderer::drawFirstLineSelection(QPainter *painter,
     return;
   }
 
-  if (startRow >= state.lines.size()) {
+  if (startRow >= state.lineCount) {
     return;
   }
 
-  QString text = state.lines.at(startRow);
-
-  if (text.isEmpty()) {
-    text = " ";
-  }
-
-  const QString selectionText = text.mid(startCol);
-  const QString beforeText = text.mid(0, startCol);
+  const QString text = getLineText(startRow, state);
 
-  const double width = state.measureWidth(selectionText);
-  const double widthBefore = state.measureWidth(beforeText);
+  // Empty lines get a single space worth of highlight for the newline.
+  const double widthBefore = lineLayouts.columnToX(startRow, text, startCol);
+  const double lineWidth =
+      text.isEmpty() ? state.measureWidth(" ")
+                     : lineLayouts.columnToX(startRow, text, text.length());
 
   const double x1Pos = widthBefore - ctx.horizontalOffset;
-  const double x2Pos = widthBefore + width - ctx.horizontalOffset;
+  const double x2Pos = std::max(widthBefore, lineWidth) - ctx.horizontalOffset;
 
   painter->drawRect(getLineRect(startRow, x1Pos, x2Pos, ctx));
 }
@@ -128,22 +164,18 @@ void EditorRenderer::drawMiddleLinesSelection(QPainter *painter,
                                               const ViewportContext &ctx,
                                               // NOLINTNEXTLINE
                                               int startRow, int endRow) {
-  for (int i = startRow + 1; i < endRow; i++) {
-    if (i >= state.lines.size()) {
-      continue;
-    }
-    if (i > ctx.lastVisibleLine || i < ctx.firstVisibleLine) {
-      continue;
-    }
+  const int firstRow = std::max(startRow + 1, ctx.firstVisibleLine);
+  const int lastRow =
+      std::min({endRow - 1, ctx.lastVisibleLine, state.lineCount - 1});
 
-    QString text = state.lines.at(i);
-
-    if (text.isEmpty()) {
-      text = " ";
-    }
+  for (int i = firstRow; i <= lastRow; i++) {
+    const QString text = getLineText(i, state);
+    const double lineWidth = text.isEmpty()
+                                 ? state.measureWidth(" ")
+                                 : lineLayouts.columnToX(i, text, text.length());
 
     const double x1Pos = -ctx.horizontalOffset;
-    const double x2Pos = state.measureWidth(text) - ctx.horizontalOffset;
+    const double x2Pos = lineWidth - ctx.horizontalOffset;
 
     painter->drawRect(getLineRect(i, x1Pos, x2Pos, ctx));
   }
@@ -158,14 +190,12 @@ void EditorRenderer::drawLastLineSelection(QPainter *painter,
     return;
   }
 
-  if (endRow >= state.lines.size()) {
+  if (endRow >= state.lineCount) {
     return;
   }
 
-  const QString text = state.lines.at(endRow);
-  const QString selectionText = text.mid(0, endCol);
-
-  const double width = state.measureWidth(selectionText);
+  const QString text = getLineText(endRow, state);
+  const double width = lineLayouts.columnToX(endRow, text, endCol);
 
   painter->drawRect(getLineRect(endRow, -ctx.horizontalOffset,
                                 width - ctx.horizontalOffset, ctx));
@@ -188,17 +218,12 @@ void EditorRenderer::drawCursors(QPainter *painter, const RenderState &state,
     if (!state.hasFocus) {
       return;
     }
-    if (!state.isEmpty &&
-        (cursorRow < 0 ||
-         cursorRow >= static_cast<const int>(state.lines.size()))) {
+    if (!state.isEmpty && (cursorRow < 0 || cursorRow >= state.lineCount)) {
       return;
     }
 
-    const QString text = state.isEmpty ? "" : state.lines.at(cursorRow);
-    const int clampedCol =
-        std::clamp(cursorCol, 0, static_cast<const int>(text.size()));
-
-    const qreal cursorX = state.measureWidth(text.left(clampedCol));
+    const QString text = getLineText(cursorRow, state);
+    const qreal cursorX = lineLayouts.columnToX(cursorRow, text, cursorCol);
     if (cursorX < 0 || cursorX > ctx.width + ctx.horizontalOffset) {
       return;
     }
@@ -221,8 +246,7 @@ void EditorRenderer::drawCursors(QPainter *painter, const RenderState &state,
     if (cursor.row < ctx.firstVisibleLine || cursor.row > ctx.lastVisibleLine) {
       continue;
     }
-    if (cursor.row < 0 ||
-        cursor.row >= static_cast<const int>(state.lines.size())) {
+    if (cursor.row < 0 || cursor.row >= state.lineCount) {
       continue;
     }
 
@@ -1,40 +1,69 @@
 #ifndef EDITOR_RENDERER_H
 #define EDITOR_RENDERER_H
 
+#include "features/editor/render/line_layout_cache.h"
+#include "features/editor/render/text_tile_cache.h"
 #include "features/editor/render/types/types.h"
 #include "types/qt_types_fwd.h"
+#include <cstdint>
+#include <list>
 
 QT_FWD(QPainter)
 
 class EditorRenderer {
 public:
-  static void paint(QPainter &painter, const RenderState &state,
-                    const ViewportContext &ctx);
+  void paint(QPainter &painter, const RenderState &state,
+             const ViewportContext &ctx);
+
+  void setFont(const QFont &font);
+  void invalidateRows(int firstRow, int lastRow);
+
+  /// Switches to painting the view with `viewId`. The shaped lines and text
+  /// tiles of the previous view are kept, so switching back to a recently
+  /// shown view reuses them instead of starting cold.
+  void setView(uint64_t viewId);
+
+  [[nodiscard]] double columnToX(int row, const QString &text, int column);
+  [[nodiscard]] int xToColumn(int row, const QString &text, double xPos);
 
 private:
-  static void drawText(QPainter *painter, const RenderState &state,
-                       const ViewportContext &ctx);
-  static void drawCursors(QPainter *painter, const RenderState &state,
-                          const ViewportContext &ctx);
-  static void drawSelections(QPainter *painter, const RenderState &state,
-                             const ViewportContext &ctx);
-  static void drawSingleLineSelection(QPainter *painter,
-                                      const RenderState &state,
-                                      const ViewportContext &ctx, int startRow,
-                                      int startCol, int endCol);
-  static void drawFirstLineSelection(QPainter *painter,
-                                     const RenderState &state,
-                                     const ViewportContext &ctx, int startRow,
-                                     int startCol);
-  static void drawMiddleLinesSelection(QPainter *painter,
-                                       const RenderState &state,
-                                       const ViewportContext &ctx, int startRow,
-                                       int endRow);
-  static void drawLastLineSelection(QPainter *painter, const RenderState &state,
-                                    const ViewportContext &ctx, int endRow,
-                                    int endCol);
+  void drawCursors(QPainter *painter, const RenderState &state,
+                   const ViewportContext &ctx);
+  void drawSelections(QPainter *painter, const RenderState &state,
+                      const ViewportContext &ctx);
+  void drawSingleLineSelection(QPainter *painter, const RenderState &state,
+                               const ViewportContext &ctx, int startRow,
+                               int startCol, int endCol);
+  void drawFirstLineSelection(QPainter *painter, const RenderState &state,
+                              const ViewportContext &ctx, int startRow,
+                              int startCol);
+  void drawMiddleLinesSelection(QPainter *painter, const RenderState &state,
+                                const ViewportContext &ctx, int startRow,
+                                int endRow);
+  void drawLastLineSelection(QPainter *painter, const RenderState &state,
+                             const ViewportContext &ctx, int endRow,
+                             int endCol);
+
+  struct WarmView {
+    uint64_t viewId;
+    LineLayoutCache lineLayouts;
+    TextTileCache textTiles;
+  };
+
+  // Caches of the view being painted.
+  uint64_t viewId = 0;
+  LineLayoutCache lineLayouts;
+  TextTileCache textTiles;
+  // Caches of views shown before, most recently shown first. Both caches only
+  // keep rows around the viewport, so capping the number of views bounds the
+  // memory they use.
+  std::list<WarmView> warmViews;
+
+  static constexpr std::size_t WARM_VIEW_LIMIT = 8;
 
   static constexpr double SELECTION_ALPHA = 50.0;
+  // Rows kept shaped above and below the viewport so small scrolls reuse them.
+  static constexpr int LAYOUT_RETAIN_MARGIN = 64;
 };
 
 #endif
@@ -2,90 +2,83 @@
 #include "features/editor/render/editor_render_utils.h"
 #include <QPainter>
 #include <QPointF>
+#include <QStaticText>
 #include <QString>
+#include <algorithm>
 
 void GutterRenderer::paint(QPainter &painter, const RenderState &state,
                            const ViewportContext &ctx) {
+  lineNumbers.setFont(state.font);
+
   drawText(&painter, state, ctx);
   drawLineHighlight(&painter, state, ctx);
+
+  // Keep numbers for the whole viewport, not just the strip a scroll exposed.
+  const int firstViewportRow =
+      static_cast<int>(ctx.verticalOffset / ctx.lineHeight);
+  const int lastViewportRow =
+      static_cast<int>((ctx.verticalOffset + ctx.height) / ctx.lineHeight);
+  lineNumbers.retainRows(firstViewportRow - NUMBER_RETAIN_MARGIN,
+                         lastViewportRow + NUMBER_RETAIN_MARGIN);
 }
 
 void GutterRenderer::drawText(QPainter *painter, const RenderState &state,
                               const ViewportContext &ctx) {
-  auto drawLine = [painter, state,
-                   ctx](auto rowsWithCursor, auto line, double maxLineWidth,
-                        double numWidth, bool selectionActive,
-                        int selectionStartRow, int selectionEndRow) {
+  painter->setFont(state.font);
+
+  const double maxLineWidth = lineNumbers.maxNumberWidth(state.lineCount);
+  const double numWidth = lineNumbers.digitWidth();
+
+  const auto &selection = state.selections;
+  const int firstRow = std::max(0, ctx.firstVisibleLine);
+  const int lastRow = std::max(firstRow, ctx.lastVisibleLine);
+
+  // Only visible rows are drawn, so only they need to know about cursors.
+  rowsWithCursor.assign(lastRow - firstRow + 1, 0);
+  for (const auto &cursor : state.cursors) {
+    if (cursor.row >= firstRow && cursor.row <= lastRow) {
+      rowsWithCursor[cursor.row - firstRow] = 1;
+    }
+  }
+
+  for (int line = firstRow; line <= lastRow; ++line) {
     const bool cursorIsOnLine =
-        state.isEmpty ? true
-                      : rowsWithCursor[static_cast<const int>(line)] != 0;
+        state.isEmpty || rowsWithCursor[line - firstRow] != 0;
+    const bool lineIsSelected = selection.active &&
+                                line >= selection.start.row &&
+                                line <= selection.end.row;
 
-    const double yPos =
+    const auto &lineNum = lineNumbers.numberFor(line);
+
+    const double baselineY =
         (line * state.lineHeight) +
         (state.lineHeight + state.fontAscent - state.fontDescent) / 2.0 -
         state.verticalOffset;
-
-    const QString lineNum = QString::number(line + 1);
-    const double lineNumWidth = state.measureWidth(lineNum);
     const double xPos = ((ctx.width - maxLineWidth - numWidth) / 2.0) +
-                        (maxLineWidth - lineNumWidth) - state.horizontalOffset;
+                        (maxLineWidth - lineNum.width) -
+                        state.horizontalOffset;
 
-    if (cursorIsOnLine || (selectionActive && line >= selectionStartRow &&
-                           line <= selectionEndRow)) {
+    if (cursorIsOnLine || lineIsSelected) {
       painter->setPen(state.theme.activeLineTextColor);
     } else {
       painter->setPen(state.theme.textColor);
     }
 
-    painter->drawText(QPointF(xPos, yPos), lineNum);
-  };
-
-  painter->setPen(state.theme.textColor);
-  painter->setFont(state.font);
-
-  const int maxLineNumber = state.lineCount;
-  const double maxLineWidth =
-      state.measureWidth(QString::number(maxLineNumber));
-  const double numWidth = state.measureWidth(QString::number(9));
-
-  const auto selection = state.selections;
-  const int selectionStartRow = selection.start.row;
-  const int selectionEndRow = selection.end.row;
-  const int selectionStartCol = selection.start.column;
-  const int selectionEndCol = selection.end.column;
-  const bool selectionActive = selection.active;
-
-  std::vector<uint8_t> rowsWithCursor(state.lineCount, 0);
-  for (const auto &cursor : state.cursors) {
-    if (cursor.row >= 0 && cursor.row < rowsWithCursor.size()) {
-      rowsWithCursor[cursor.row] = 1;
-    }
-  }
-
-  if (ctx.firstVisibleLine <= 0 && ctx.lastVisibleLine <= 0) {
-    drawLine(rowsWithCursor, 0, maxLineWidth, numWidth, selectionActive,
-             selectionStartRow, selectionEndRow);
-    return;
-  }
-
-  for (int line = ctx.firstVisibleLine; line <= ctx.lastVisibleLine; ++line) {
-    drawLine(rowsWithCursor, line, maxLineWidth, numWidth, selectionActive,
-             selectionStartRow, selectionEndRow);
+    painter->drawStaticText(QPointF(xPos, baselineY - state.fontAscent),
+                            lineNum.text);
   }
 }
 
 void GutterRenderer::drawLineHighlight(QPainter *painter,
                                        const RenderState &state,
                                        const ViewportContext &ctx) {
-  const auto cursors = state.cursors;
-
   std::vector<int> highlightedLines = std::vector<int>();
-  for (const auto cursor : cursors) {
+  for (const auto &cursor : state.cursors) {
     const int cursorRow = static_cast<int>(cursor.row);
     const int cursorCol = static_cast<int>(cursor.column);
 
     if (cursorRow < ctx.firstVisibleLine || cursorRow > ctx.lastVisibleLine) {
-      return;
+      continue;
     }
 
     if (std::find(highlightedLines.begin(), highlightedLines.end(),
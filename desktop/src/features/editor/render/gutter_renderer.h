@@ -1,21 +1,31 @@
 #ifndef GUTTER_RENDERER_H
 #define GUTTER_RENDERER_H
 
+#include "features/editor/render/line_number_cache.h"
 #include "features/editor/render/types/types.h"
 #include "types/qt_types_fwd.h"
+#include <cstdint>
+#include <vector>
 
 QT_FWD(QPainter)
 
 class GutterRenderer {
 public:
-  static void paint(QPainter &painter, const RenderState &state,
-                    const ViewportContext &ctx);
+  void paint(QPainter &painter, const RenderState &state,
+             const ViewportContext &ctx);
 
 private:
-  static void drawText(QPainter *painter, const RenderState &state,
-                       const ViewportContext &ctx);
+  void drawText(QPainter *painter, const RenderState &state,
+                const ViewportContext &ctx);
   static void drawLineHighlight(QPainter *painter, const RenderState &state,
                                 const ViewportContext &ctx);
+
+  LineNumberCache lineNumbers;
+  // Reused between frames; one entry per visible row.
+  std::vector<uint8_t> rowsWithCursor;
+
+  // Rows kept shaped above and below the viewport so small scrolls reuse them.
+  static constexpr int NUMBER_RETAIN_MARGIN = 64;
 };
 
 #endif // GUTTER_RENDERER_H
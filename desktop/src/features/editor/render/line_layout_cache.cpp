@@ -0,0 +1,83 @@
+#include "line_layout_cache.h"
+#include <QTextLine>
+#include <QTextOption>
+#include <algorithm>
+
+void LineLayoutCache::setFont(const QFont &newFont) {
+  if (font == newFont) {
+    return;
+  }
+
+  font = newFont;
+  clear();
+}
+
+void LineLayoutCache::clear() { entries.clear(); }
+
+void LineLayoutCache::invalidateRows(const int firstRow, const int lastRow) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    const int row = it->first;
+    const bool isDirty = row >= firstRow && (lastRow < 0 || row <= lastRow);
+
+    it = isDirty ? entries.erase(it) : std::next(it);
+  }
+}
+
+void LineLayoutCache::retainRows(const int firstRow, const int lastRow) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    const int row = it->first;
+    const bool isOutside = row < firstRow || row > lastRow;
+
+    it = isOutside ? entries.erase(it) : std::next(it);
+  }
+}
+
+QTextLayout &LineLayoutCache::layoutFor(const int row, const QString &text) {
+  auto &entry = entries[row];
+
+  if (entry.layout != nullptr && entry.text == text) {
+    return *entry.layout;
+  }
+
+  QTextOption option;
+  option.setWrapMode(QTextOption::NoWrap);
+
+  entry.text = text;
+  entry.layout = std::make_unique<QTextLayout>(text, font);
+  entry.layout->setTextOption(option);
+  entry.layout->setCacheEnabled(true);
+  entry.layout->beginLayout();
+
+  QTextLine textLine = entry.layout->createLine();
+  if (textLine.isValid()) {
+    textLine.setLineWidth(MAX_LINE_WIDTH);
+  }
+
+  entry.layout->endLayout();
+
+  return *entry.layout;
+}
+
+double LineLayoutCache::columnToX(const int row, const QString &text,
+                                  const int column) {
+  const QTextLine textLine = layoutFor(row, text).lineAt(0);
+
+  if (!textLine.isValid()) {
+    return 0;
+  }
+
+  const int clampedColumn =
+      std::clamp(column, 0, static_cast<int>(text.length()));
+  return textLine.cursorToX(clampedColumn);
+}
+
+int LineLayoutCache::xToColumn(const int row, const QString &text,
+                               const double xPos) {
+  const QTextLine textLine = layoutFor(row, text).lineAt(0);
+
+  if (!textLine.isValid()) {
+    return 0;
+  }
+
+  return textLine.xToCursor(xPos);
+}
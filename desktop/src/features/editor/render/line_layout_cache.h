@@ -0,0 +1,45 @@
+#ifndef LINE_LAYOUT_CACHE_H
+#define LINE_LAYOUT_CACHE_H
+
+#include <QFont>
+#include <QString>
+#include <QTextLayout>
+#include <memory>
+#include <unordered_map>
+
+/// \class LineLayoutCache
+/// \brief Keeps shaped QTextLayouts for editor rows so repaints, caret moves
+/// and x/column lookups reuse glyph runs instead of reshaping every frame.
+///
+/// Entries are keyed by row and validated against the line text, so a stale
+/// entry is reshaped rather than drawn. Rows reported dirty by the core are
+/// evicted eagerly via `invalidateRows`.
+class LineLayoutCache {
+public:
+  void setFont(const QFont &newFont);
+  void clear();
+
+  /// Drops cached rows in `[firstRow, lastRow]`. A negative `lastRow` drops
+  /// every row from `firstRow` to the end.
+  void invalidateRows(int firstRow, int lastRow);
+
+  /// Drops cached rows outside of `[firstRow, lastRow]`.
+  void retainRows(int firstRow, int lastRow);
+
+  QTextLayout &layoutFor(int row, const QString &text);
+  [[nodiscard]] double columnToX(int row, const QString &text, int column);
+  [[nodiscard]] int xToColumn(int row, const QString &text, double xPos);
+
+private:
+  struct Entry {
+    QString text;
+    std::unique_ptr<QTextLayout> layout;
+  };
+
+  QFont font;
+  std::unordered_map<int, Entry> entries;
+
+  static constexpr double MAX_LINE_WIDTH = 1e9;
+};
+
+#endif // LINE_LAYOUT_CACHE_H
@@ -0,0 +1,60 @@
+#include "line_number_cache.h"
+#include <QString>
+#include <QTransform>
+#include <iterator>
+
+void LineNumberCache::setFont(const QFont &newFont) {
+  if (font == newFont) {
+    return;
+  }
+
+  font = newFont;
+  fontMetrics = QFontMetricsF(font);
+  clear();
+}
+
+void LineNumberCache::clear() {
+  entries.clear();
+  maxNumberLineCount = -1;
+}
+
+void LineNumberCache::retainRows(const int firstRow, const int lastRow) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    const int row = it->first;
+    const bool isOutside = row < firstRow || row > lastRow;
+
+    it = isOutside ? entries.erase(it) : std::next(it);
+  }
+}
+
+const LineNumberCache::Entry &LineNumberCache::numberFor(const int row) {
+  auto &entry = entries[row];
+
+  if (entry.width > 0) {
+    return entry;
+  }
+
+  const QString number = QString::number(row + 1);
+
+  entry.text.setText(number);
+  entry.text.setTextFormat(Qt::PlainText);
+  entry.text.setPerformanceHint(QStaticText::AggressiveCaching);
+  entry.text.prepare(QTransform(), font);
+  entry.width = fontMetrics.horizontalAdvance(number);
+
+  return entry;
+}
+
+double LineNumberCache::maxNumberWidth(const int lineCount) {
+  if (lineCount != maxNumberLineCount) {
+    maxNumberLineCount = lineCount;
+    maxNumberWidthValue =
+        fontMetrics.horizontalAdvance(QString::number(lineCount));
+  }
+
+  return maxNumberWidthValue;
+}
+
+double LineNumberCache::digitWidth() const {
+  return fontMetrics.horizontalAdvance(QLatin1Char('9'));
+}
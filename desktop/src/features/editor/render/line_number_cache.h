@@ -0,0 +1,43 @@
+#ifndef LINE_NUMBER_CACHE_H
+#define LINE_NUMBER_CACHE_H
+
+#include <QFont>
+#include <QFontMetricsF>
+#include <QStaticText>
+#include <unordered_map>
+
+/// \class LineNumberCache
+/// \brief Keeps shaped gutter line numbers so repaints draw cached glyphs
+/// instead of formatting and measuring every visible number each frame.
+///
+/// Entries are keyed by row, whose number never changes, so they only need
+/// to be dropped when the font changes or the row scrolls far out of view.
+class LineNumberCache {
+public:
+  struct Entry {
+    QStaticText text;
+    double width = 0;
+  };
+
+  void setFont(const QFont &newFont);
+  void clear();
+
+  /// Drops cached rows outside of `[firstRow, lastRow]`.
+  void retainRows(int firstRow, int lastRow);
+
+  /// The number shown for `row`, i.e. `row + 1`.
+  const Entry &numberFor(int row);
+  /// Width of the widest number in a document with `lineCount` lines.
+  [[nodiscard]] double maxNumberWidth(int lineCount);
+  [[nodiscard]] double digitWidth() const;
+
+private:
+  QFont font;
+  QFontMetricsF fontMetrics{font};
+  std::unordered_map<int, Entry> entries;
+
+  int maxNumberLineCount = -1;
+  double maxNumberWidthValue = 0;
+};
+
+#endif // LINE_NUMBER_CACHE_H
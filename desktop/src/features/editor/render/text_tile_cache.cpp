@@ -0,0 +1,188 @@
+#include "text_tile_cache.h"
+#include "features/editor/render/editor_render_utils.h"
+#include <QPaintDevice>
+#include <QPainter>
+#include <QPointF>
+#include <QSize>
+#include <QStringList>
+#include <QTextLayout>
+#include <QTextLine>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+void TextTileCache::setFont(const QFont &newFont) {
+  if (font == newFont) {
+    return;
+  }
+
+  font = newFont;
+  clear();
+}
+
+void TextTileCache::clear() { tiles.clear(); }
+
+void TextTileCache::invalidateRows(const int firstRow, const int lastRow) {
+  const int firstBand = std::max(0, firstRow) / TILE_ROWS;
+  const int lastBand = lastRow < 0 ? -1 : lastRow / TILE_ROWS;
+
+  for (auto it = tiles.begin(); it != tiles.end();) {
+    const int band = bandOf(it->first);
+    const bool isDirty =
+        band >= firstBand && (lastBand < 0 || band <= lastBand);
+
+    it = isDirty ? tiles.erase(it) : std::next(it);
+  }
+
+  hasReportedChanges = true;
+}
+
+void TextTileCache::forgetReportedChanges() { hasReportedChanges = false; }
+
+void TextTileCache::retainRows(const int firstRow, const int lastRow) {
+  const int firstBand = std::max(0, firstRow) / TILE_ROWS;
+  const int lastBand = std::max(0, lastRow) / TILE_ROWS;
+
+  for (auto it = tiles.begin(); it != tiles.end();) {
+    const int band = bandOf(it->first);
+    const bool isOutside = band < firstBand || band > lastBand;
+
+    it = isOutside ? tiles.erase(it) : std::next(it);
+  }
+}
+
+void TextTileCache::draw(QPainter *painter, const RenderState &state,
+                         const ViewportContext &ctx,
+                         LineLayoutCache &layouts) {
+  const qreal pixelRatio = painter->device()->devicePixelRatioF();
+
+  // Tiles bake in the color, line height and pixel density they were drawn
+  // with.
+  if (textColor != state.theme.textColor || lineHeight != ctx.lineHeight ||
+      devicePixelRatio != pixelRatio) {
+    textColor = state.theme.textColor;
+    lineHeight = ctx.lineHeight;
+    devicePixelRatio = pixelRatio;
+    clear();
+  }
+
+  // Any row may differ in a version no `invalidateRows` call accounted for.
+  if (state.bufferVersion != bufferVersion) {
+    if (!hasReportedChanges) {
+      clear();
+    }
+
+    bufferVersion = state.bufferVersion;
+  }
+  hasReportedChanges = false;
+
+  const int firstRow = std::max(0, ctx.firstVisibleLine);
+  const int lastRow =
+      std::max(firstRow, std::min(ctx.lastVisibleLine, state.lineCount - 1));
+  const int firstColumn = static_cast<int>(ctx.horizontalOffset) / TILE_WIDTH;
+  const int lastColumn =
+      static_cast<int>(ctx.horizontalOffset + ctx.width) / TILE_WIDTH;
+
+  for (int band = firstRow / TILE_ROWS; band <= lastRow / TILE_ROWS; ++band) {
+    const double yPos =
+        bandTopPixel(band, ctx.lineHeight) - std::floor(ctx.verticalOffset);
+
+    for (int column = firstColumn; column <= lastColumn; ++column) {
+      const Tile &tile = tileFor(band, column, state, ctx, layouts);
+      if (tile.pixmap.isNull()) {
+        continue;
+      }
+
+      const double xPos =
+          (column * TILE_WIDTH) - std::floor(ctx.horizontalOffset);
+      painter->drawPixmap(QPointF(xPos, yPos), tile.pixmap);
+    }
+  }
+}
+
+int64_t TextTileCache::keyFor(const int band, const int column) {
+  return (static_cast<int64_t>(band) << 32) | static_cast<uint32_t>(column);
+}
+
+int TextTileCache::bandOf(const int64_t key) {
+  return static_cast<int>(key >> 32);
+}
+
+int TextTileCache::bandTopPixel(const int band, const double lineHeight) {
+  // Tiles are placed on whole pixels so blitting never resamples them; the
+  // fractional part of the band's position is drawn into the tile instead.
+  return static_cast<int>(std::floor(band * TILE_ROWS * lineHeight));
+}
+
+const TextTileCache::Tile &
+TextTileCache::tileFor(const int band, const int column,
+                       const RenderState &state, const ViewportContext &ctx,
+                       LineLayoutCache &layouts) {
+  const auto [entry, isNew] = tiles.try_emplace(keyFor(band, column));
+  if (isNew) {
+    entry->second.pixmap = renderTile(band, column, state, ctx, layouts);
+  }
+
+  return entry->second;
+}
+
+QPixmap TextTileCache::renderTile(const int band, const int column,
+                                  const RenderState &state,
+                                  const ViewportContext &ctx,
+                                  LineLayoutCache &layouts) const {
+  const int firstRow = band * TILE_ROWS;
+  const int lastRow = std::min(firstRow + TILE_ROWS, state.lineCount) - 1;
+
+  QStringList lines;
+  lines.reserve(TILE_ROWS);
+  for (int row = firstRow; row <= lastRow; ++row) {
+    lines.append(getLineText(row, state));
+  }
+
+  const double left = column * TILE_WIDTH;
+  const double top = bandTopPixel(band, ctx.lineHeight);
+
+  // Most lines are short, so tiles to the right are often blank.
+  bool hasText = false;
+  for (int index = 0; index < lines.size() && !hasText; ++index) {
+    const QTextLine textLine =
+        layouts.layoutFor(firstRow + index, lines.at(index)).lineAt(0);
+    hasText = textLine.isValid() && textLine.naturalTextWidth() > left;
+  }
+
+  if (!hasText) {
+    return {};
+  }
+
+  // One extra row leaves room for glyphs that hang below the last baseline.
+  const double tileHeight = (TILE_ROWS + 1) * ctx.lineHeight;
+  const QSize pixelSize(
+      static_cast<int>(std::ceil(TILE_WIDTH * devicePixelRatio)),
+      static_cast<int>(std::ceil(tileHeight * devicePixelRatio)));
+
+  QPixmap pixmap(pixelSize);
+  pixmap.setDevicePixelRatio(devicePixelRatio);
+  pixmap.fill(Qt::transparent);
+
+  QPainter painter(&pixmap);
+  painter.setPen(state.theme.textColor);
+  painter.setFont(state.font);
+
+  for (int index = 0; index < lines.size(); ++index) {
+    const int row = firstRow + index;
+    QTextLayout &layout = layouts.layoutFor(row, lines.at(index));
+    const QTextLine textLine = layout.lineAt(0);
+
+    if (!textLine.isValid()) {
+      continue;
+    }
+
+    const double baselineY =
+        (row * ctx.lineHeight) - top +
+        (ctx.lineHeight + state.fontAscent - state.fontDescent) / 2.0;
+
+    layout.draw(&painter, QPointF(-left, baselineY - textLine.ascent()));
+  }
+
+  return pixmap;
+}
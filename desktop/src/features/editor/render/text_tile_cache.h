@@ -0,0 +1,78 @@
+#ifndef TEXT_TILE_CACHE_H
+#define TEXT_TILE_CACHE_H
+
+#include "features/editor/render/line_layout_cache.h"
+#include "features/editor/render/types/types.h"
+#include "types/qt_types_fwd.h"
+#include <QFont>
+#include <QPixmap>
+#include <QString>
+#include <cstdint>
+#include <unordered_map>
+
+QT_FWD(QPainter)
+
+/// \class TextTileCache
+/// \brief Keeps editor text rendered into offscreen tiles so repaints that
+/// only move carets, selections or highlights blit pixmaps instead of drawing
+/// glyphs.
+///
+/// A tile covers `TILE_ROWS` rows and `TILE_WIDTH` pixels of content. Edits
+/// evict the tiles of their rows through `invalidateRows`; a buffer version
+/// that changed without such a report (a load, a reload, an eviction) drops
+/// every tile.
+class TextTileCache {
+public:
+  static constexpr int TILE_ROWS = 16;
+  static constexpr int TILE_WIDTH = 512;
+
+  void setFont(const QFont &newFont);
+  void clear();
+
+  /// Drops tiles overlapping `[firstRow, lastRow]`. A negative `lastRow`
+  /// drops every tile from `firstRow` to the end. The remaining tiles stay
+  /// valid for the next buffer version drawn.
+  void invalidateRows(int firstRow, int lastRow);
+
+  /// Stops trusting reports that have not been drawn yet, for a cache that is
+  /// put aside: its buffer can change in ways nobody reports while hidden.
+  void forgetReportedChanges();
+
+  /// Drops tiles that do not overlap `[firstRow, lastRow]`.
+  void retainRows(int firstRow, int lastRow);
+
+  /// Draws the text of the visible rows in `ctx`, rendering any missing tiles
+  /// first. `state.lines` must cover every row of the tiles in view.
+  void draw(QPainter *painter, const RenderState &state,
+            const ViewportContext &ctx, LineLayoutCache &layouts);
+
+private:
+  struct Tile {
+    // Null when no text reaches into the tile.
+    QPixmap pixmap;
+  };
+
+  [[nodiscard]] static int64_t keyFor(int band, int column);
+  [[nodiscard]] static int bandOf(int64_t key);
+  [[nodiscard]] static int bandTopPixel(int band, double lineHeight);
+
+  const Tile &tileFor(int band, int column, const RenderState &state,
+                      const ViewportContext &ctx, LineLayoutCache &layouts);
+  [[nodiscard]] QPixmap renderTile(int band, int column,
+                                   const RenderState &state,
+                                   const ViewportContext &ctx,
+                                   LineLayoutCache &layouts) const;
+
+  QFont font;
+  QString textColor;
+  double lineHeight = 0;
+  qreal devicePixelRatio = 0;
+  // Buffer version the tiles were drawn from.
+  uint64_t bufferVersion = 0;
+  // Set by `invalidateRows` until the next draw: the buffer changed, but only
+  // in the rows already evicted.
+  bool hasReportedChanges = false;
+  std::unordered_map<int64_t, Tile> tiles;
+};
+
+#endif // TEXT_TILE_CACHE_H
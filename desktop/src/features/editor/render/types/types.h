@@ -6,6 +6,7 @@
 #include <QRectF>
 #include <QString>
 #include <QStringList>
+#include <cstdint>
 #include <functional>
 #include <neko-core/src/ffi/bridge.rs.h>
 #include <vector>
@@ -28,7 +29,9 @@ struct RenderTheme {
 };
 
 struct RenderState {
+  // Only the visible window of lines; `lines[0]` is row `firstLineIndex`.
   const QStringList lines;
+  const int firstLineIndex;
   const std::vector<Cursor> cursors;
   const Selection selections;
   const RenderTheme theme;
@@ -41,6 +44,8 @@ struct RenderState {
   const QFont font;
   const bool hasFocus;
   const bool isEmpty;
+  // `Buffer::version` of the text `lines` was read from.
+  const uint64_t bufferVersion;
 
   const std::function<const double(const QString &str)> measureWidth;
 };
@@ -1,7 +1,9 @@
 #ifndef EDITOR_TYPES_H
 #define EDITOR_TYPES_H
 
+#include <QStringList>
 #include <cstdint>
+#include <vector>
 
 struct Cursor {
   int row;
@@ -15,6 +17,19 @@ struct Selection {
   bool active;
 };
 
+/// Lines, cursors and selection for a window of rows, as needed to paint the
+/// editor and gutter. `lines[0]` is row `firstRow`, and only the cursors on
+/// those rows are included.
+struct RenderSnapshot {
+  int firstRow = 0;
+  QStringList lines;
+  std::vector<Cursor> cursors;
+  Selection selection{};
+  int lineCount = 0;
+  uint64_t bufferVersion = 0;
+  bool isEmpty = true;
+};
+
 // TODO(scarlet): Merge with Cursor type
 struct RowCol {
   int row;
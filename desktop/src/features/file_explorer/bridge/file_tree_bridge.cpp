@@ -1,9 +1,44 @@
 #include "file_tree_bridge.h"
+#include <algorithm>
 
 // TODO(scarlet): Ideally convert all ::rust::String returns to c_str or
 // QString.
 FileTreeBridge::FileTreeBridge(FileTreeBridgeProps props, QObject *parent)
     : QObject(parent), fileTreeController(std::move(props.fileTreeController)) {
+  listingPollTimer.setInterval(LISTING_POLL_INTERVAL_MS);
+  connect(&listingPollTimer, &QTimer::timeout, this,
+          &FileTreeBridge::pollListings);
+
+  changePollTimer.setInterval(CHANGE_POLL_INTERVAL_MS);
+  connect(&changePollTimer, &QTimer::timeout, this,
+          &FileTreeBridge::pollChanges);
+  changePollTimer.start();
+}
+
+void FileTreeBridge::startListingPolling() {
+  if (!listingPollTimer.isActive() &&
+      fileTreeController->has_pending_listings()) {
+    listingPollTimer.start();
+  }
+}
+
+void FileTreeBridge::pollListings() {
+  if (fileTreeController->poll_listings()) {
+    emit nodesChanged();
+  }
+
+  if (!fileTreeController->has_pending_listings()) {
+    listingPollTimer.stop();
+  }
+}
+
+void FileTreeBridge::pollChanges() {
+  if (fileTreeController->poll_changes()) {
+    emit nodesChanged();
+  }
+
+  // Changed directories are re-listed in the background.
+  startListingPolling();
 }
 
 neko::MaybeFileNodeSnapshot FileTreeBridge::getLastNode() {
@@ -18,6 +53,39 @@ neko::FileTreeSnapshot FileTreeBridge::getTreeSnapshot() {
   return fileTreeController->get_tree_snapshot();
 }
 
+int FileTreeBridge::getVisibleCount() {
+  return static_cast<int>(fileTreeController->get_visible_count());
+}
+
+rust::Vec<neko::FileNodeSnapshot> FileTreeBridge::getVisibleRange(int start,
+                                                                  int count) {
+  return fileTreeController->get_visible_range(
+      static_cast<size_t>(std::max(0, start)),
+      static_cast<size_t>(std::max(0, count)));
+}
+
+neko::VisibleNodeSnapshot FileTreeBridge::getCurrentNode() {
+  return fileTreeController->get_current_node();
+}
+
+bool FileTreeBridge::isExpanded(const QString &directoryPath) {
+  return fileTreeController->is_expanded(directoryPath.toStdString());
+}
+
+QStringList FileTreeBridge::getLongestVisibleNames(int limit) {
+  QStringList names;
+  const auto rawNames = fileTreeController->get_longest_visible_names(
+      static_cast<size_t>(std::max(0, limit)));
+
+  names.reserve(static_cast<qsizetype>(rawNames.size()));
+  for (const auto &name : rawNames) {
+    names.append(QString::fromUtf8(name.data(),
+                                   static_cast<qsizetype>(name.size())));
+  }
+
+  return names;
+}
+
 QString FileTreeBridge::getParentNodePath(const QString &path) {
   return fileTreeController->get_path_of_parent(path.toStdString()).c_str();
 }
@@ -57,6 +125,7 @@ void FileTreeBridge::setRootDirectory(const QString &rootDirectoryPath) {
 
 void FileTreeBridge::setExpanded(const QString &directoryPath) {
   fileTreeController->set_expanded(directoryPath.toStdString());
+  startListingPolling();
 }
 
 void FileTreeBridge::setCurrent(const QString &itemPath) {
@@ -69,6 +138,7 @@ void FileTreeBridge::clearCurrent() {
 
 void FileTreeBridge::toggleExpanded(const QString &directoryPath) {
   fileTreeController->toggle_expanded(directoryPath.toStdString());
+  startListingPolling();
 }
 
 void FileTreeBridge::toggleSelect(const QString &nodePath) {
@@ -3,6 +3,8 @@
 
 #include "neko-core/src/ffi/bridge.rs.h"
 #include <QObject>
+#include <QStringList>
+#include <QTimer>
 
 class FileTreeBridge : public QObject {
   Q_OBJECT
@@ -18,6 +20,11 @@ public:
   neko::MaybeFileNodeSnapshot getLastNode();
   neko::MaybeFileNodeSnapshot getFirstNode();
   neko::FileTreeSnapshot getTreeSnapshot();
+  int getVisibleCount();
+  rust::Vec<neko::FileNodeSnapshot> getVisibleRange(int start, int count);
+  neko::VisibleNodeSnapshot getCurrentNode();
+  bool isExpanded(const QString &directoryPath);
+  QStringList getLongestVisibleNames(int limit);
   QString getParentNodePath(const QString &path);
   std::vector<neko::FileNodeSnapshot>
   getVisibleChildren(const QString &directoryPath);
@@ -33,9 +40,26 @@ public:
   void toggleSelect(const QString &nodePath);
   void setCollapsed(const QString &directoryPath);
   void refreshDirectory(const QString &directoryPath);
+  void startListingPolling();
+
+signals:
+  void nodesChanged();
 
 private:
+  void pollListings();
+  void pollChanges();
+
   rust::Box<neko::FileTreeController> fileTreeController;
+
+  // Polls the core for directories being listed on worker threads while any
+  // are pending.
+  QTimer listingPollTimer;
+  // Picks up directories the core's watcher saw change on disk. Always
+  // running, since changes can come from outside the editor at any time.
+  QTimer changePollTimer;
+
+  static constexpr int LISTING_POLL_INTERVAL_MS = 16;
+  static constexpr int CHANGE_POLL_INTERVAL_MS = 500;
 };
 
 #endif
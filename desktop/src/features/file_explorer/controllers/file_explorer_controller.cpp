@@ -4,11 +4,13 @@
 #include "features/main_window/services/file_io_service.h"
 #include <utility>
 
-// TODO(scarlet): Cache tree snapshots?
 // TODO(scarlet): Add customizable keybindings/vim keybinds.
 FileExplorerController::FileExplorerController(
     const FileExplorerControllerProps &props, QObject *parent)
     : fileTreeBridge(props.fileTreeBridge), QObject(parent) {
+  connect(fileTreeBridge, &FileTreeBridge::nodesChanged, this,
+          &FileExplorerController::nodesChanged);
+
   // Copy/Cut/Paste/Duplicate operations.
   bind(
       QKeyCombination(Qt::ControlModifier | Qt::AltModifier | Qt::ShiftModifier,
@@ -132,20 +134,53 @@ void FileExplorerController::setExpanded(const QString &directoryPath) {
   fileTreeBridge->setExpanded(directoryPath);
 }
 
-// Returns the number of nodes in the tree.
+// Returns the number of visible nodes in the tree.
 int FileExplorerController::getNodeCount() {
-  auto snapshot = fileTreeBridge->getTreeSnapshot();
+  return fileTreeBridge->getVisibleCount();
+}
+
+// Returns the current node and its row, if it is visible.
+FileNodeInfo FileExplorerController::getCurrentNode() {
+  auto currentNode = fileTreeBridge->getCurrentNode();
+
+  if (!currentNode.found_node) {
+    return {};
+  }
+
+  return {.index = static_cast<int>(currentNode.index),
+          .nodeSnapshot = currentNode.node};
+}
+
+// Returns the node at the provided visible row, if there is one and it is not a
+// placeholder.
+FileNodeInfo FileExplorerController::getNodeByIndex(int targetIndex) {
+  if (targetIndex < 0) {
+    return {};
+  }
+
+  auto nodes = fileTreeBridge->getVisibleRange(targetIndex, 1);
+
+  // Placeholder rows can't be hovered, selected or dragged.
+  if (nodes.empty() || nodes.front().is_placeholder) {
+    return {};
+  }
+
+  return {.index = targetIndex, .nodeSnapshot = nodes.front()};
+}
 
-  return static_cast<int>(snapshot.nodes.size());
+// Returns up to `count` visible nodes, starting at row `firstIndex`.
+rust::Vec<neko::FileNodeSnapshot>
+FileExplorerController::getVisibleNodes(int firstIndex, int count) {
+  return fileTreeBridge->getVisibleRange(firstIndex, count);
 }
 
-// Returns a snapshot of the current tree state.
-neko::FileTreeSnapshot FileExplorerController::getTreeSnapshot() {
-  return fileTreeBridge->getTreeSnapshot();
+// Returns the longest visible node names, for sizing the content width.
+QStringList FileExplorerController::getLongestNodeNames(int limit) {
+  return fileTreeBridge->getLongestVisibleNames(limit);
 }
 
 neko::FileExplorerContextFfi FileExplorerController::getCurrentContext() {
-  auto currentNode = getNode([](const auto &node) { return node.is_current; });
+  auto currentNode = getCurrentNode();
   auto pasteInfo = FileIoService::getClipboardItems();
   rust::Vec<neko::PasteItemFfi> rustPasteItems;
 
@@ -182,7 +217,7 @@ neko::FileExplorerContextFfi FileExplorerController::getCurrentContext() {
 // Retrieves the current node information, and then calls `FileIoService` to
 // perform the actual operation.
 void FileExplorerController::handleCut() {
-  auto nodeInfo = getNode([](const auto &node) { return node.is_current; });
+  auto nodeInfo = getCurrentNode();
 
   // If the node was found, perform the cut.
   if (nodeInfo.foundNode()) {
@@ -195,7 +230,7 @@ void FileExplorerController::handleCut() {
 // Retrieves the current node information, and then calls `FileIoService` to
 // perform the actual operation.
 void FileExplorerController::handleCopy() {
-  auto nodeInfo = getNode([](const auto &node) { return node.is_current; });
+  auto nodeInfo = getCurrentNode();
 
   // If the node was found, perform the copy.
   if (nodeInfo.foundNode()) {
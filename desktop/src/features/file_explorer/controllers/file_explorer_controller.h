@@ -42,37 +42,10 @@ public:
                                   QObject *parent = nullptr);
   ~FileExplorerController() override = default;
 
-  template <typename Predicate> FileNodeInfo getNode(Predicate predicate) {
-    auto snapshot = fileTreeBridge->getTreeSnapshot();
-    int index = 0;
-
-    for (const auto &node : snapshot.nodes) {
-      if (predicate(node)) {
-        return {.index = index, .nodeSnapshot = node};
-      }
-
-      index++;
-    }
-
-    return {};
-  }
-
-  FileNodeInfo getNodeByIndex(int targetIndex) {
-    auto snapshot = fileTreeBridge->getTreeSnapshot();
-    int index = 0;
-
-    for (const auto &node : snapshot.nodes) {
-      if (targetIndex == index) {
-        return {.index = index, .nodeSnapshot = node};
-      }
-
-      index++;
-    }
-
-    return {};
-  }
-
-  neko::FileTreeSnapshot getTreeSnapshot();
+  FileNodeInfo getCurrentNode();
+  FileNodeInfo getNodeByIndex(int targetIndex);
+  rust::Vec<neko::FileNodeSnapshot> getVisibleNodes(int firstIndex, int count);
+  QStringList getLongestNodeNames(int limit);
   int getNodeCount();
 
   void loadDirectory(const QString &rootDirectoryPath);
@@ -97,6 +70,7 @@ public:
 
 signals:
   void rootDirectoryChanged(const QString &rootDirectoryPath);
+  void nodesChanged();
   void commandRequested(const std::string &commandId,
                         const neko::FileExplorerContextFfi &ctx,
                         bool bypassDeleteConfirmation);
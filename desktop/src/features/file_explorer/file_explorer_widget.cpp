@@ -83,10 +83,16 @@ void FileExplorerWidget::connectSignals() {
           this, &FileExplorerWidget::commandRequested);
   connect(fileExplorerController, &FileExplorerController::requestFocusEditor,
           this, &FileExplorerWidget::requestFocusEditor);
+  connect(fileExplorerController, &FileExplorerController::nodesChanged, this,
+          [this] {
+            updateDimensions();
+            redraw();
+          });
 }
 
 void FileExplorerWidget::setAndApplyTheme(const FileExplorerTheme &newTheme) {
   theme = newTheme;
+  iconCache.clear();
 
   setStyleSheet(UiUtils::getScrollBarStylesheet(
       theme.scrollBarTheme.thumbColor, theme.scrollBarTheme.thumbHoverColor,
@@ -110,8 +116,7 @@ void FileExplorerWidget::setAndApplyTheme(const FileExplorerTheme &newTheme) {
 }
 
 void FileExplorerWidget::itemRevealRequested() {
-  auto nodeInfo = fileExplorerController->getNode(
-      [](const auto node) { return node.is_current; });
+  auto nodeInfo = fileExplorerController->getCurrentNode();
 
   if (nodeInfo.foundNode()) {
     scrollToNode(nodeInfo.index);
@@ -129,8 +134,7 @@ void FileExplorerWidget::keyPressEvent(QKeyEvent *event) {
   }
 
   if (changeSet.scroll) {
-    auto node = fileExplorerController->getNode(
-        [](const neko::FileNodeSnapshot &node) { return node.is_current; });
+    auto node = fileExplorerController->getCurrentNode();
 
     if (node.foundNode()) {
       scrollToNode(node.index);
@@ -252,7 +256,7 @@ void FileExplorerWidget::performDrag(int row,
 
   {
     auto ctx = getViewportContext();
-    auto state = getRenderState();
+    auto state = getRenderState(row, 1);
     const double opacity = 0.85;
 
     QPainter painter(&dragPixmap);
@@ -313,14 +317,15 @@ void FileExplorerWidget::dropEvent(QDropEvent *event) {
   event->acceptProposedAction();
 }
 
-FileExplorerRenderState FileExplorerWidget::getRenderState() {
-  auto snapshot = fileExplorerController->getTreeSnapshot();
-
+FileExplorerRenderState FileExplorerWidget::getRenderState(int firstRow,
+                                                           int rowCount) {
   FileExplorerRenderState state{
-      .snapshot = snapshot,
+      .nodes = fileExplorerController->getVisibleNodes(firstRow, rowCount),
+      .firstNodeIndex = firstRow,
       .font = font,
       .fontAscent = fontMetrics.ascent(),
       .theme = theme,
+      .iconCache = iconCache,
       .hasFocus = hasFocus(),
       .hoveredNodePath = hoveredNodePath,
       .dragHoveredNodePath = dragHoveredNodePath,
@@ -332,8 +337,6 @@ FileExplorerRenderState FileExplorerWidget::getRenderState() {
 }
 
 FileExplorerViewportContext FileExplorerWidget::getViewportContext() {
-  auto snapshot = fileExplorerController->getTreeSnapshot();
-
   double lineHeight = fontMetrics.height();
   double verticalOffset = verticalScrollBar()->value();
   double horizontalOffset = horizontalScrollBar()->value();
@@ -344,7 +347,7 @@ FileExplorerViewportContext FileExplorerWidget::getViewportContext() {
   int endRow = std::ceil((verticalOffset + viewportHeight) / lineHeight);
 
   startRow = std::max(0, startRow);
-  endRow = std::min(static_cast<int>(snapshot.nodes.size()), endRow);
+  endRow = std::min(fileExplorerController->getNodeCount(), endRow);
 
   FileExplorerViewportContext ctx{
       .lineHeight = lineHeight,
@@ -354,6 +357,7 @@ FileExplorerViewportContext FileExplorerWidget::getViewportContext() {
       .horizontalOffset = horizontalOffset,
       .width = viewportWidth,
       .height = viewportHeight,
+      .devicePixelRatio = viewport()->devicePixelRatioF(),
   };
 
   return ctx;
@@ -362,8 +366,9 @@ FileExplorerViewportContext FileExplorerWidget::getViewportContext() {
 void FileExplorerWidget::paintEvent(QPaintEvent *event) {
   QPainter painter(viewport());
 
-  auto state = getRenderState();
   auto ctx = getViewportContext();
+  auto state = getRenderState(ctx.firstVisibleLine,
+                              ctx.lastVisibleLine - ctx.firstVisibleLine);
 
   FileExplorerRenderer::paint(painter, state, ctx);
 }
@@ -412,13 +417,16 @@ double FileExplorerWidget::measureFileNameWidth(const QString &fileName) {
   return fontMetrics.horizontalAdvance(fileName);
 }
 
+// Measures the widest node name. Only the names with the most characters are
+// measured, since with a proportional font the widest name is almost always
+// among them and measuring every node does not scale with tree size.
 double FileExplorerWidget::measureContentWidth() {
-  auto snapshot = fileExplorerController->getTreeSnapshot();
+  const auto names =
+      fileExplorerController->getLongestNodeNames(CONTENT_WIDTH_SAMPLE_SIZE);
   double finalWidth = 0;
 
-  for (auto &node : snapshot.nodes) {
-    QString lineText = QString::fromUtf8(node.name.c_str());
-    finalWidth = std::max(fontMetrics.horizontalAdvance(lineText), finalWidth);
+  for (const auto &name : names) {
+    finalWidth = std::max(fontMetrics.horizontalAdvance(name), finalWidth);
   }
 
   return finalWidth;
@@ -468,6 +476,7 @@ void FileExplorerWidget::resetFontSize() { setFontSize(DEFAULT_FONT_SIZE); }
 void FileExplorerWidget::setFontSize(double newFontSize) {
   font.setPointSizeF(newFontSize);
   fontMetrics = QFontMetricsF(font);
+  iconCache.clear();
 
   redraw();
   emit fontSizeChanged(newFontSize);
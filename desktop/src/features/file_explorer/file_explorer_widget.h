@@ -98,7 +98,7 @@ private:
 
   void performDrag(int row, const neko::FileNodeSnapshot &node);
 
-  FileExplorerRenderState getRenderState();
+  FileExplorerRenderState getRenderState(int firstRow, int rowCount);
   FileExplorerViewportContext getViewportContext();
 
   FileExplorerController *fileExplorerController;
@@ -111,6 +111,7 @@ private:
   FileExplorerTheme theme;
   QFont font;
   QFontMetricsF fontMetrics;
+  FileExplorerIconCache iconCache;
 
   QString hoveredNodePath;
   QString dragHoveredNodePath;
@@ -131,6 +132,7 @@ private:
   static constexpr double ICON_ADJUSTMENT = 6.0;
   static constexpr double EDGE_INSET = 12.0;
   static constexpr double ICON_SPACING = 4.0;
+  static constexpr int CONTENT_WIDTH_SAMPLE_SIZE = 32;
 
   static constexpr double GHOST_PADDING = 8.0;
   static constexpr double GHOST_BACKGROUND_ALPHA = 180.0;
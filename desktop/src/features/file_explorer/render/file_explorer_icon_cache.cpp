@@ -0,0 +1,37 @@
+#include "file_explorer_icon_cache.h"
+#include "utils/ui_utils.h"
+#include <QApplication>
+#include <QIcon>
+#include <QSize>
+#include <tuple>
+
+bool FileExplorerIconCache::Key::operator<(const Key &other) const {
+  return std::tie(icon, isHidden, color, size, devicePixelRatio) <
+         std::tie(other.icon, other.isHidden, other.color, other.size,
+                  other.devicePixelRatio);
+}
+
+void FileExplorerIconCache::clear() { pixmaps.clear(); }
+
+const QPixmap &FileExplorerIconCache::pixmapFor(const Key &key) {
+  auto it = pixmaps.find(key);
+
+  if (it == pixmaps.end()) {
+    it = pixmaps.emplace(key, renderPixmap(key)).first;
+  }
+
+  return it->second;
+}
+
+QPixmap FileExplorerIconCache::renderPixmap(const Key &key) {
+  const QSize size(key.size, key.size);
+  const QIcon icon = QApplication::style()->standardIcon(key.icon);
+  const QIcon colorizedIcon =
+      UiUtils::createColorizedIcon(icon, key.color, size);
+
+  // Hidden nodes use the style's dimmed rendition of the colorized icon.
+  return colorizedIcon.pixmap(size, key.devicePixelRatio,
+                              key.isHidden ? QIcon::Mode::Disabled
+                                           : QIcon::Mode::Normal,
+                              QIcon::State::Off);
+}
@@ -0,0 +1,37 @@
+#ifndef FILE_EXPLORER_ICON_CACHE_H
+#define FILE_EXPLORER_ICON_CACHE_H
+
+#include <QPixmap>
+#include <QString>
+#include <QStyle>
+#include <map>
+
+/// \class FileExplorerIconCache
+/// \brief Keeps the colorized node icons of the file explorer rasterized, so
+/// painting a row blits a pixmap instead of colorizing a style icon.
+///
+/// Only a handful of icon states exist, and every input to the pixmap is part
+/// of its key. Owners still call `clear` when the theme or font changes, so
+/// entries for sizes and colors that are no longer used do not pile up.
+class FileExplorerIconCache {
+public:
+  struct Key {
+    QStyle::StandardPixmap icon;
+    bool isHidden;
+    QString color;
+    int size;
+    qreal devicePixelRatio;
+
+    bool operator<(const Key &other) const;
+  };
+
+  void clear();
+  const QPixmap &pixmapFor(const Key &key);
+
+private:
+  [[nodiscard]] static QPixmap renderPixmap(const Key &key);
+
+  std::map<Key, QPixmap> pixmaps;
+};
+
+#endif // FILE_EXPLORER_ICON_CACHE_H
@@ -1,43 +1,31 @@
 #include "features/file_explorer/render/file_explorer_renderer.h"
 #include "features/file_explorer/render/types/types.h"
-#include "utils/ui_utils.h"
-#include <QApplication>
-#include <QIcon>
 #include <QPainter>
 #include <QStyle>
 
 IconInfo FileExplorerRenderer::getIconInfo(FileExplorerRenderState &state,
                                            FileExplorerViewportContext &ctx,
                                            const neko::FileNodeSnapshot &node) {
-  // Get the appropriate icon.
-  QIcon icon;
+  const int iconSize = static_cast<int>(
+      ctx.lineHeight - FileExplorerRenderConstants::iconAdjustment);
 
+  QStyle::StandardPixmap icon = QStyle::SP_FileIcon;
   if (node.is_dir) {
-    icon = QApplication::style()->standardIcon(
-        node.is_expanded ? QStyle::SP_DirOpenIcon : QStyle::SP_DirIcon);
-  } else {
-    icon = QApplication::style()->standardIcon(QStyle::SP_FileIcon);
-  }
-
-  int iconSize = static_cast<int>(ctx.lineHeight -
-                                  FileExplorerRenderConstants::iconAdjustment);
-  QIcon colorizedIcon = UiUtils::createColorizedIcon(
-      icon, state.theme.selectionColor, QSize(iconSize, iconSize));
-  QIcon normalIcon = UiUtils::createColorizedIcon(
-      icon, state.theme.fileForegroundColor, QSize(iconSize, iconSize));
-
-  QPixmap pixmap = colorizedIcon.pixmap(iconSize, iconSize);
-
-  if (node.is_hidden) {
-    pixmap = colorizedIcon.pixmap(iconSize, iconSize, QIcon::Mode::Disabled,
-                                  QIcon::State::Off);
+    icon = node.is_expanded ? QStyle::SP_DirOpenIcon : QStyle::SP_DirIcon;
   }
 
-  if (!node.is_dir) {
-    pixmap = normalIcon.pixmap(iconSize, iconSize);
-  }
-
-  return {.pixmap = pixmap, .size = iconSize};
+  // Directories take the accent color and are dimmed when hidden; files are
+  // always drawn in the plain foreground color.
+  const FileExplorerIconCache::Key key{
+      .icon = icon,
+      .isHidden = node.is_dir && node.is_hidden,
+      .color = node.is_dir ? state.theme.selectionColor
+                           : state.theme.fileForegroundColor,
+      .size = iconSize,
+      .devicePixelRatio = ctx.devicePixelRatio,
+  };
+
+  return {.pixmap = state.iconCache.pixmapFor(key), .size = iconSize};
 }
 
 void FileExplorerRenderer::paint(QPainter &painter,
@@ -64,10 +52,22 @@ void FileExplorerRenderer::drawFile(QPainter &painter,
       -ctx.horizontalOffset + FileExplorerRenderConstants::iconEdgePadding;
   double yPosition = (index * ctx.lineHeight) - ctx.verticalOffset;
 
-  auto node = state.snapshot.nodes.at(index);
+  auto node = state.nodes.at(index - state.firstNodeIndex);
   double indent =
       static_cast<int>(node.depth) * FileExplorerRenderConstants::nodeIndent;
 
+  // The "Loading…" row of a directory still being listed is just muted text,
+  // starting where a child's icon would.
+  if (node.is_placeholder) {
+    QString placeholderColor = state.theme.fileHiddenColor;
+
+    painter.setPen(placeholderColor);
+    painter.drawText(
+        QPointF(xPosition + indent + 2, yPosition + state.fontAscent),
+        QString::fromUtf8(node.name));
+    return;
+  }
+
   // Set up colors.
   auto accentColor = state.theme.selectionColor;
   auto selectionColor = QColor(accentColor);
@@ -150,7 +150,7 @@ void FileExplorerRenderer::drawDragGhost(QPainter &painter,
                                          int index) {
   painter.setFont(state.font);
 
-  const auto node = state.snapshot.nodes.at(index);
+  const auto node = state.nodes.at(index - state.firstNodeIndex);
   double nodeFileNameWidth =
       state.measureFileNameWidth(QString::fromUtf8(node.name));
 
@@ -1,6 +1,7 @@
 #ifndef FILE_EXPLORER_RENDERER_TYPES_H
 #define FILE_EXPLORER_RENDERER_TYPES_H
 
+#include "features/file_explorer/render/file_explorer_icon_cache.h"
 #include "theme/types/types.h"
 #include <QFont>
 #include <QPixmap>
@@ -23,13 +24,17 @@ struct FileExplorerViewportContext {
   double horizontalOffset;
   double width;
   double height;
+  double devicePixelRatio;
 };
 
+/// Holds the visible rows being painted, starting at row `firstNodeIndex`.
 struct FileExplorerRenderState {
-  neko::FileTreeSnapshot snapshot;
+  rust::Vec<neko::FileNodeSnapshot> nodes;
+  const int firstNodeIndex;
   const QFont font;
   const double fontAscent;
   FileExplorerTheme theme;
+  FileExplorerIconCache &iconCache;
   const bool hasFocus;
   QString hoveredNodePath;
   QString dragHoveredNodePath;
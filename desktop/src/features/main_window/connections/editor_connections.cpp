@@ -41,10 +41,12 @@ EditorConnections::EditorConnections(const EditorConnectionsProps &props,
           &EditorWidget::onSelectionChanged);
   connect(editorBridge, &EditorBridge::viewportChanged, uiHandles.editorWidget,
           &EditorWidget::onViewportChanged);
+  connect(editorBridge, &EditorBridge::rowsChanged, uiHandles.editorWidget,
+          &EditorWidget::onRowsChanged);
 
   // EditorBridge -> GutterWidget
-  connect(editorBridge, &EditorBridge::lineCountChanged, uiHandles.gutterWidget,
-          &GutterWidget::onEditorLineCountChanged);
+  // Line count changes always come with `viewportChanged` in the same flush,
+  // which already updates the gutter's dimensions.
   connect(editorBridge, &EditorBridge::bufferChanged, uiHandles.gutterWidget,
           &GutterWidget::onBufferChanged);
   connect(editorBridge, &EditorBridge::cursorChanged, uiHandles.gutterWidget,
@@ -43,19 +43,17 @@ void ShortcutsManager::populateShortcutMetadata() {
       {
           "Tab::Close",
           [this]() {
-            const auto snapshot = tabBridge->getTabsSnapshot();
             workspaceCoordinator->closeTabs(
                 neko::CloseTabOperationTypeFfi::Single,
-                static_cast<int>(snapshot.active_id), false);
+                tabBridge->getActiveTabId(), false);
           },
       },
       {
           "Tab::ForceClose",
           [this]() {
-            const auto snapshot = tabBridge->getTabsSnapshot();
             workspaceCoordinator->closeTabs(
                 neko::CloseTabOperationTypeFfi::Single,
-                static_cast<int>(snapshot.active_id), true);
+                tabBridge->getActiveTabId(), true);
           },
       },
       {
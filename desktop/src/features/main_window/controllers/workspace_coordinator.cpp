@@ -38,6 +38,8 @@ WorkspaceCoordinator::WorkspaceCoordinator(
   // TabBridge -> WorkspaceCoordinator
   connect(tabBridge, &TabBridge::activeTabChanged, this,
           [this] { refreshUiForActiveTab(false); });
+  connect(tabBridge, &TabBridge::activeTabChanged, appBridge,
+          &AppBridge::activeDocumentChanged);
   connect(tabBridge, &TabBridge::allTabsClosed, this,
           [this] { refreshUiForActiveTab(false); });
   connect(tabBridge, &TabBridge::restoreScrollOffsetsForReopenedTab, this,
@@ -57,6 +59,8 @@ WorkspaceCoordinator::WorkspaceCoordinator(
           });
   connect(tabBridge, &TabBridge::tabUpdated, uiHandles.tabBarWidget,
           &TabBarWidget::updateTab);
+  connect(tabBridge, &TabBridge::tabModifiedChanged, uiHandles.tabBarWidget,
+          &TabBarWidget::setTabModified);
   connect(tabBridge, &TabBridge::activeTabChanged, uiHandles.tabBarWidget,
           &TabBarWidget::setCurrentTabId);
 
@@ -79,6 +83,31 @@ WorkspaceCoordinator::WorkspaceCoordinator(
       uiHandles.fileExplorerWidget, &FileExplorerWidget::requestFocusEditor,
       [this](bool shouldFocus) { shouldFocusEditorOnFileOpen = shouldFocus; });
 
+  // AppBridge -> WorkspaceCoordinator (background file loads / saves)
+  connect(appBridge, &AppBridge::documentLoadUpdated, this,
+          &WorkspaceCoordinator::documentLoadUpdated);
+  connect(appBridge, &AppBridge::documentSaveFinished, this,
+          [this](uint64_t documentId, bool succeeded) {
+            tabFlows.documentSaveFinished(documentId, succeeded);
+          });
+  connect(appBridge, &AppBridge::documentChangedOnDisk, this,
+          [this](uint64_t documentId) {
+            tabBridge->documentUpdated(documentId);
+          });
+  connect(appBridge, &AppBridge::memoryUsageChanged, uiHandles.statusBarWidget,
+          &StatusBarWidget::setMemoryUsage);
+
+  // Session saving. The active tab's scroll offsets are only stored in the
+  // core when switching away from it, so they are stored before each save.
+  connect(appBridge, &AppBridge::sessionSaveDue, this, [this] {
+    tabFlows.saveScrollOffsetsForActiveTab();
+    appBridge->saveSessionInBackground();
+  });
+  connect(qApp, &QCoreApplication::aboutToQuit, this, [this] {
+    tabFlows.saveScrollOffsetsForActiveTab();
+    appBridge->saveSession();
+  });
+
   auto editorController = appBridge->getEditorController();
   setEditorController(std::move(editorController));
 }
@@ -96,8 +125,7 @@ void WorkspaceCoordinator::fileExplorerToggled() {
 }
 
 void WorkspaceCoordinator::cursorPositionClicked() {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  if (!snapshot.active_present) {
+  if (!tabBridge->hasActiveTab()) {
     return;
   }
 
@@ -156,8 +184,7 @@ void WorkspaceCoordinator::commandPaletteGoToPosition(
     // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
     const QString &jumpCommandKey, int64_t row, int64_t column,
     bool isPosition) {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  if (!snapshot.active_present) {
+  if (!tabBridge->hasActiveTab()) {
     return;
   }
 
@@ -260,21 +287,15 @@ void WorkspaceCoordinator::commandPaletteCommand(const QString &key,
 }
 
 QString WorkspaceCoordinator::getInitialDialogDirectory() const {
-  const auto snapshot = tabBridge->getTabsSnapshot();
+  const auto snapshotMaybe =
+      tabBridge->getTabSnapshot(tabBridge->getActiveTabId());
 
-  if (!snapshot.active_present) {
-    return QDir::homePath();
-  }
-
-  // Find the active tab
-  for (const auto &tab : snapshot.tabs) {
-    if (tab.id == snapshot.active_id && tab.path_present) {
-      const QString path = QString::fromUtf8(tab.path.data());
-      QFileInfo fileInfo(path);
+  if (snapshotMaybe.found && snapshotMaybe.snapshot.path_present) {
+    const QString path = QString::fromUtf8(snapshotMaybe.snapshot.path.data());
+    QFileInfo fileInfo(path);
 
-      return fileInfo.isDir() ? fileInfo.absoluteFilePath()
-                              : fileInfo.absolutePath();
-    }
+    return fileInfo.isDir() ? fileInfo.absoluteFilePath()
+                            : fileInfo.absolutePath();
   }
 
   return QDir::homePath();
@@ -287,12 +308,44 @@ void WorkspaceCoordinator::performFileOpen(const QString &path) {
   }
 
   // Save scroll offsets for the current tab
-  if (const auto snapshot = tabBridge->getTabsSnapshot();
-      snapshot.active_present) {
+  if (tabBridge->hasActiveTab()) {
+    tabFlows.saveScrollOffsetsForActiveTab();
+  }
+
+  openFileAndActivate(path);
+}
+
+void WorkspaceCoordinator::performFilesOpen(const QStringList &paths) {
+  if (paths.isEmpty()) {
+    return;
+  }
+
+  if (tabBridge->hasActiveTab()) {
     tabFlows.saveScrollOffsetsForActiveTab();
   }
 
-  const auto openResult = appBridge->openFile(path, true);
+  // Only the last file ends up on screen, so it is the only one read right
+  // away. The others get tabs whose files are read once they are activated or
+  // prefetched, which keeps opening many files at once fast.
+  for (qsizetype i = 0; i + 1 < paths.size(); ++i) {
+    const auto openResult = appBridge->openFileDeferred(paths[i], true);
+
+    if (openResult.found_tab_id && !openResult.tab_already_exists) {
+      tabBridge->notifyTabOpenedInBackground(
+          static_cast<int>(openResult.tab_id));
+    }
+  }
+
+  openFileAndActivate(paths.last());
+  // Announces the active tab even if the last file failed to open.
+  tabBridge->pollTabEvents();
+}
+
+void WorkspaceCoordinator::openFileAndActivate(const QString &path) {
+  // The tab is created right away; the content is read on a worker thread
+  // and picked up by `documentLoadUpdated`.
+  const auto openResult = appBridge->openFileInBackground(path, true);
+
   if (openResult.found_tab_id) {
     const int newTabId = static_cast<int>(openResult.tab_id);
     if (openResult.tab_already_exists) {
@@ -310,16 +363,35 @@ void WorkspaceCoordinator::performFileOpen(const QString &path) {
   }
 }
 
+void WorkspaceCoordinator::documentLoadUpdated(
+    const neko::DocumentLoadEventFfi &event) {
+  if (event.status == neko::DocumentLoadStatusFfi::Loading) {
+    return;
+  }
+
+  // Finished and failed loads clear the tab's loading marker.
+  tabBridge->documentUpdated(event.document_id);
+
+  // If the active editor is showing this document, re-measure and repaint
+  // with the new content. The first screenful arrives as a preview.
+  const auto snapshotMaybe =
+      tabBridge->getDocumentTabSnapshot(event.document_id);
+  if (snapshotMaybe.found &&
+      static_cast<int>(snapshotMaybe.snapshot.id) ==
+          tabBridge->getActiveTabId()) {
+    uiHandles.editorWidget->updateDimensions();
+    uiHandles.gutterWidget->updateDimensions();
+    uiHandles.gutterWidget->redraw();
+    refreshStatusBarCursorInfo();
+  }
+}
+
 void WorkspaceCoordinator::openFile() {
   const QString initialDir = getInitialDialogDirectory();
-  const QString filePath =
+  const QStringList filePaths =
       DialogService::openFileSelectionDialog(initialDir, uiHandles.window);
 
-  if (filePath.isEmpty()) {
-    return;
-  }
-
-  performFileOpen(filePath);
+  performFilesOpen(filePaths);
 }
 
 void WorkspaceCoordinator::fileSelected(const QString &path, bool focusEditor) {
@@ -368,22 +440,19 @@ SaveResult WorkspaceCoordinator::saveTab(int tabId, bool isSaveAs) {
 
 // TODO(scarlet): Merge this with the other tab command handling?
 void WorkspaceCoordinator::revealActiveTab() {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  if (!snapshot.active_present) {
+  const auto snapshotMaybe =
+      tabBridge->getTabSnapshot(tabBridge->getActiveTabId());
+  if (!snapshotMaybe.found) {
     return;
   }
 
+  const auto &tab = snapshotMaybe.snapshot;
   neko::TabContextFfi ctx;
-  for (const auto &tab : snapshot.tabs) {
-    if (tab.id == snapshot.active_id) {
-      ctx.id = tab.id;
-      ctx.is_pinned = tab.pinned;
-      ctx.is_modified = tab.modified;
-      ctx.file_path_present = tab.path_present;
-      ctx.file_path = tab.path;
-      break;
-    }
-  }
+  ctx.id = tab.id;
+  ctx.is_pinned = tab.pinned;
+  ctx.is_modified = tab.modified;
+  ctx.file_path_present = tab.path_present;
+  ctx.file_path = tab.path;
 
   handleCommand("tab.reveal", ctx, false);
 }
@@ -405,14 +474,7 @@ void WorkspaceCoordinator::applyInitialState() {
 
   int index = 0;
   for (const auto &tab : snapshot.tabs) {
-    TabPresentation presentation;
-    presentation.id = static_cast<int>(tab.id);
-    presentation.title = QString::fromUtf8(tab.title);
-    presentation.path = QString::fromUtf8(tab.path);
-    presentation.pinned = tab.pinned;
-    presentation.modified = tab.modified;
-
-    uiHandles.tabBarWidget->addTab(presentation, index++);
+    uiHandles.tabBarWidget->addTab(TabBridge::fromSnapshot(tab), index++);
   }
 
   if (snapshot.active_present) {
@@ -420,6 +482,10 @@ void WorkspaceCoordinator::applyInitialState() {
         static_cast<int>(snapshot.active_id));
   }
 
+  // Tabs restored from the last session open in their saved viewport.
+  uiHandles.editorWidget->updateDimensions();
+  uiHandles.gutterWidget->updateDimensions();
+  tabFlows.restoreScrollOffsetsForActiveTab();
   refreshStatusBarCursorInfo();
 
   auto cfg = appConfigService->getSnapshot();
@@ -431,9 +497,7 @@ void WorkspaceCoordinator::applyInitialState() {
 }
 
 void WorkspaceCoordinator::refreshUiForActiveTab(bool focusEditor) {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-
-  if (!snapshot.active_present) {
+  if (!tabBridge->hasActiveTab()) {
     uiHandles.tabBarContainerWidget->hide();
     uiHandles.editorWidget->hide();
     uiHandles.gutterWidget->hide();
@@ -481,8 +545,7 @@ void WorkspaceCoordinator::refreshStatusBarCursorInfo() {
   }
 
   const auto cursorPosition = editorBridge->getLastAddedCursor();
-  const int numberOfCursors =
-      static_cast<int>(editorBridge->getCursorPositions().size());
+  const int numberOfCursors = editorBridge->getCursorCount();
 
   uiHandles.statusBarWidget->updateCursorPosition(
       cursorPosition.row, cursorPosition.column, numberOfCursors);
@@ -10,6 +10,7 @@
 #include "features/main_window/ui_handles.h"
 #include <QList>
 #include <QObject>
+#include <QStringList>
 #include <neko-core/src/ffi/bridge.rs.h>
 #include <optional>
 #include <string>
@@ -143,6 +144,9 @@ private:
   void setEditorController(rust::Box<neko::EditorController> editorController);
   void refreshStatusBarCursorInfo();
   void performFileOpen(const QString &path);
+  void performFilesOpen(const QStringList &paths);
+  void openFileAndActivate(const QString &path);
+  void documentLoadUpdated(const neko::DocumentLoadEventFfi &event);
   [[nodiscard]] QString getInitialDialogDirectory() const;
 
   // Indicates whether we should switch focus to the editor when opening a file.
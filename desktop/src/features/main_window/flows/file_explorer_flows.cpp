@@ -65,19 +65,13 @@ FileExplorerFlows::handleFileExplorerCommand(
     return result;
   }
 
-  bool itemIsExpanded = false;
-  const auto snapshot = fileTreeBridge->getTreeSnapshot();
-  for (const auto &node : snapshot.nodes) {
-    if ((node.path == itemPath && node.is_dir) ||
-        (node.path == parentItemPath && node.is_dir)) {
-      // Check if the node is expanded (if it is a directory). If not a
-      // directory, check if its parent is expanded.
-      itemIsExpanded = node.is_expanded;
-    }
-  }
-
   QFileInfo itemFileInfo(itemPath);
   bool itemIsDirectory = itemFileInfo.isDir();
+
+  // Check if the item is expanded (if it is a directory). If not a directory,
+  // check if its parent is expanded.
+  bool itemIsExpanded =
+      fileTreeBridge->isExpanded(itemIsDirectory ? itemPath : parentItemPath);
   PreCommandProcessingArgs preArgs{.currentResult = result,
                                    .commandId = commandId,
                                    .itemPath = itemPath,
@@ -104,6 +98,9 @@ FileExplorerFlows::handleFileExplorerCommand(
     result.intents.push_back(intent);
   }
 
+  // Expanding a directory lists it in the background.
+  fileTreeBridge->startListingPolling();
+
   PostCommandProcessingArgs postArgs{
       .commandId = commandId,
       .itemPath = itemPath,
@@ -188,8 +185,7 @@ void FileExplorerFlows::doPostCommandProcessing(
     // Prevent expanding the root's parent (which is not part of the tree -- and
     // the root would be deleted anyway if the deletion target was the root
     // directory).
-    const auto snapshot = fileTreeBridge->getTreeSnapshot();
-    const QString workspaceRootPath = QString::fromUtf8(snapshot.root);
+    const QString workspaceRootPath = fileTreeBridge->getRootPath();
 
     if (args.itemPath != workspaceRootPath) {
       fileTreeBridge->setExpanded(args.parentItemPath);
@@ -268,8 +264,7 @@ void FileExplorerFlows::handleCopyPath(const QString &itemPath) {
 }
 
 void FileExplorerFlows::handleCopyRelativePath(const QString &itemPath) {
-  const auto snapshot = fileTreeBridge->getTreeSnapshot();
-  const QString workspaceRootPath = QString::fromUtf8(snapshot.root);
+  const QString workspaceRootPath = fileTreeBridge->getRootPath();
   QDir rootDir(workspaceRootPath);
 
   const QString relativePath = rootDir.relativeFilePath(itemPath);
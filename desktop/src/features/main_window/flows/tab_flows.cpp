@@ -91,8 +91,7 @@ bool TabFlows::handleTabCommand(const std::string &commandId,
 
 bool TabFlows::closeTabs(neko::CloseTabOperationTypeFfi operationType,
                          int anchorTabId, bool forceClose) {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  if (!snapshot.active_present) {
+  if (!tabBridge->hasActiveTab()) {
     // Close the window if there are no tabs.
     QApplication::quit();
     return false;
@@ -112,19 +111,27 @@ bool TabFlows::closeTabs(neko::CloseTabOperationTypeFfi operationType,
 }
 
 void TabFlows::fileSaved(bool saveAs) {
-  const auto snapshot = tabBridge->getTabsSnapshot();
+  const int activeId = tabBridge->getActiveTabId();
 
-  if (!snapshot.active_present) {
+  if (activeId == 0) {
     return;
   }
 
-  const int activeId = static_cast<int>(snapshot.active_id);
-  const bool success = saveTabWithPromptIfNeeded(activeId, saveAs);
+  // The write happens on a worker thread; the tab is updated from
+  // `documentSaveFinished` once it completes.
+  if (!saveTabWithPromptIfNeeded(activeId, saveAs, true)) {
+    qInfo() << "Save failed to start";
+  }
+}
 
-  if (success) {
-    uiHandles.tabBarWidget->setTabModified(activeId, false);
-    tabBridge->tabSaved(activeId);
+void TabFlows::documentSaveFinished(uint64_t documentId, bool succeeded) {
+  if (!succeeded) {
+    qWarning() << "Save failed";
+    return;
   }
+
+  // The core keeps the tab modified if it was edited while the save ran.
+  tabBridge->documentUpdated(documentId);
 }
 
 bool TabFlows::tabTogglePin(int tabId, bool isPinned) {
@@ -139,16 +146,12 @@ bool TabFlows::tabTogglePin(int tabId, bool isPinned) {
 }
 
 bool TabFlows::copyTabPath(int tabId) {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  QString path;
-
-  for (const auto &tab : snapshot.tabs) {
-    if (tab.id == tabId) {
-      path = QString::fromUtf8(tab.path);
-      break;
-    }
+  const auto snapshotMaybe = tabBridge->getTabSnapshot(tabId);
+  if (!snapshotMaybe.found) {
+    return false;
   }
 
+  const QString path = QString::fromUtf8(snapshotMaybe.snapshot.path);
   if (path.isEmpty()) {
     return false;
   }
@@ -184,25 +187,13 @@ void TabFlows::moveTabBy(int delta, bool useHistory) {
 }
 
 void TabFlows::bufferChanged() {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  const int activeId = static_cast<int>(snapshot.active_id);
-
-  bool modified = false;
-  for (const auto &tab : snapshot.tabs) {
-    if (tab.id == activeId) {
-      modified = tab.modified;
-      break;
-    }
-  }
-
-  uiHandles.tabBarWidget->setTabModified(activeId, modified);
+  // Runs on every edit. The core only reports the tabs whose modified state
+  // actually flipped, so this stays cheap however many tabs are open.
+  tabBridge->pollTabEvents();
 }
 
 void TabFlows::handleTabsClosed() {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  const int newTabCount = static_cast<int>(snapshot.tabs.size());
-
-  uiHandles.statusBarWidget->onTabClosed(newTabCount);
+  uiHandles.statusBarWidget->onTabClosed(tabBridge->getTabCount());
 }
 
 // TODO(scarlet): Move this to TabBridge?
@@ -227,7 +218,7 @@ int TabFlows::getModifiedTabCount(const QList<int> &ids) {
 }
 
 SaveResult TabFlows::saveTab(int tabId, bool isSaveAs) {
-  if (saveTabWithPromptIfNeeded(tabId, isSaveAs)) {
+  if (saveTabWithPromptIfNeeded(tabId, isSaveAs, false)) {
     uiHandles.tabBarWidget->setTabModified(tabId, false);
     return SaveResult::Saved;
   }
@@ -236,29 +227,23 @@ SaveResult TabFlows::saveTab(int tabId, bool isSaveAs) {
   return SaveResult::Failed;
 }
 
-bool TabFlows::saveTabWithPromptIfNeeded(int tabId, bool isSaveAs) {
-  const auto snapshot = tabBridge->getTabsSnapshot();
-  QString fileName;
-  QString path;
-  uint64_t documentId;
-  bool foundTabId;
-
-  for (const auto &tab : snapshot.tabs) {
-    if (tab.id == tabId) {
-      path = QString::fromUtf8(tab.path);
-      fileName = QString::fromUtf8(tab.title);
-      documentId = tab.document_id;
-      foundTabId = true;
-      break;
-    }
-  }
-
-  if (!foundTabId) {
+bool TabFlows::saveTabWithPromptIfNeeded(int tabId, bool isSaveAs,
+                                         bool inBackground) {
+  const auto snapshotMaybe = tabBridge->getTabSnapshot(tabId);
+  if (!snapshotMaybe.found) {
     return false;
   }
 
-  if (!path.isEmpty() && !isSaveAs) {
-    return appBridge->saveDocument(documentId);
+  const auto &tab = snapshotMaybe.snapshot;
+  const QString path = QString::fromUtf8(tab.path);
+  const QString fileName = QString::fromUtf8(tab.title);
+  const uint64_t documentId = tab.document_id;
+
+  // A file that was not valid UTF-8 would lose its original bytes if saved in
+  // place, so it is only ever saved under a name picked in the dialog.
+  if (!path.isEmpty() && !isSaveAs && !tab.lossy) {
+    return inBackground ? appBridge->saveDocumentInBackground(documentId)
+                        : appBridge->saveDocument(documentId);
   }
 
   QString initialDir;
@@ -273,7 +258,10 @@ bool TabFlows::saveTabWithPromptIfNeeded(int tabId, bool isSaveAs) {
     return false;
   }
 
-  return appBridge->saveDocumentAs(documentId, filePath.toStdString());
+  const std::string newPath = filePath.toStdString();
+  return inBackground
+             ? appBridge->saveDocumentAsInBackground(documentId, newPath)
+             : appBridge->saveDocumentAs(documentId, newPath);
 }
 
 bool TabFlows::closeManyTabs(const QList<int> &ids, bool forceClose,
@@ -317,7 +305,7 @@ bool TabFlows::closeManyTabs(const QList<int> &ids, bool forceClose,
       for (int tabId : modifiedIds) {
         tabChanged(modifiedIds.first());
 
-        if (!saveTabWithPromptIfNeeded(tabId, false)) {
+        if (!saveTabWithPromptIfNeeded(tabId, false, false)) {
           return false;
         }
       }
@@ -335,13 +323,12 @@ bool TabFlows::closeManyTabs(const QList<int> &ids, bool forceClose,
 }
 
 void TabFlows::saveScrollOffsetsForActiveTab() {
-  const auto snapshot = tabBridge->getTabsSnapshot();
+  const int activeId = tabBridge->getActiveTabId();
 
-  if (!snapshot.active_present) {
+  if (activeId == 0) {
     return;
   }
 
-  const int activeId = static_cast<int>(snapshot.active_id);
   const double horizontalScrollOffset =
       uiHandles.editorWidget->horizontalScrollBar()->value();
   const double verticalScrollOffset =
@@ -355,14 +342,12 @@ void TabFlows::saveScrollOffsetsForActiveTab() {
 }
 
 void TabFlows::restoreScrollOffsetsForActiveTab() {
-  const auto snapshot = tabBridge->getTabsSnapshot();
+  const auto snapshotMaybe =
+      tabBridge->getTabSnapshot(tabBridge->getActiveTabId());
 
   neko::ScrollOffsetFfi offsets;
-  for (const auto &tab : snapshot.tabs) {
-    if (tab.id == snapshot.active_id) {
-      offsets = tab.scroll_offsets;
-      break;
-    }
+  if (snapshotMaybe.found) {
+    offsets = snapshotMaybe.snapshot.scroll_offsets;
   }
 
   uiHandles.editorWidget->horizontalScrollBar()->setValue(offsets.x);
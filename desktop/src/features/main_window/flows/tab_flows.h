@@ -46,6 +46,7 @@ public:
   bool revealTab(const neko::TabContextFfi &ctx);
   bool tabTogglePin(int tabId, bool isPinned);
   void fileSaved(bool saveAs);
+  void documentSaveFinished(uint64_t documentId, bool succeeded);
 
   // Editor / buffer changes
   void bufferChanged();
@@ -72,7 +73,8 @@ private:
   bool closeManyTabs(const QList<int> &ids, bool forceClose,
                      const std::function<void()> &closeAction);
 
-  [[nodiscard]] bool saveTabWithPromptIfNeeded(int tabId, bool isSaveAs);
+  [[nodiscard]] bool saveTabWithPromptIfNeeded(int tabId, bool isSaveAs,
+                                               bool inBackground);
 };
 
 #endif // TAB_FLOWS_H
@@ -60,6 +60,8 @@ MainWindow::MainWindow(QWidget *parent)
 
   auto *appBridge =
       new AppBridge({.configManager = *configManager, .rootPath = ""});
+  // Before anything asks for the active editor, so it is the restored one.
+  appBridge->restoreSession();
 
   rust::Box<neko::EditorController> editorController =
       appBridge->getEditorController();
@@ -17,7 +17,7 @@ QString DialogService::openDirectorySelectionDialog(QWidget *parent) {
       QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
 }
 
-QString DialogService::openFileSelectionDialog(
+QStringList DialogService::openFileSelectionDialog(
     const std::optional<QString> &initialDirectory, QWidget *parent) {
   QString baseDir;
 
@@ -28,7 +28,7 @@ QString DialogService::openFileSelectionDialog(
     baseDir = QDir::homePath();
   }
 
-  return QFileDialog::getOpenFileName(parent, tr("Open a file"), baseDir);
+  return QFileDialog::getOpenFileNames(parent, tr("Open files"), baseDir);
 }
 
 DialogService::DeleteDecision DialogService::openDeleteConfirmationDialog(
@@ -6,6 +6,7 @@
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <cstdint>
 #include <optional>
 
@@ -36,7 +37,7 @@ public:
   ~DialogService() override = default;
 
   [[nodiscard]] static QString openDirectorySelectionDialog(QWidget *parent);
-  [[nodiscard]] static QString
+  [[nodiscard]] static QStringList
   openFileSelectionDialog(const std::optional<QString> &initialDirectory,
                           QWidget *parent);
   static CloseDecision openCloseConfirmationDialog(const QList<int> &ids,
@@ -6,6 +6,8 @@
 #include <QFontMetrics>
 #include <QHBoxLayout>
 #include <QIcon>
+#include <QLabel>
+#include <QLocale>
 #include <QPaintEvent>
 #include <QPainter>
 #include <QPointF>
@@ -40,6 +42,9 @@ StatusBarWidget::StatusBarWidget(const StatusBarProps &props, QWidget *parent)
   connect(cursorPosition, &QPushButton::clicked, this,
           &StatusBarWidget::onCursorPositionClicked);
 
+  memoryUsage = new QLabel(this);
+  memoryUsage->hide();
+
   auto *layout = new QHBoxLayout(this);
 
   layout->setContentsMargins(HORIZONTAL_CONTENT_MARGIN, VERTICAL_CONTENT_MARGIN,
@@ -48,6 +53,7 @@ StatusBarWidget::StatusBarWidget(const StatusBarProps &props, QWidget *parent)
   layout->addWidget(fileExplorerToggleButton);
   layout->addWidget(cursorPosition);
   layout->addStretch();
+  layout->addWidget(memoryUsage);
 
   setAndApplyTheme(theme);
 }
@@ -97,6 +103,9 @@ void StatusBarWidget::setAndApplyTheme(const StatusBarTheme &newTheme) {
               "QPushButton:pressed { background-color: %3; }")
           .arg(btnText, btnHover, btnPress));
 
+  memoryUsage->setStyleSheet(
+      QString("QLabel { color: %1; }").arg(theme.foregroundMutedColor));
+
   update();
 }
 
@@ -150,6 +159,20 @@ void StatusBarWidget::onFileExplorerToggledExternally(bool isOpen) {
   fileExplorerToggleButton->setChecked(isOpen);
 }
 
+void StatusBarWidget::setMemoryUsage(uint64_t usedBytes, uint64_t budgetBytes) {
+  // Usage is only measured while a budget is configured.
+  memoryUsage->setVisible(budgetBytes > 0);
+  if (budgetBytes == 0) {
+    return;
+  }
+
+  const QLocale locale;
+  memoryUsage->setText(QString("%1 / %2").arg(
+      locale.formattedDataSize(static_cast<qint64>(usedBytes)),
+      locale.formattedDataSize(static_cast<qint64>(budgetBytes))));
+  memoryUsage->setToolTip(tr("Memory used by open files"));
+}
+
 void StatusBarWidget::paintEvent(QPaintEvent *event) {
   QPainter painter(this);
 
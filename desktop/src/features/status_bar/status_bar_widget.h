@@ -7,8 +7,9 @@ class ConfigManager;
 #include "theme/types/types.h"
 #include "types/qt_types_fwd.h"
 #include <QWidget>
+#include <cstdint>
 
-QT_FWD(QPaintEvent, QPushButton);
+QT_FWD(QLabel, QPaintEvent, QPushButton);
 
 class StatusBarWidget : public QWidget {
   Q_OBJECT
@@ -37,6 +38,9 @@ public slots:
   void onCursorPositionChanged(int row, int col, int numberOfCursors);
   void onTabClosed(int numberOfTabs);
   void onFileExplorerToggledExternally(bool isOpen);
+  /// Shows how much memory open files take up, against the budget unless
+  /// `budgetBytes` is 0.
+  void setMemoryUsage(uint64_t usedBytes, uint64_t budgetBytes);
 
 protected:
   void paintEvent(QPaintEvent *event) override;
@@ -49,6 +53,7 @@ private:
   double m_height;
   QPushButton *fileExplorerToggleButton;
   QPushButton *cursorPosition;
+  QLabel *memoryUsage;
   QFont font;
 
   StatusBarTheme theme;
@@ -2,7 +2,12 @@
 #include "neko-core/src/ffi/bridge.rs.h"
 
 TabBridge::TabBridge(TabBridgeProps props)
-    : tabController(std::move(props.tabController)) {}
+    : tabController(std::move(props.tabController)) {
+  // The initial tabs are read from a full snapshot, so only changes made from
+  // here on need to be reported.
+  tabController->take_tab_events();
+  activeTabId = getActiveTabId();
+}
 
 TabPresentation TabBridge::fromSnapshot(const neko::TabSnapshot &tab) {
   return TabPresentation{
@@ -11,6 +16,9 @@ TabPresentation TabBridge::fromSnapshot(const neko::TabSnapshot &tab) {
       .path = QString::fromUtf8(tab.path),
       .pinned = tab.pinned,
       .modified = tab.modified,
+      .loading = tab.loading,
+      .changedOnDisk = tab.changed_on_disk,
+      .lossy = tab.lossy,
       .scrollOffsets =
           TabScrollOffsets{.x = static_cast<double>(tab.scroll_offsets.x),
                            .y = static_cast<double>(tab.scroll_offsets.y)},
@@ -25,6 +33,20 @@ neko::TabSnapshotMaybe TabBridge::getTabSnapshot(int tabId) {
   return tabController->get_tab_snapshot(tabId);
 }
 
+neko::TabSnapshotMaybe TabBridge::getDocumentTabSnapshot(uint64_t documentId) {
+  return tabController->get_document_tab_snapshot(documentId);
+}
+
+int TabBridge::getActiveTabId() const {
+  return static_cast<int>(tabController->get_active_tab_id());
+}
+
+bool TabBridge::hasActiveTab() const { return getActiveTabId() != 0; }
+
+int TabBridge::getTabCount() const {
+  return static_cast<int>(tabController->get_tab_count());
+}
+
 QList<int>
 TabBridge::getCloseTabIds(neko::CloseTabOperationTypeFfi operationType,
                           int anchorTabId, bool closePinned) const {
@@ -40,27 +62,15 @@ int TabBridge::createDocumentTabAndView(const std::string &title,
       title, addTabToHistory, activateView);
 
   const int newTabId = static_cast<int>(result.tab_id);
-  auto tabsSnapshot = tabController->get_tabs_snapshot();
-
-  int newTabIndex = -1;
-  std::optional<TabPresentation> presentation;
+  const auto snapshotMaybe = tabController->get_tab_snapshot(newTabId);
 
-  for (int i = 0; i < tabsSnapshot.tabs.size(); ++i) {
-    const auto &tabSnapshot = tabsSnapshot.tabs[i];
-
-    if (static_cast<int>(tabSnapshot.id) == newTabId) {
-      newTabIndex = i;
-      presentation = fromSnapshot(tabSnapshot);
-      break;
-    }
-  }
-
-  if (newTabIndex < 0 || !presentation.has_value()) {
+  if (!snapshotMaybe.found) {
     return -1;
   }
 
-  emit tabOpened(presentation.value(), newTabIndex);
-  emit activeTabChanged(newTabId);
+  emit tabOpened(fromSnapshot(snapshotMaybe.snapshot),
+                 static_cast<int>(snapshotMaybe.index));
+  announceActiveTab(newTabId);
 
   return newTabId;
 }
@@ -68,26 +78,54 @@ int TabBridge::createDocumentTabAndView(const std::string &title,
 // TODO(scarlet): Figure out a unified/better solution than separate 'core ->
 // cpp' signals?
 void TabBridge::notifyTabOpenedFromCore(int tabId) {
-  auto tabsSnapshot = getTabsSnapshot();
-  const neko::TabSnapshot *found = nullptr;
-  int index = 0;
-
-  for (int i = 0; i < static_cast<int>(tabsSnapshot.tabs.size()); ++i) {
-    const auto &tab = tabsSnapshot.tabs[i];
-    if (static_cast<int>(tab.id) == tabId) {
-      found = &tab;
-      index = i;
-      break;
-    }
+  const auto snapshotMaybe = tabController->get_tab_snapshot(tabId);
+
+  if (!snapshotMaybe.found) {
+    return;
   }
 
-  if (found == nullptr) {
+  emit tabOpened(fromSnapshot(snapshotMaybe.snapshot),
+                 static_cast<int>(snapshotMaybe.index));
+  announceActiveTab(tabId);
+}
+
+void TabBridge::notifyTabOpenedInBackground(int tabId) {
+  const auto snapshotMaybe = tabController->get_tab_snapshot(tabId);
+
+  if (!snapshotMaybe.found) {
     return;
   }
 
-  TabPresentation presentation = fromSnapshot(*found);
+  emit tabOpened(fromSnapshot(snapshotMaybe.snapshot),
+                 static_cast<int>(snapshotMaybe.index));
+}
+
+void TabBridge::pollTabEvents() {
+  const auto events = tabController->take_tab_events();
+
+  for (const auto &event : events) {
+    const int tabId = static_cast<int>(event.tab_id);
+
+    switch (event.kind) {
+    case neko::TabEventKindFfi::Modified:
+      emit tabModifiedChanged(tabId, event.modified);
+      break;
+    case neko::TabEventKindFfi::Title:
+      tabSaved(tabId);
+      break;
+    case neko::TabEventKindFfi::Active:
+      if (tabId != activeTabId) {
+        announceActiveTab(tabId);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
 
-  emit tabOpened(presentation, index);
+void TabBridge::announceActiveTab(int tabId) {
+  activeTabId = tabId;
   emit activeTabChanged(tabId);
 }
 
@@ -95,7 +133,16 @@ void TabBridge::fileOpened(const neko::TabSnapshot &snapshot) {
   auto presentation = fromSnapshot(snapshot);
 
   emit tabOpened(presentation, presentation.id);
-  emit activeTabChanged(presentation.id);
+  announceActiveTab(presentation.id);
+}
+
+void TabBridge::documentUpdated(uint64_t documentId) {
+  const auto snapshotMaybe =
+      tabController->get_document_tab_snapshot(documentId);
+
+  if (snapshotMaybe.found) {
+    emit tabUpdated(fromSnapshot(snapshotMaybe.snapshot));
+  }
 }
 
 void TabBridge::tabSaved(int tabId) {
@@ -120,8 +167,9 @@ bool TabBridge::closeTabs(neko::CloseTabOperationTypeFfi operationType,
   }
 
   if (result.has_active) {
-    emit activeTabChanged(static_cast<int>(result.active_id));
+    announceActiveTab(static_cast<int>(result.active_id));
   } else {
+    activeTabId = 0;
     emit allTabsClosed();
   }
 
@@ -170,22 +218,15 @@ bool TabBridge::moveTabBy(int delta, bool useHistory) {
 
   if (result.reopened) {
     TabPresentation presentation = fromSnapshot(result.snapshot);
-    auto snapshot = getTabsSnapshot();
+    const auto snapshotMaybe = tabController->get_tab_snapshot(tabId);
     offsets = presentation.scrollOffsets;
 
-    // Get the tab index
-    int index = 0;
-    for (int i = 0; i < static_cast<int>(snapshot.tabs.size()); ++i) {
-      if (static_cast<int>(snapshot.tabs[i].id) == tabId) {
-        index = i;
-        break;
-      }
-    }
-
+    const int index =
+        snapshotMaybe.found ? static_cast<int>(snapshotMaybe.index) : 0;
     emit tabOpened(presentation, index);
   }
 
-  emit activeTabChanged(tabId);
+  announceActiveTab(tabId);
 
   // Re-restore scroll offsets manually after emitting `activeTabChanged`, since
   // the handler tries to restore scroll offsets on active tab change.
@@ -208,7 +249,7 @@ bool TabBridge::moveTab(int fromIndex, int toIndex) {
 void TabBridge::setActiveTab(int tabId) {
   tabController->set_active_tab(tabId);
 
-  emit activeTabChanged(tabId);
+  announceActiveTab(tabId);
 }
 
 void TabBridge::setTabScrollOffsets(int tabId,
@@ -23,6 +23,13 @@ public:
                  bool closePinned) const;
   neko::TabsSnapshot getTabsSnapshot();
   neko::TabSnapshotMaybe getTabSnapshot(int tabId);
+  neko::TabSnapshotMaybe getDocumentTabSnapshot(uint64_t documentId);
+  /// Returns the id of the active tab, or 0 if no tabs are open.
+  [[nodiscard]] int getActiveTabId() const;
+  [[nodiscard]] bool hasActiveTab() const;
+  [[nodiscard]] int getTabCount() const;
+  /// Converts a core tab snapshot into what the tab bar shows.
+  static TabPresentation fromSnapshot(const neko::TabSnapshot &tab);
 
   // Setters
   int createDocumentTabAndView(const std::string &title, bool addTabToHistory,
@@ -36,11 +43,18 @@ public:
   void setActiveTab(int tabId);
   void setTabScrollOffsets(int tabId, const neko::ScrollOffsetFfi &newOffsets);
   void notifyTabOpenedFromCore(int tabId);
+  /// Adds a tab to the tab bar without announcing it as active, for tabs
+  /// opened as part of a batch that ends on another tab.
+  void notifyTabOpenedInBackground(int tabId);
+  /// Emits the tab changes the core recorded since the last call, such as a
+  /// tab becoming modified after an edit.
+  void pollTabEvents();
 
   // NOLINTNEXTLINE(readability-redundant-access-specifiers)
 public slots:
   void fileOpened(const neko::TabSnapshot &snapshot);
   void tabSaved(int tabId);
+  void documentUpdated(uint64_t documentId);
 
 signals:
   void tabOpened(const TabPresentation &tab, int index);
@@ -48,14 +62,18 @@ signals:
   void tabMoved(int fromIndex, int toIndex);
   void
   tabUpdated(const TabPresentation &tab); // updated title/path/pinned/modified
+  void tabModifiedChanged(int tabId, bool modified);
   void restoreScrollOffsetsForReopenedTab(const TabScrollOffsets &offsets);
   void activeTabChanged(int tabId);
   void allTabsClosed();
 
 private:
-  static TabPresentation fromSnapshot(const neko::TabSnapshot &tab);
+  void announceActiveTab(int tabId);
 
   rust::Box<neko::TabController> tabController;
+  // The tab last announced through `activeTabChanged`, so active changes the
+  // core reports are only announced once.
+  int activeTabId = 0;
 };
 
 #endif
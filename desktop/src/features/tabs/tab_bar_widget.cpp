@@ -1,25 +1,40 @@
 #include "tab_bar_widget.h"
+#include "features/context_menu/command_registry.h"
+#include "features/context_menu/context_menu_registry.h"
+#include "features/context_menu/context_menu_widget.h"
 #include "features/tabs/bridge/tab_bridge.h"
-#include "features/tabs/tab_widget.h"
 #include "utils/ui_utils.h"
+#include <QApplication>
 #include <QByteArray>
+#include <QColor>
+#include <QContextMenuEvent>
+#include <QDrag>
 #include <QDragEnterEvent>
 #include <QDragLeaveEvent>
 #include <QDragMoveEvent>
 #include <QDropEvent>
 #include <QEvent>
-#include <QFont>
 #include <QFontMetrics>
-#include <QGuiApplication>
-#include <QHBoxLayout>
-#include <QLayoutItem>
+#include <QHelpEvent>
+#include <QIcon>
 #include <QMimeData>
-#include <QPoint>
-#include <QRect>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPen>
+#include <QResizeEvent>
 #include <QScrollBar>
-#include <QString>
+#include <QSize>
+#include <QStringList>
+#include <QToolTip>
 #include <QVariant>
+#include <QWheelEvent>
 #include <algorithm>
+#include <neko-core/src/ffi/bridge.rs.h>
+
+namespace {
+constexpr auto TAB_INDEX_MIME_TYPE = "application/x-neko-tab-index";
+} // namespace
 
 TabBarWidget::TabBarWidget(const TabBarProps &props, QWidget *parent)
     : QScrollArea(parent), font(props.font), tabBarTheme(props.theme),
@@ -36,196 +51,677 @@ TabBarWidget::TabBarWidget(const TabBarProps &props, QWidget *parent)
   setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
-  setWidgetResizable(true);
   setAutoFillBackground(false);
   setFrameShape(QFrame::NoFrame);
   setAcceptDrops(true);
   viewport()->setAcceptDrops(true);
-  viewport()->installEventFilter(this);
+  viewport()->setMouseTracking(true);
 
-  containerWidget = new QWidget(this);
-  layout = new QHBoxLayout(containerWidget);
-  layout->setContentsMargins(0, 0, 0, 0);
-  layout->setSpacing(0);
-  setWidget(containerWidget);
+  // There is no scrolled child widget, so scrolling is just a repaint at the
+  // new offset.
+  connect(horizontalScrollBar(), &QScrollBar::valueChanged, viewport(),
+          qOverload<>(&QWidget::update));
 
-  dropIndicator = new QWidget(containerWidget);
-  dropIndicator->setFixedWidth(2);
-  dropIndicator->setVisible(false);
+  tabLefts.push_back(0);
   currentTabId = 0;
 
-  layout->addStretch();
-
   setAndApplyTheme(tabBarTheme);
 }
 
 void TabBarWidget::setAndApplyTheme(const TabBarTheme &newTheme) {
   tabBarTheme = newTheme;
-
-  viewport()->setStyleSheet(UiUtils::getScrollBarStylesheet(
-      tabBarTheme.scrollBarTheme.thumbColor,
-      tabBarTheme.scrollBarTheme.thumbHoverColor, "QWidget",
-      tabBarTheme.backgroundColor,
-      QString("border-bottom: 1px solid %1").arg(tabBarTheme.borderColor)));
-
-  dropIndicator->setStyleSheet(
-      QString("background-color: %1;").arg(tabBarTheme.indicatorColor));
-
   viewport()->update();
 }
 
 void TabBarWidget::setAndApplyTabTheme(const TabTheme &newTheme) {
   tabTheme = newTheme;
 
-  for (auto *tab : tabs) {
-    if (tab != nullptr) {
-      tab->setAndApplyTheme(tabTheme);
-    }
+  for (auto &pixmap : pinPixmaps) {
+    pixmap = QPixmap();
   }
+
+  viewport()->update();
 }
 
 void TabBarWidget::addTab(const TabPresentation &tab, int index) {
-  const int stretchIndex = layout->count() - 1;
+  const int tabCount = static_cast<int>(tabs.size());
 
-  if (index < 0 || index > stretchIndex) {
-    index = stretchIndex;
+  if (index < 0 || index > tabCount) {
+    index = tabCount;
   }
 
-  auto *tabWidget = new TabWidget({.title = tab.title,
-                                   .path = tab.path,
-                                   .index = index,
-                                   .tabId = tab.id,
-                                   .isPinned = tab.pinned,
-                                   .font = font,
-                                   .themeProvider = themeProvider,
-                                   .theme = tabTheme,
-                                   .contextMenuRegistry = &contextMenuRegistry,
-                                   .commandRegistry = &commandRegistry},
-                                  this);
+  tabs.insert(tabs.begin() + index,
+              Tab{.id = tab.id,
+                  .title = tab.title,
+                  .path = tab.path,
+                  .pinned = tab.pinned,
+                  .modified = tab.modified,
+                  .loading = tab.loading,
+                  .changedOnDisk = tab.changedOnDisk,
+                  .lossy = tab.lossy,
+                  .width = measureTabWidth(tab.title)});
+
+  if (tab.pinned) {
+    pinnedCount += 1;
+  }
 
-  connect(tabWidget, &TabWidget::clicked, this, [this](int tabId) {
-    setCurrentTabId(tabId);
-    emit currentChanged(tabId);
-  });
-  connect(tabWidget, &TabWidget::closeRequested, this,
-          &TabBarWidget::tabCloseRequested);
-  connect(tabWidget, &TabWidget::unpinRequested, this,
-          &TabBarWidget::tabUnpinRequested);
+  invalidateFrom(index);
+  updateScrollRange();
+  viewport()->update();
+}
 
-  layout->insertWidget(index, tabWidget);
-  tabs.insert(index, tabWidget);
+void TabBarWidget::removeTab(int tabId) {
+  const int index = indexOfTab(tabId);
+  if (index < 0) {
+    return;
+  }
 
-  for (int i = 0; i < tabs.size(); ++i) {
-    tabs[i]->setIndex(i);
+  if (tabs[index].pinned) {
+    pinnedCount -= 1;
   }
+
+  tabs.erase(tabs.begin() + index);
+  tabIndices.erase(tabId);
+
+  if (hoveredTabId == tabId) {
+    hoveredTabId = -1;
+    isCloseHovered = false;
+  }
+
+  invalidateFrom(index);
+  updateScrollRange();
+  viewport()->update();
 }
 
-void TabBarWidget::removeTab(int tabId) {
-  auto *maybeTabWidget = findTabWidgetById(tabId);
-  if (maybeTabWidget == nullptr) {
+void TabBarWidget::moveTab(int fromIndex, int toIndex) {
+  const int tabCount = static_cast<int>(tabs.size());
+
+  if (fromIndex < 0 || fromIndex >= tabCount) {
     return;
   }
 
-  const int index = static_cast<int>(tabs.indexOf(maybeTabWidget));
+  toIndex = std::max(toIndex, 0);
+  toIndex = std::min(toIndex, tabCount - 1);
+
+  if (fromIndex == toIndex) {
+    return;
+  }
+
+  // Shift the tabs in between over by one slot.
+  if (fromIndex < toIndex) {
+    std::rotate(tabs.begin() + fromIndex, tabs.begin() + fromIndex + 1,
+                tabs.begin() + toIndex + 1);
+  } else {
+    std::rotate(tabs.begin() + toIndex, tabs.begin() + fromIndex,
+                tabs.begin() + fromIndex + 1);
+  }
+
+  invalidateFrom(std::min(fromIndex, toIndex));
+  viewport()->update();
+}
+
+void TabBarWidget::updateTab(const TabPresentation &tab) {
+  const int index = indexOfTab(tab.id);
   if (index < 0) {
     return;
   }
 
-  tabs.removeAt(index);
-  layout->removeWidget(maybeTabWidget);
+  Tab &existing = tabs[index];
+
+  if (existing.pinned != tab.pinned) {
+    pinnedCount += tab.pinned ? 1 : -1;
+  }
+
+  const bool titleChanged = existing.title != tab.title;
 
-  maybeTabWidget->deleteLater();
+  existing.path = tab.path;
+  existing.pinned = tab.pinned;
+  existing.modified = tab.modified;
+  existing.loading = tab.loading;
+  existing.changedOnDisk = tab.changedOnDisk;
+  existing.lossy = tab.lossy;
 
-  for (int i = 0; i < tabs.size(); ++i) {
-    tabs[i]->setIndex(i);
+  if (titleChanged) {
+    existing.title = tab.title;
+    existing.width = measureTabWidth(tab.title);
+
+    // Only the tabs after this one move.
+    invalidateFrom(index + 1);
+    updateScrollRange();
+    viewport()->update();
+    return;
   }
+
+  updateTabAt(index);
 }
 
-void TabBarWidget::moveTab(int fromIndex, int toIndex) {
-  if (fromIndex < 0 || fromIndex >= tabs.size()) {
+void TabBarWidget::setCurrentTabId(int tabId) {
+  const int previousIndex = indexOfTab(currentTabId);
+  currentTabId = tabId;
+
+  updateTabAt(previousIndex);
+
+  const int index = indexOfTab(currentTabId);
+  updateTabAt(index);
+  ensureTabVisible(index);
+}
+
+void TabBarWidget::setTabModified(int tabId, bool modified) {
+  const int index = indexOfTab(tabId);
+
+  if (index >= 0 && tabs[index].modified != modified) {
+    tabs[index].modified = modified;
+    updateTabAt(index);
+  }
+}
+
+int TabBarWidget::getNumberOfTabs() { return static_cast<int>(tabs.size()); }
+
+int TabBarWidget::measureTabWidth(const QString &title) const {
+  QFontMetrics fontMetrics(font);
+
+  return LEFT_PADDING_PX + fontMetrics.horizontalAdvance(title) +
+         MIN_RIGHT_EXTRA_PX;
+}
+
+int TabBarWidget::tabHeight() const { return viewport()->height(); }
+
+int TabBarWidget::indexOfTab(int tabId) const {
+  const int tabCount = static_cast<int>(tabs.size());
+  const auto isCurrent = [&](const auto &entry) {
+    return entry != tabIndices.end() && entry->second < tabCount &&
+           tabs[entry->second].id == tabId;
+  };
+
+  auto entry = tabIndices.find(tabId);
+  if (isCurrent(entry)) {
+    return entry->second;
+  }
+
+  if (tabIndicesValidUntil == tabCount) {
+    return -1;
+  }
+
+  for (int i = tabIndicesValidUntil; i < tabCount; ++i) {
+    tabIndices[tabs[i].id] = i;
+  }
+  tabIndicesValidUntil = tabCount;
+
+  entry = tabIndices.find(tabId);
+  return isCurrent(entry) ? entry->second : -1;
+}
+
+int TabBarWidget::tabLeft(int index) const {
+  tabLefts.resize(tabs.size() + 1);
+
+  for (int i = tabLeftsValidUntil; i <= index; ++i) {
+    tabLefts[i] = tabLefts[i - 1] + tabs[i - 1].width;
+  }
+  tabLeftsValidUntil = std::max(tabLeftsValidUntil, index + 1);
+
+  return tabLefts[index];
+}
+
+int TabBarWidget::tabIndexAt(int xPos) const {
+  const int tabCount = static_cast<int>(tabs.size());
+
+  if (xPos < 0 || xPos >= tabLeft(tabCount)) {
+    return -1;
+  }
+
+  // Every offset is up to date once the total width has been computed.
+  const auto next = std::upper_bound(
+      tabLefts.begin(), tabLefts.begin() + tabCount + 1, xPos);
+  return static_cast<int>(next - tabLefts.begin()) - 1;
+}
+
+int TabBarWidget::tabIndexAt(const QPoint &viewportPos) const {
+  return tabIndexAt(viewportPos.x() + horizontalScrollBar()->value());
+}
+
+QRect TabBarWidget::tabRect(int index) const {
+  const int xPos = tabLeft(index) - horizontalScrollBar()->value();
+  return {xPos, 0, tabs[index].width, tabHeight()};
+}
+
+void TabBarWidget::invalidateFrom(int index) {
+  tabIndicesValidUntil = std::min(tabIndicesValidUntil, index);
+  tabLeftsValidUntil = std::min(tabLeftsValidUntil, index + 1);
+}
+
+QRect TabBarWidget::closeRect(const QRect &rect) {
+  const int yPos = rect.top() + (rect.height() - CLOSE_BUTTON_SIZE_PX) / 2;
+  const int xPos = rect.left() + rect.width() - CLOSE_BUTTON_RIGHT_INSET_PX;
+  return {xPos, yPos, CLOSE_BUTTON_SIZE_PX, CLOSE_BUTTON_SIZE_PX};
+}
+
+QRect TabBarWidget::closeHitRect(const QRect &rect) {
+  return closeRect(rect).adjusted(-CLOSE_HIT_INFLATE_PX, -CLOSE_HIT_INFLATE_PX,
+                                  CLOSE_HIT_INFLATE_PX, CLOSE_HIT_INFLATE_PX);
+}
+
+QRect TabBarWidget::titleRect(const QRect &rect) {
+  return rect.adjusted(LEFT_PADDING_PX, 0, -RIGHT_RESERVED_FOR_CONTROLS_PX, 0);
+}
+
+QRect TabBarWidget::modifiedRect(const QRect &rect) {
+  const int yPos = rect.top() + (rect.height() - MODIFIED_DOT_SIZE_PX) / 2;
+  const int xPos = rect.left() + rect.width() - MODIFIED_DOT_RIGHT_INSET_PX;
+  return {xPos, yPos, MODIFIED_DOT_SIZE_PX, MODIFIED_DOT_SIZE_PX};
+}
+
+void TabBarWidget::paintEvent(QPaintEvent *event) {
+  QPainter painter(viewport());
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setFont(font);
+
+  const QRect viewportRect = viewport()->rect();
+
+  // Bar background, visible to the right of the last tab
+  painter.fillRect(viewportRect, QColor(tabBarTheme.backgroundColor));
+  painter.setPen(QPen(QColor(tabBarTheme.borderColor)));
+  painter.drawLine(viewportRect.left(), viewportRect.bottom(),
+                   viewportRect.right(), viewportRect.bottom());
+
+  // Only the tabs overlapping the dirty region are painted.
+  const int scrollX = horizontalScrollBar()->value();
+  const QRect dirtyRect = event->rect();
+  const int tabCount = static_cast<int>(tabs.size());
+  const int firstX = scrollX + dirtyRect.left();
+
+  int index = firstX <= 0 ? 0 : tabIndexAt(firstX);
+  if (index < 0) {
+    index = tabCount;
+  }
+
+  for (; index < tabCount; ++index) {
+    const QRect rect = tabRect(index);
+    if (rect.left() > dirtyRect.right()) {
+      break;
+    }
+
+    const Tab &tab = tabs[index];
+    const bool isHovered = tab.id == hoveredTabId;
+    paintTab(painter, tab, rect, isHovered, isHovered && isCloseHovered);
+  }
+
+  // Drop indicator
+  if (dropIndex >= 0 && tabCount > 0) {
+    const int xPos = tabLeft(std::min(dropIndex, tabCount)) - scrollX;
+
+    painter.fillRect(QRect(xPos - 1, 0, DROP_INDICATOR_WIDTH_PX,
+                           viewportRect.height()),
+                     QColor(tabBarTheme.indicatorColor));
+  }
+}
+
+void TabBarWidget::paintTab(QPainter &painter, const Tab &tab,
+                            const QRect &rect, bool isHovered,
+                            bool isCloseHovered) {
+  const bool isActive = tab.id == currentTabId;
+
+  const QColor borderColor(tabTheme.borderColor);
+  const QColor foregroundColor(tabTheme.tabForegroundColor);
+  const QColor foregroundMutedColor(tabTheme.tabForegroundInactiveColor);
+
+  // Background
+  if (isActive) {
+    painter.setBrush(QColor(tabTheme.tabActiveColor));
+  } else if (isHovered) {
+    painter.setBrush(QColor(tabTheme.tabHoverColor));
+  } else {
+    painter.setBrush(QColor(tabTheme.tabInactiveColor));
+  }
+  painter.setPen(Qt::NoPen);
+  painter.drawRect(rect);
+
+  // Right border
+  painter.setPen(QPen(borderColor));
+  painter.drawLine(rect.right(), rect.top(), rect.right(), rect.bottom());
+
+  // Bottom border
+  if (!isActive) {
+    painter.drawLine(rect.left(), rect.bottom(), rect.right(), rect.bottom());
+  }
+
+  // Text
+  if (tab.changedOnDisk || tab.lossy) {
+    QFont titleFont = font;
+    titleFont.setItalic(true);
+    painter.setFont(titleFont);
+  }
+  painter.setPen(isActive ? foregroundColor : foregroundMutedColor);
+  painter.drawText(titleRect(rect), Qt::AlignLeft | Qt::AlignVCenter,
+                   tab.title);
+  painter.setFont(font);
+
+  // Loading / modified marker
+  if (tab.loading) {
+    painter.setPen(QPen(foregroundMutedColor));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawEllipse(modifiedRect(rect));
+  } else if (tab.modified) {
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(tabTheme.tabModifiedIndicatorColor));
+    painter.drawEllipse(modifiedRect(rect));
+  }
+
+  const QRect cRect = closeRect(rect);
+
+  // Close hover background
+  if (isCloseHovered) {
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(tabTheme.tabCloseButtonHoverColor));
+    painter.drawRoundedRect(closeHitRect(rect), 4, 4);
+  }
+
+  // Close button / pin glyph
+  if (tab.pinned) {
+    const QPixmap &pixmap = pinPixmap(isCloseHovered);
+
+    if (!pixmap.isNull()) {
+      painter.drawPixmap(
+          cRect.adjusted(0, PIN_ICON_NUDGE_Y_PX, 0, PIN_ICON_NUDGE_Y_PX)
+              .topLeft(),
+          pixmap);
+    }
     return;
   }
 
-  toIndex = std::max(toIndex, 0);
-  toIndex = std::min<int>(toIndex, static_cast<int>(tabs.size() - 1));
+  QPen closePen(isCloseHovered ? foregroundColor : foregroundMutedColor);
+  closePen.setWidthF(CLOSE_PEN_THICKNESS);
+  closePen.setCapStyle(Qt::RoundCap);
+
+  painter.setPen(closePen);
+  painter.drawLine(
+      cRect.topLeft() + QPoint(CLOSE_GLYPH_INSET_PX, CLOSE_GLYPH_INSET_PX),
+      cRect.bottomRight() - QPoint(CLOSE_GLYPH_INSET_PX, CLOSE_GLYPH_INSET_PX));
+  painter.drawLine(
+      cRect.topRight() + QPoint(-CLOSE_GLYPH_INSET_PX, CLOSE_GLYPH_INSET_PX),
+      cRect.bottomLeft() + QPoint(CLOSE_GLYPH_INSET_PX, -CLOSE_GLYPH_INSET_PX));
+}
 
-  if (fromIndex == toIndex) {
+const QPixmap &TabBarWidget::pinPixmap(bool isCloseHovered) {
+  QPixmap &boldPixmap = pinPixmaps[isCloseHovered ? 1 : 0];
+
+  if (!boldPixmap.isNull()) {
+    return boldPixmap;
+  }
+
+  const QIcon pinIcon = QIcon::fromTheme("pin");
+  if (pinIcon.isNull()) {
+    return boldPixmap;
+  }
+
+  const QSize iconSize(PIN_ICON_SIZE_PX, PIN_ICON_SIZE_PX);
+  const QColor iconColor(isCloseHovered
+                             ? tabTheme.tabForegroundColor
+                             : tabTheme.tabForegroundInactiveColor);
+
+  const QIcon colorizedIcon =
+      UiUtils::createColorizedIcon(pinIcon, iconColor, iconSize);
+  const QPixmap basePixmap = colorizedIcon.pixmap(iconSize);
+
+  boldPixmap = QPixmap(iconSize);
+  boldPixmap.fill(Qt::transparent);
+
+  // Thicken the glyph by drawing it offset by a pixel in each direction.
+  QPainter iconPainter(&boldPixmap);
+  iconPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+  iconPainter.drawPixmap(0, 0, basePixmap);
+  iconPainter.drawPixmap(-1, 0, basePixmap);
+  iconPainter.drawPixmap(1, 0, basePixmap);
+  iconPainter.drawPixmap(0, -1, basePixmap);
+  iconPainter.drawPixmap(0, 1, basePixmap);
+  iconPainter.end();
+
+  return boldPixmap;
+}
+
+QPixmap TabBarWidget::renderDragPixmap(int index) {
+  const qreal pixelRatio = viewport()->devicePixelRatioF();
+  const QRect rect(0, 0, tabs[index].width, tabHeight());
+
+  QPixmap pixmap(rect.size() * pixelRatio);
+  pixmap.setDevicePixelRatio(pixelRatio);
+  pixmap.fill(Qt::transparent);
+
+  QPainter painter(&pixmap);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setFont(font);
+  paintTab(painter, tabs[index], rect, true, false);
+
+  return pixmap;
+}
+
+void TabBarWidget::setHover(int tabId, bool closeHovered) {
+  if (hoveredTabId == tabId && isCloseHovered == closeHovered) {
     return;
   }
 
-  TabWidget *tabWidget = tabs.takeAt(fromIndex);
+  const int previousIndex = indexOfTab(hoveredTabId);
 
-  tabs.insert(toIndex, tabWidget);
+  hoveredTabId = tabId;
+  isCloseHovered = closeHovered;
 
-  layout->removeWidget(tabWidget);
-  layout->insertWidget(toIndex, tabWidget);
+  updateTabAt(previousIndex);
+  updateTabAt(indexOfTab(hoveredTabId));
+}
 
-  for (int i = 0; i < tabs.size(); ++i) {
-    tabs[i]->setIndex(i);
+void TabBarWidget::updateTabAt(int index) {
+  if (index >= 0 && index < static_cast<int>(tabs.size())) {
+    viewport()->update(tabRect(index));
   }
 }
 
-void TabBarWidget::updateTab(const TabPresentation &tab) {
-  auto *maybeTabWidget = findTabWidgetById(tab.id);
-  if (maybeTabWidget == nullptr) {
+void TabBarWidget::updateScrollRange() {
+  const int contentWidth = tabLeft(static_cast<int>(tabs.size()));
+  const int viewportWidth = viewport()->width();
+
+  horizontalScrollBar()->setRange(0, std::max(0, contentWidth - viewportWidth));
+  horizontalScrollBar()->setPageStep(viewportWidth);
+}
+
+void TabBarWidget::ensureTabVisible(int index) {
+  if (index < 0) {
     return;
   }
 
-  auto updateIfDifferent = [maybeTabWidget](auto getter, auto setter,
-                                            const auto &newValue) {
-    if ((maybeTabWidget->*getter)() != newValue) {
-      (maybeTabWidget->*setter)(newValue);
+  const int left = tabLeft(index);
+  const int right = left + tabs[index].width;
+  const int scrollX = horizontalScrollBar()->value();
+  const int viewportWidth = viewport()->width();
+
+  if (left < scrollX) {
+    horizontalScrollBar()->setValue(left);
+  } else if (right > scrollX + viewportWidth) {
+    horizontalScrollBar()->setValue(right - viewportWidth);
+  }
+}
+
+bool TabBarWidget::viewportEvent(QEvent *event) {
+  if (event->type() == QEvent::ToolTip) {
+    auto *helpEvent = static_cast<QHelpEvent *>(event);
+    const int index = tabIndexAt(helpEvent->pos());
+
+    QStringList notes;
+    if (index >= 0 && tabs[index].changedOnDisk) {
+      notes.append(tr("Changed on disk"));
     }
-  };
+    if (index >= 0 && tabs[index].lossy) {
+      notes.append(tr("Not valid UTF-8, invalid bytes were replaced. Save it "
+                      "under a new name to keep the original file."));
+    }
+
+    if (!notes.isEmpty()) {
+      QToolTip::showText(helpEvent->globalPos(), notes.join('\n'), viewport(),
+                         tabRect(index));
+    } else {
+      QToolTip::hideText();
+      event->ignore();
+    }
+
+    return true;
+  }
 
-  updateIfDifferent(&TabWidget::getIsModified, &TabWidget::setModified,
-                    tab.modified);
-  updateIfDifferent(&TabWidget::getIsPinned, &TabWidget::setIsPinned,
-                    tab.pinned);
-  updateIfDifferent(&TabWidget::getPath, &TabWidget::setPath, tab.path);
-  updateIfDifferent(&TabWidget::getTitle, &TabWidget::setTitle, tab.title);
+  return QScrollArea::viewportEvent(event);
 }
 
-void TabBarWidget::setCurrentTabId(int tabId) {
-  currentTabId = tabId;
+void TabBarWidget::resizeEvent(QResizeEvent *event) {
+  QScrollArea::resizeEvent(event);
+  updateScrollRange();
+}
+
+void TabBarWidget::wheelEvent(QWheelEvent *event) {
+  // The strip only scrolls sideways, so vertical wheels scroll it too.
+  const QPoint angleDelta = event->angleDelta();
+  const int delta = angleDelta.x() != 0 ? angleDelta.x() : angleDelta.y();
+  const int direction = event->isInverted() ? -1 : 1;
+
+  horizontalScrollBar()->setValue(horizontalScrollBar()->value() -
+                                  (direction * delta / SCROLL_WHEEL_DIVIDER));
+  event->accept();
+}
+
+void TabBarWidget::mousePressEvent(QMouseEvent *event) {
+  const auto modifiers = event->modifiers();
+  const bool shiftHeld = modifiers.testFlag(Qt::ShiftModifier);
+  const QPoint pos = event->position().toPoint();
+  const int index = tabIndexAt(pos);
+
+  dragEligible = false;
+  middleClickPending = false;
+  pressedTabId = index >= 0 ? tabs[index].id : -1;
+
+  if (index < 0) {
+    QScrollArea::mousePressEvent(event);
+    return;
+  }
+
+  const Tab &tab = tabs[index];
 
-  for (auto *tab : tabs) {
-    if (tab == nullptr) {
-      continue;
+  if (event->button() == Qt::LeftButton) {
+    if (closeHitRect(tabRect(index)).contains(pos)) {
+      if (tab.pinned) {
+        emit tabUnpinRequested(tab.id);
+      } else {
+        emit tabCloseRequested(neko::CloseTabOperationTypeFfi::Single, tab.id,
+                               shiftHeld);
+      }
+      event->accept();
+      return;
     }
 
-    tab->setActive(tab->getId() == currentTabId);
+    dragStartPosition = pos;
+    dragEligible = true;
+    event->accept();
+    return;
   }
+
+  if (event->button() == Qt::MiddleButton) {
+    middleClickPending = true;
+    event->accept();
+    return;
+  }
+
+  QScrollArea::mousePressEvent(event);
 }
 
-TabWidget *TabBarWidget::findTabWidgetById(int tabId) {
-  auto foundTabWidget =
-      std::find_if(tabs.begin(), tabs.end(), [&](TabWidget *tabWidget) {
-        return tabWidget && tabWidget->getId() == tabId;
-      });
+void TabBarWidget::mouseMoveEvent(QMouseEvent *event) {
+  const QPoint pos = event->position().toPoint();
+
+  if (((event->buttons() & Qt::LeftButton) != 0U) && dragEligible) {
+    const int dragDistance = (pos - dragStartPosition).manhattanLength();
+    const int pressedIndex = indexOfTab(pressedTabId);
+
+    if (dragDistance >= QApplication::startDragDistance() &&
+        pressedIndex >= 0) {
+      dragEligible = false;
+
+      auto *drag = new QDrag(this);
+      auto *mimeData = new QMimeData();
+      mimeData->setData(TAB_INDEX_MIME_TYPE, QByteArray::number(pressedIndex));
+      drag->setMimeData(mimeData);
+      drag->setPixmap(renderDragPixmap(pressedIndex));
+      drag->setHotSpot(dragStartPosition - tabRect(pressedIndex).topLeft());
+      drag->exec(Qt::MoveAction);
+      return;
+    }
+  }
 
-  if (foundTabWidget != tabs.end() && (*foundTabWidget != nullptr)) {
-    return *foundTabWidget;
+  const int index = tabIndexAt(pos);
+  if (index < 0) {
+    setHover(-1, false);
+    return;
   }
 
-  return nullptr;
+  setHover(tabs[index].id, closeHitRect(tabRect(index)).contains(pos));
 }
 
-void TabBarWidget::setTabModified(int tabId, bool modified) {
-  auto foundTabWidget =
-      std::find_if(tabs.begin(), tabs.end(), [&](TabWidget *tabWidget) {
-        return tabWidget && tabWidget->getId() == tabId;
-      });
+void TabBarWidget::mouseReleaseEvent(QMouseEvent *event) {
+  const auto modifiers = event->modifiers();
+  const bool shiftPressed = modifiers.testFlag(Qt::ShiftModifier);
+  const int index = tabIndexAt(event->position().toPoint());
+  const bool releasedOnPressedTab =
+      index >= 0 && tabs[index].id == pressedTabId;
+
+  if (event->button() == Qt::LeftButton && dragEligible &&
+      releasedOnPressedTab) {
+    setCurrentTabId(pressedTabId);
+    emit currentChanged(pressedTabId);
+    event->accept();
+  } else if (event->button() == Qt::MiddleButton) {
+    if (middleClickPending && releasedOnPressedTab && !tabs[index].pinned) {
+      emit tabCloseRequested(neko::CloseTabOperationTypeFfi::Single,
+                             pressedTabId, shiftPressed);
+    }
 
-  if (foundTabWidget != tabs.end() && (*foundTabWidget != nullptr)) {
-    (*foundTabWidget)->setModified(modified);
+    event->accept();
   }
+
+  dragEligible = false;
+  middleClickPending = false;
+  pressedTabId = -1;
+
+  QScrollArea::mouseReleaseEvent(event);
 }
 
-int TabBarWidget::getNumberOfTabs() { return static_cast<int>(tabs.size()); }
+void TabBarWidget::leaveEvent(QEvent *event) {
+  QScrollArea::leaveEvent(event);
+  setHover(-1, false);
+}
+
+void TabBarWidget::contextMenuEvent(QContextMenuEvent *event) {
+  const int index = tabIndexAt(event->pos());
+  if (index < 0) {
+    event->ignore();
+    return;
+  }
+
+  const Tab &tab = tabs[index];
+
+  // TODO(scarlet): Change from neko:: type
+  neko::TabContextFfi ctx{static_cast<uint64_t>(tab.id), tab.pinned,
+                          tab.modified, !tab.path.isEmpty(),
+                          tab.path.toStdString()};
+  const QVariant variant = QVariant::fromValue(ctx);
+  const auto items = contextMenuRegistry.build("tab", variant);
+
+  auto *menu = new ContextMenuWidget(
+      {.themeProvider = themeProvider, .font = font}, nullptr);
+  menu->setItems(items);
+
+  connect(menu, &ContextMenuWidget::actionTriggered, this,
+          [this, variant](const QString &actionId) {
+            commandRegistry.run(actionId, variant);
+          });
+
+  menu->showMenu(event->globalPos());
+  event->accept();
+}
 
 void TabBarWidget::dragEnterEvent(QDragEnterEvent *event) {
-  if (event->mimeData()->hasFormat("application/x-neko-tab-index")) {
+  if (event->mimeData()->hasFormat(TAB_INDEX_MIME_TYPE)) {
     event->setDropAction(Qt::MoveAction);
     event->accept();
   } else {
@@ -234,77 +730,51 @@ void TabBarWidget::dragEnterEvent(QDragEnterEvent *event) {
 }
 
 void TabBarWidget::dragMoveEvent(QDragMoveEvent *event) {
-  if (event->mimeData()->hasFormat("application/x-neko-tab-index")) {
-    event->setDropAction(Qt::MoveAction);
-    event->accept();
-    const QPoint viewportPos = event->position().toPoint();
-    const QPoint containerPos =
-        containerWidget->mapFrom(viewport(), viewportPos);
-    int toIndex = dropIndexForPosition(containerPos);
-
-    int pinnedCount = 0;
-    for (auto *tab : tabs) {
-      if ((tab != nullptr) && tab->getIsPinned()) {
-        pinnedCount += 1;
-      }
-    }
+  if (!event->mimeData()->hasFormat(TAB_INDEX_MIME_TYPE)) {
+    event->ignore();
+    return;
+  }
 
-    bool success = false;
-    const int fromIndex =
-        event->mimeData()->data("application/x-neko-tab-index").toInt(&success);
-    if (success && fromIndex >= 0 && fromIndex < tabs.size()) {
-      const bool draggingPinned = tabs[fromIndex]->getIsPinned();
-      if (draggingPinned) {
-        toIndex = std::min(toIndex, pinnedCount);
-      } else {
-        toIndex = std::max(toIndex, pinnedCount);
-      }
-    }
+  event->setDropAction(Qt::MoveAction);
+  event->accept();
 
-    updateDropIndicator(toIndex);
-  } else {
-    event->ignore();
+  bool success = false;
+  const int fromIndex =
+      event->mimeData()->data(TAB_INDEX_MIME_TYPE).toInt(&success);
+  int toIndex = dropIndexForPosition(event->position().toPoint());
+
+  if (success) {
+    toIndex = constrainDropIndex(toIndex, fromIndex);
   }
+
+  updateDropIndicator(toIndex);
 }
 
 void TabBarWidget::dragLeaveEvent(QDragLeaveEvent *event) {
-  dropIndicator->setVisible(false);
+  updateDropIndicator(-1);
   QScrollArea::dragLeaveEvent(event);
 }
 
 void TabBarWidget::dropEvent(QDropEvent *event) {
-  if (!event->mimeData()->hasFormat("application/x-neko-tab-index")) {
+  updateDropIndicator(-1);
+
+  if (!event->mimeData()->hasFormat(TAB_INDEX_MIME_TYPE)) {
     event->ignore();
     return;
   }
 
-  const QByteArray data =
-      event->mimeData()->data("application/x-neko-tab-index");
+  const QByteArray data = event->mimeData()->data(TAB_INDEX_MIME_TYPE);
   bool success = false;
   const int fromIndex = data.toInt(&success);
+  const int tabCount = static_cast<int>(tabs.size());
 
-  if (!success || fromIndex < 0 || fromIndex >= tabs.size()) {
+  if (!success || fromIndex < 0 || fromIndex >= tabCount) {
     event->ignore();
     return;
   }
 
-  const QPoint viewportPos = event->position().toPoint();
-  const QPoint containerPos = containerWidget->mapFrom(viewport(), viewportPos);
-  int slotIndex = dropIndexForPosition(containerPos);
-
-  int pinnedCount = 0;
-  for (auto *tab : tabs) {
-    if ((tab != nullptr) && tab->getIsPinned()) {
-      ++pinnedCount;
-    }
-  }
-
-  const bool draggingPinned = tabs[fromIndex]->getIsPinned();
-  if (draggingPinned) {
-    slotIndex = std::min(slotIndex, pinnedCount);
-  } else {
-    slotIndex = std::max(slotIndex, pinnedCount);
-  }
+  const int slotIndex = constrainDropIndex(
+      dropIndexForPosition(event->position().toPoint()), fromIndex);
 
   int toIndex = slotIndex;
   if (fromIndex < slotIndex) {
@@ -312,72 +782,48 @@ void TabBarWidget::dropEvent(QDropEvent *event) {
   }
 
   toIndex = std::max(toIndex, 0);
-  toIndex = std::min(toIndex, static_cast<int>(tabs.size()) - 1);
+  toIndex = std::min(toIndex, tabCount - 1);
 
   if (fromIndex == toIndex) {
-    dropIndicator->setVisible(false);
     event->ignore();
     return;
   }
 
   tabBridge->moveTab(fromIndex, toIndex);
-  dropIndicator->setVisible(false);
   event->setDropAction(Qt::MoveAction);
   event->accept();
 }
 
-bool TabBarWidget::eventFilter(QObject *watched, QEvent *event) {
-  if (watched == viewport()) {
-    if (event->type() == QEvent::DragEnter) {
-      dragEnterEvent(static_cast<QDragEnterEvent *>(event));
-      return event->isAccepted();
-    }
-    if (event->type() == QEvent::DragMove) {
-      dragMoveEvent(static_cast<QDragMoveEvent *>(event));
-      return event->isAccepted();
-    }
-    if (event->type() == QEvent::DragLeave) {
-      dragLeaveEvent(static_cast<QDragLeaveEvent *>(event));
-      return event->isAccepted();
-    }
-    if (event->type() == QEvent::Drop) {
-      dropEvent(static_cast<QDropEvent *>(event));
-      return event->isAccepted();
-    }
+int TabBarWidget::dropIndexForPosition(const QPoint &pos) const {
+  const int xPos = pos.x() + horizontalScrollBar()->value();
+  const int index = tabIndexAt(xPos);
+
+  if (index < 0) {
+    return xPos < 0 ? 0 : static_cast<int>(tabs.size());
   }
 
-  return QScrollArea::eventFilter(watched, event);
+  const int center = tabLeft(index) + (tabs[index].width / 2);
+  return xPos < center ? index : index + 1;
 }
 
-int TabBarWidget::dropIndexForPosition(const QPoint &pos) const {
-  for (int i = 0; i < tabs.size(); i++) {
-    const QRect tabRect = tabs[i]->geometry();
+int TabBarWidget::constrainDropIndex(int slotIndex, int fromIndex) const {
+  if (fromIndex < 0 || fromIndex >= static_cast<int>(tabs.size())) {
+    return slotIndex;
+  }
 
-    if (pos.x() < tabRect.center().x()) {
-      return i;
-    }
+  // Pinned tabs stay in front of unpinned ones.
+  if (tabs[fromIndex].pinned) {
+    return std::min(slotIndex, pinnedCount);
   }
 
-  return static_cast<int>(tabs.size());
+  return std::max(slotIndex, pinnedCount);
 }
 
 void TabBarWidget::updateDropIndicator(int index) {
-  if (tabs.isEmpty()) {
-    dropIndicator->setVisible(false);
+  if (dropIndex == index) {
     return;
   }
 
-  int xPos = 0;
-  int height = containerWidget->height();
-  if (index <= 0) {
-    xPos = tabs.first()->geometry().left();
-  } else if (index >= tabs.size()) {
-    xPos = tabs.last()->geometry().right() + 1;
-  } else {
-    xPos = tabs[index]->geometry().left();
-  }
-
-  dropIndicator->setGeometry(xPos - 1, 0, 2, height);
-  dropIndicator->setVisible(true);
-  dropIndicator->raise();
+  dropIndex = index;
+  viewport()->update();
 }
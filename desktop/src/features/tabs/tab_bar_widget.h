@@ -4,19 +4,33 @@
 class CommandRegistry;
 class ContextMenuRegistry;
 class TabBridge;
-class TabWidget;
 class ThemeProvider;
 
 #include "features/tabs/types/types.h"
 #include "theme/types/types.h"
 #include "types/ffi_types_fwd.h"
 #include "types/qt_types_fwd.h"
+#include <QFont>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
 #include <QScrollArea>
-#include <QStringList>
+#include <QString>
+#include <unordered_map>
+#include <vector>
 
-QT_FWD(QPushButton, QHBoxLayout, QDragEnterEvent, QDragMoveEvent,
-       QDragLeaveEvent, QDropEvent, QEvent, QPoint);
+QT_FWD(QPainter, QPaintEvent, QMouseEvent, QWheelEvent, QResizeEvent,
+       QContextMenuEvent, QDragEnterEvent, QDragMoveEvent, QDragLeaveEvent,
+       QDropEvent, QEvent);
 
+/// \class TabBarWidget
+/// \brief Paints the open tabs as a single horizontally scrolling strip.
+///
+/// Tabs are plain entries in a model rather than child widgets, so only the
+/// tabs inside the viewport are painted and hit-tested. Tab offsets and the
+/// id-to-index map are rebuilt lazily from the first tab an operation moved,
+/// which keeps adding, removing, moving and updating tabs cheap even with
+/// hundreds of them open.
 class TabBarWidget : public QScrollArea {
   Q_OBJECT
 
@@ -56,33 +70,130 @@ signals:
   void tabUnpinRequested(int tabId);
 
 protected:
+  bool viewportEvent(QEvent *event) override;
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void wheelEvent(QWheelEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+  void mouseMoveEvent(QMouseEvent *event) override;
+  void mouseReleaseEvent(QMouseEvent *event) override;
+  void leaveEvent(QEvent *event) override;
+  void contextMenuEvent(QContextMenuEvent *event) override;
   void dragEnterEvent(QDragEnterEvent *event) override;
   void dragMoveEvent(QDragMoveEvent *event) override;
   void dragLeaveEvent(QDragLeaveEvent *event) override;
   void dropEvent(QDropEvent *event) override;
-  bool eventFilter(QObject *watched, QEvent *event) override;
 
 private:
+  struct Tab {
+    int id;
+    QString title;
+    QString path;
+    bool pinned;
+    bool modified;
+    bool loading;
+    // The file was changed outside the editor; the title is drawn in italics.
+    bool changedOnDisk;
+    // The file is not valid UTF-8 and can only be saved under a new name; the
+    // title is drawn in italics too.
+    bool lossy;
+    // Measured when the title changes, so layout never touches font metrics.
+    int width;
+  };
+
+  [[nodiscard]] int measureTabWidth(const QString &title) const;
+  [[nodiscard]] int tabHeight() const;
+
+  /// Returns the index of the tab with `tabId`, or -1.
+  [[nodiscard]] int indexOfTab(int tabId) const;
+  /// Returns the left edge of the tab at `index` in content coordinates. An
+  /// index one past the last tab gives the total width.
+  [[nodiscard]] int tabLeft(int index) const;
+  /// Returns the index of the tab under content x position `xPos`, or -1.
+  [[nodiscard]] int tabIndexAt(int xPos) const;
+  [[nodiscard]] int tabIndexAt(const QPoint &viewportPos) const;
+  [[nodiscard]] QRect tabRect(int index) const;
+  void invalidateFrom(int index);
+
+  [[nodiscard]] static QRect closeRect(const QRect &rect);
+  [[nodiscard]] static QRect closeHitRect(const QRect &rect);
+  [[nodiscard]] static QRect titleRect(const QRect &rect);
+  [[nodiscard]] static QRect modifiedRect(const QRect &rect);
+
+  void paintTab(QPainter &painter, const Tab &tab, const QRect &rect,
+                bool isHovered, bool isCloseHovered);
+  const QPixmap &pinPixmap(bool isCloseHovered);
+  [[nodiscard]] QPixmap renderDragPixmap(int index);
+
+  void setHover(int tabId, bool isCloseHovered);
+  void updateTabAt(int index);
+  void updateScrollRange();
+  void ensureTabVisible(int index);
+
   [[nodiscard]] int dropIndexForPosition(const QPoint &pos) const;
+  [[nodiscard]] int constrainDropIndex(int slotIndex, int fromIndex) const;
   void updateDropIndicator(int index);
-  TabWidget *findTabWidgetById(int tabId);
 
   ThemeProvider *themeProvider;
   TabBridge *tabBridge;
   ContextMenuRegistry &contextMenuRegistry;
   CommandRegistry &commandRegistry;
-  QWidget *containerWidget;
-  QWidget *dropIndicator;
-  QHBoxLayout *layout;
-  QList<TabWidget *> tabs;
+  std::vector<Tab> tabs;
+  // Pinned tabs always come first, so this is also the first unpinned index.
+  int pinnedCount = 0;
   int currentTabId;
 
+  // Left edge of every tab, valid below `tabLeftsValidUntil`. Entries past it
+  // are recomputed from their predecessors when first needed.
+  mutable std::vector<int> tabLefts;
+  mutable int tabLeftsValidUntil = 1;
+  // Maps tab ids to indices. Entries are checked against `tabs` on lookup,
+  // and a miss renumbers the tabs from `tabIndicesValidUntil` onwards.
+  mutable std::unordered_map<int, int> tabIndices;
+  mutable int tabIndicesValidUntil = 0;
+
+  int hoveredTabId = -1;
+  bool isCloseHovered = false;
+  int pressedTabId = -1;
+  bool dragEligible = false;
+  bool middleClickPending = false;
+  QPoint dragStartPosition;
+  int dropIndex = -1;
+
+  // Pin glyphs for the normal and hovered close button, built on first use.
+  QPixmap pinPixmaps[2];
+
   QFont font;
   TabBarTheme tabBarTheme;
   TabTheme tabTheme;
 
   static double constexpr TOP_PADDING = 8.0;
   static double constexpr BOTTOM_PADDING = 8.0;
+  static constexpr int SCROLL_WHEEL_DIVIDER = 4;
+  static constexpr int DROP_INDICATOR_WIDTH_PX = 2;
+
+  static constexpr int LEFT_PADDING_PX = 12;
+
+  static constexpr int CLOSE_BUTTON_SIZE_PX = 12;
+  static constexpr int CLOSE_BUTTON_RIGHT_INSET_PX = 24;
+  static constexpr int CLOSE_HIT_INFLATE_PX = 3;
+
+  // How much horizontal room on the right to reserve so text doesn't overlap
+  static constexpr int RIGHT_RESERVED_FOR_CONTROLS_PX = 30;
+  static constexpr int MIN_RIGHT_EXTRA_PX = 44;
+
+  // Modified dot (drawn hollow while the file is still loading)
+  static constexpr int MODIFIED_DOT_SIZE_PX = 6;
+  static constexpr int MODIFIED_DOT_RIGHT_INSET_PX = 37;
+
+  // Close "X" padding inside the close rect
+  static constexpr int CLOSE_GLYPH_INSET_PX = 2;
+
+  // Pin icon rendering
+  static constexpr int PIN_ICON_SIZE_PX = 12;
+  static constexpr int PIN_ICON_NUDGE_Y_PX = 1;
+
+  static constexpr double CLOSE_PEN_THICKNESS = 1.5;
 };
 
 #endif // TAB_BAR_WIDGET_H
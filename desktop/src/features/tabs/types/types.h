@@ -4,16 +4,19 @@
 #include <QString>
 
 struct TabScrollOffsets {
-  double x;
-  double y;
+  double x = 0;
+  double y = 0;
 };
 
 struct TabPresentation {
-  int id;
+  int id = 0;
   QString title;
   QString path;
-  bool pinned;
-  bool modified;
+  bool pinned = false;
+  bool modified = false;
+  bool loading = false;
+  bool changedOnDisk = false;
+  bool lossy = false;
   TabScrollOffsets scrollOffsets;
 };
 